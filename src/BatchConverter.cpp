@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Batch conversion of disk images to another container format
+
+#include "BatchConverter.h"
+#include "ImageUtils.h"
+#include "stringutils.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+
+BatchConverter::BatchConverter(const QJsonObject & file_formats, const QJsonObject & file_types, QObject *parent)
+    : BatchRunner(parent)
+    , m_file_formats(file_formats)
+    , m_file_types(file_types)
+{}
+
+BatchConverter::~BatchConverter()
+{
+    stop();
+}
+
+bool BatchConverter::beforeStart(QString & error)
+{
+    if (m_options.output_dir.isEmpty() || !QDir().mkpath(m_options.output_dir)) {
+        error = tr("Cannot create output directory '%1'").arg(m_options.output_dir);
+        return false;
+    }
+
+    m_target_ext = ImageUtils::formatExtension(m_file_formats, m_options.target_id);
+    if (m_target_ext.isEmpty()) {
+        error = tr("Configuration error!");
+        return false;
+    }
+
+    // Substitution is only supported for raw images, see ConvertDialog::set_controls()
+    if (m_options.target_id != "FILE_RAW_MSB") m_options.numtracks = 0;
+
+    // The template is read and validated once, then shared read-only by all workers
+    m_template.reset();
+    if (m_options.numtracks > 0) {
+        const dsk_tools::Result result = TrackTemplate::load(
+            _toStdString(m_options.template_file),
+            m_options.target_id.toStdString(),
+            m_template
+        );
+        if (!result) {
+            if (result.code == dsk_tools::ErrorCode::WriteIncorrectTemplate)
+                error = tr("The selected template cannot be used - it must be the same type and size as the target.");
+            else
+                error = tr("Error reading template file");
+            return false;
+        }
+    }
+
+    // Outputs are fixed before any worker runs: images with the same base name would otherwise
+    // be written to one file by two workers at once, and a source could be overwritten while
+    // another worker still reads it
+    m_outputs.clear();
+    std::set<QString> sources;
+    foreach (const QString & item, items()) sources.insert(ImageUtils::pathKey(item));
+    std::map<QString, int> outputs;     // path key -> item
+    for (int i = 0; i < items().size(); i++) {
+        const QString output = outputFileName(items().at(i));
+        const QString key = ImageUtils::pathKey(output);
+        if (sources.count(key)) {
+            error = tr("'%1' would overwrite a source image, choose another output directory or format")
+                        .arg(QDir::toNativeSeparators(output));
+            return false;
+        }
+        const auto it = outputs.find(key);
+        if (it != outputs.end()) {
+            error = tr("'%1' and '%2' would both be written to '%3'").arg(
+                QDir::toNativeSeparators(items().at(it->second)),
+                QDir::toNativeSeparators(items().at(i)),
+                QDir::toNativeSeparators(output)
+            );
+            return false;
+        }
+        outputs[key] = i;
+        m_outputs.append(output);
+    }
+
+    // Workers must not touch QJsonObject, so the type->targets table is flattened here
+    m_targets.clear();
+    foreach (const QString & type_id, m_file_types.keys()) {
+        std::set<std::string> & targets = m_targets[type_id.toStdString()];
+        foreach (const QJsonValue & target, m_file_types[type_id].toObject()["targets"].toArray()) {
+            targets.insert(target.toString().toStdString());
+        }
+    }
+
+    return true;
+}
+
+void BatchConverter::afterFinish()
+{
+    m_template.reset();
+    m_outputs.clear();
+}
+
+QString BatchConverter::outputFileName(const QString & source) const
+{
+    const QFileInfo fi(source);
+    QString dir = m_options.output_dir;
+    if (m_options.keep_structure && !m_options.source_root.isEmpty()) {
+        const QString relative = QDir(m_options.source_root).relativeFilePath(fi.absolutePath());
+        if (relative != "." && !relative.startsWith("..")) dir += "/" + relative;
+    }
+    return QString("%1/%2.%3").arg(dir, fi.completeBaseName(), m_target_ext);
+}
+
+dsk_tools::Result BatchConverter::processItem(int index, const QString & item, QString & message)
+{
+    const QString & output_file = m_outputs.at(index);
+    if (!m_options.overwrite && QFileInfo(output_file).exists()) {
+        message = tr("Skipped, '%1' already exists").arg(QDir::toNativeSeparators(output_file));
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::FileAlreadyExists, _toStdString(output_file));
+    }
+
+    LoadedImage loaded;
+    dsk_tools::Result result = ImageUtils::detectImage(_toStdString(item), loaded);
+    if (!result) return result;
+
+    // Incompatible images are rejected by their detected type, before anything is loaded
+    if (m_template && !m_template->isCompatible(loaded.type_id)) {
+        message = tr("Template type '%1' does not match image type '%2'").arg(
+            QString::fromStdString(m_template->typeId()),
+            QString::fromStdString(loaded.type_id)
+        );
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteIncorrectTemplate, loaded.type_id);
+    }
+
+    result = ImageUtils::loadImage(loaded, false);
+    if (!result) return result;
+
+    const auto targets = m_targets.find(loaded.type_id);
+    if (targets == m_targets.end() || targets->second.count(m_options.target_id.toStdString()) == 0) {
+        message = tr("Type '%1' cannot be saved in this format").arg(QString::fromStdString(loaded.type_id));
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, loaded.type_id);
+    }
+
+    uint8_t volume_id = m_options.volume_id;
+    if (m_options.volume_policy == VolumeIdPolicy::FromFileSystem) {
+        // The file system is only needed for its volume ID, so failing to open it is not an error
+        if (ImageUtils::openFileSystem(loaded)) {
+            const int fs_volume_id = loaded.filesystem->get_volume_id();
+            if (fs_volume_id > 0) volume_id = static_cast<uint8_t>(fs_volume_id);
+        }
+    }
+
+    const auto writer = ImageUtils::createWriter(m_options.target_id, loaded.image.get(), volume_id);
+    if (!writer) return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, m_options.target_id.toStdString());
+
+    dsk_tools::BYTES buffer;
+    result = writer->write(buffer);
+    if (!result) return result;
+
+    if (m_template) {
+        result = m_template->apply(*writer, buffer, m_options.numtracks);
+        if (!result) {
+            // The template itself is rejected, every other image would fail the same way after
+            // being loaded and converted, so the batch stops here
+            if (result.code == dsk_tools::ErrorCode::WriteIncorrectTemplate) {
+                cancel();
+                message = tr("The selected template cannot be used - it must be the same type and size as the target. The batch is stopped.");
+            }
+            return result;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(output_file).absolutePath());
+    result = ImageUtils::writeFile(_toStdString(output_file), buffer);
+    if (!result) return result;
+
+    message = QDir::toNativeSeparators(output_file);
+    if (m_options.target_id != "FILE_RAW_MSB")
+        message += QString(" (Volume ID $%1)").arg(QString::fromStdString(dsk_tools::int_to_hex(volume_id)));
+    return dsk_tools::Result::ok();
+}
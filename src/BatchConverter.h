@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Batch conversion of disk images to another container format
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <QJsonObject>
+
+#include "BatchRunner.h"
+#include "TrackTemplate.h"
+
+enum class VolumeIdPolicy {
+    FromFileSystem,     // Use the volume ID of the source file system, the fixed value if unknown
+    Fixed               // Always use the fixed value
+};
+
+struct BatchConvertOptions {
+    QString source_root;
+    QString output_dir;
+    QString target_id;
+    bool keep_structure {true};
+    bool overwrite {false};
+    int numtracks {0};              // Boot tracks to take from the template, 0 = no substitution
+    QString template_file;
+    VolumeIdPolicy volume_policy {VolumeIdPolicy::FromFileSystem};
+    uint8_t volume_id {0xFE};
+};
+
+class BatchConverter : public BatchRunner
+{
+    Q_OBJECT
+
+public:
+    BatchConverter(const QJsonObject & file_formats, const QJsonObject & file_types, QObject *parent = nullptr);
+    ~BatchConverter() override;
+
+    void setOptions(const BatchConvertOptions & options) { m_options = options; }
+    const BatchConvertOptions & options() const { return m_options; }
+
+protected:
+    dsk_tools::Result processItem(int index, const QString & item, QString & message) override;
+    bool beforeStart(QString & error) override;
+    void afterFinish() override;
+
+private:
+    const QJsonObject & m_file_formats;
+    const QJsonObject & m_file_types;
+
+    // Snapshot of everything workers need, taken in beforeStart() and read-only afterwards
+    BatchConvertOptions m_options;
+    std::map<std::string, std::set<std::string>> m_targets;     // type_id -> allowed targets
+    QString m_target_ext;
+    std::shared_ptr<const TrackTemplate> m_template;
+    QStringList m_outputs;      // One per item
+
+    QString outputFileName(const QString & source) const;
+};
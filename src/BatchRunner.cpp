@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Runs a per-image operation over a list of files on a bounded thread pool
+
+#include "BatchRunner.h"
+#include "ErrorText.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QCoreApplication>
+
+// ============================================================================
+//  BatchTask
+// ============================================================================
+
+class BatchTask : public QRunnable
+{
+public:
+    BatchTask(BatchRunner * runner, int index)
+        : m_runner(runner)
+        , m_index(index)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_runner->runItem(m_index);
+    }
+
+private:
+    BatchRunner * m_runner;
+    int m_index;
+};
+
+// ============================================================================
+//  BatchRunner
+// ============================================================================
+
+BatchRunner::BatchRunner(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+BatchRunner::~BatchRunner()
+{
+    stop();
+}
+
+void BatchRunner::setMaxThreads(int count)
+{
+    m_pool.setMaxThreadCount(count > 0 ? count : QThread::idealThreadCount());
+}
+
+int BatchRunner::maxThreads() const
+{
+    return m_pool.maxThreadCount();
+}
+
+bool BatchRunner::start(const QStringList & items)
+{
+    m_error.clear();
+    if (m_running) {
+        m_error = QCoreApplication::translate("FilePanel", "Another batch operation is already running");
+        return false;
+    }
+
+    m_items = items;
+    m_cancelled.storeRelease(0);
+    m_done = 0;
+    m_succeeded = 0;
+    m_failed = 0;
+
+    if (!beforeStart(m_error)) return false;
+
+    m_running = true;
+    m_timer.start();
+    emit progress(0, m_items.size());
+
+    if (m_items.isEmpty()) {
+        m_running = false;
+        afterFinish();
+        emit finished(0, 0, m_timer.elapsed());
+        return true;
+    }
+
+    for (int i = 0; i < m_items.size(); i++) {
+        m_pool.start(new BatchTask(this, i));
+    }
+    return true;
+}
+
+void BatchRunner::cancel()
+{
+    m_cancelled.storeRelease(1);
+}
+
+void BatchRunner::stop()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void BatchRunner::wait()
+{
+    m_pool.waitForDone();
+    QCoreApplication::sendPostedEvents(this);
+}
+
+void BatchRunner::runItem(int index)
+{
+    bool ok = false;
+    QString message;
+
+    if (isCancelled()) {
+        message = QCoreApplication::translate("FilePanel", "Cancelled");
+    } else {
+        const dsk_tools::Result result = processItem(index, m_items.at(index), message);
+        ok = static_cast<bool>(result);
+        if (!ok && message.isEmpty()) message = ErrorText::decode(result);
+    }
+
+    // Results are collected on the owner's thread
+    QMetaObject::invokeMethod(this, "onItemDone", Qt::QueuedConnection,
+                              Q_ARG(int, index),
+                              Q_ARG(bool, ok),
+                              Q_ARG(QString, message));
+}
+
+void BatchRunner::onItemDone(int index, bool ok, const QString & message)
+{
+    m_done++;
+    if (ok) m_succeeded++; else m_failed++;
+
+    emit itemFinished(index, m_items.at(index), ok, message);
+    emit progress(m_done, m_items.size());
+
+    if (m_done == m_items.size()) {
+        m_running = false;
+        afterFinish();
+        emit finished(m_succeeded, m_failed, m_timer.elapsed());
+    }
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Runs a per-image operation over a list of files on a bounded thread pool
+
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+
+#include "dsk_tools/dsk_tools.h"
+
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BatchRunner(QObject *parent = nullptr);
+    ~BatchRunner() override;
+
+    void setMaxThreads(int count);
+    int maxThreads() const;
+
+    // Queues all items; returns false if a batch is already running or beforeStart() failed
+    bool start(const QStringList & items);
+    QString errorString() const { return m_error; }
+    void cancel();
+    void wait();
+
+    bool isRunning() const { return m_running; }
+    bool isCancelled() const { return m_cancelled.loadAcquire() != 0; }
+    const QStringList & items() const { return m_items; }
+
+signals:
+    void itemFinished(int index, const QString & item, bool ok, const QString & message);
+    void progress(int done, int total);
+    void finished(int succeeded, int failed, qint64 elapsed_ms);
+
+protected:
+    // Called on a worker thread, one call per item. Must not touch widgets or
+    // any state shared between items unless it is immutable for the whole batch.
+    virtual dsk_tools::Result processItem(int index, const QString & item, QString & message) = 0;
+
+    // Called on the owner's thread right before the first item is queued / after the last one is done
+    virtual bool beforeStart(QString & error) { Q_UNUSED(error); return true; }
+    virtual void afterFinish() {}
+
+    // Cancels the batch and waits for the workers. Subclasses call it from their destructors,
+    // before the members processItem() reads are destroyed.
+    void stop();
+
+private slots:
+    void onItemDone(int index, bool ok, const QString & message);
+
+private:
+    friend class BatchTask;
+
+    QThreadPool m_pool;
+    QStringList m_items;
+    QAtomicInt m_cancelled;
+    QElapsedTimer m_timer;
+    QString m_error;
+    bool m_running {false};
+    int m_done {0};
+    int m_succeeded {0};
+    int m_failed {0};
+
+    void runItem(int index);
+};
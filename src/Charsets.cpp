@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: 8-bit character sets as lookup tables for the sector view and search
+
+#include "Charsets.h"
+#include "ViewerRegistry.h"
+#include "ViewerText.h"
+
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// ============================================================================
+// Character sets, one constexpr function per byte
+
+// KOI-7 N1 / KOI-8 order of Cyrillic letters, 0x40 (0x60) to 0x5F (0x7F)
+constexpr char16_t CYRILLIC_SMALL[] = u"юабцдефгхийклмнопярстужвьызшэщчъ";
+constexpr char16_t CYRILLIC_CAPITAL[] = u"ЮАБЦДЕФГХИЙКЛМНОПЯРСТУЖВЬЫЗШЭЩЧЪ";
+
+struct AsciiMap {
+    static constexpr char16_t map(int c) { return c < 0x80 ? c : 0xFFFD; }
+};
+
+// Text is stored with the high bit set, there are no small letters on the II and II+
+struct Apple2Map {
+    static constexpr char16_t map(int c) {
+        return ((c & 0x7F) >= 0x60 && (c & 0x7F) < 0x7F) ? (c & 0x7F) - 0x20 : (c & 0x7F);
+    }
+};
+
+struct Apple2cMap {
+    static constexpr char16_t map(int c) { return c & 0x7F; }
+};
+
+// N0 (Latin) in the low half, N1 (Cyrillic) in the high half, as in KOI-8
+struct Koi7N0N1Map {
+    static constexpr char16_t map(int c) {
+        return c < 0xC0 ? (c & 0x7F)
+             : c < 0xE0 ? CYRILLIC_SMALL[c - 0xC0]
+             : CYRILLIC_CAPITAL[c - 0xE0];
+    }
+};
+
+// Capital Cyrillic letters instead of small Latin ones, 0x7F stays DEL
+struct Koi7N2Map {
+    static constexpr char16_t map(int c) {
+        return ((c & 0x7F) >= 0x60 && (c & 0x7F) < 0x7F) ? CYRILLIC_CAPITAL[(c & 0x7F) - 0x60]
+             : (c & 0x7F) == 0x24 ? 0x00A4
+             : (c & 0x7F);
+    }
+};
+
+// KOI-7 N2 letters in bytes with the high bit set, Latin below
+struct AgatMap {
+    static constexpr char16_t map(int c) {
+        return (c >= 0xE0 && c < 0xFF) ? CYRILLIC_CAPITAL[c - 0xE0] : (c & 0x7F);
+    }
+};
+
+// ============================================================================
+// Table generation
+
+template<int... I> struct Indices {};
+template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+typedef MakeIndices<256>::type Bytes;
+
+struct Table16 {
+    char16_t code[256];
+};
+
+// Every byte as UTF-8 padded to 4 bytes, so translation copies a fixed size and moves by length
+struct Table8 {
+    uint8_t bytes[256][4];
+    uint8_t length[256];
+};
+
+constexpr uint8_t utf8Length(char16_t u)
+{
+    return u < 0x80 ? 1 : u < 0x800 ? 2 : 3;
+}
+
+constexpr uint8_t utf8Byte(char16_t u, int k)
+{
+    return static_cast<uint8_t>(
+        u < 0x80  ? (k == 0 ? u : 0)
+      : u < 0x800 ? (k == 0 ? 0xC0 | (u >> 6) : k == 1 ? 0x80 | (u & 0x3F) : 0)
+      :             (k == 0 ? 0xE0 | (u >> 12) : k == 1 ? 0x80 | ((u >> 6) & 0x3F) : k == 2 ? 0x80 | (u & 0x3F) : 0)
+    );
+}
+
+template<class Map, int... I>
+constexpr Table16 makeTable16(Indices<I...>)
+{
+    return Table16{{ Map::map(I)... }};
+}
+
+template<class Map, int... I>
+constexpr Table8 makeTable8(Indices<I...>)
+{
+    return Table8{
+        {{ utf8Byte(Map::map(I), 0), utf8Byte(Map::map(I), 1), utf8Byte(Map::map(I), 2), 0 }...},
+        { utf8Length(Map::map(I))... }
+    };
+}
+
+// In the order of Charsets::Encoding
+constexpr Table16 TABLES16[Charsets::EncodingCount] = {
+    makeTable16<AgatMap>(Bytes()),
+    makeTable16<Apple2Map>(Bytes()),
+    makeTable16<Apple2cMap>(Bytes()),
+    makeTable16<AsciiMap>(Bytes()),
+    makeTable16<Koi7N0N1Map>(Bytes()),
+    makeTable16<Koi7N2Map>(Bytes()),
+};
+
+constexpr Table8 TABLES8[Charsets::EncodingCount] = {
+    makeTable8<AgatMap>(Bytes()),
+    makeTable8<Apple2Map>(Bytes()),
+    makeTable8<Apple2cMap>(Bytes()),
+    makeTable8<AsciiMap>(Bytes()),
+    makeTable8<Koi7N0N1Map>(Bytes()),
+    makeTable8<Koi7N2Map>(Bytes()),
+};
+
+static_assert(TABLES16[Charsets::Apple2].code[0xC1] == u'A', "Apple II: high bit");
+static_assert(TABLES16[Charsets::Koi7N0N1].code[0xC1] == u'а', "KOI-7 N1: small letters");
+static_assert(TABLES16[Charsets::Koi7N2].code[0x61] == u'А', "KOI-7 N2: capital letters");
+static_assert(TABLES8[Charsets::Koi7N2].length[0x61] == 2, "Cyrillic is two bytes in UTF-8");
+
+const char * const NAMES[Charsets::EncodingCount] = {
+    "agat", "apple2", "apple2c", "ascii", "koi7_n0_n1", "koi7_n2"
+};
+
+// ============================================================================
+// Tables in use: the ones above, checked against dsk_tools
+
+struct Tables {
+    Table16 t16[Charsets::EncodingCount];
+    Table8 t8[Charsets::EncodingCount];
+};
+
+// The only code point of a UTF-8 string, 0 if there are none or several
+char16_t singleCode(const std::string & text)
+{
+    const unsigned char * s = reinterpret_cast<const unsigned char *>(text.data());
+    if (text.size() == 1 && s[0] < 0x80) return s[0];
+    if (text.size() == 2 && (s[0] & 0xE0) == 0xC0) return static_cast<char16_t>(((s[0] & 0x1F) << 6) | (s[1] & 0x3F));
+    if (text.size() == 3 && (s[0] & 0xF0) == 0xE0)
+        return static_cast<char16_t>(((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F));
+    return 0;
+}
+
+bool isGlyph(char16_t u)
+{
+    return u >= 0x20 && u != 0x7F && u != 0xFFFD;
+}
+
+// Every byte is decoded once by the dsk_tools TEXT viewer, the text viewer of the application.
+// Where it shows a character other than the one above, its character is taken, so the sector
+// view and searches always agree with the viewer. Control codes, which the viewer turns into
+// line breaks or drops, keep the values above.
+Tables makeTables()
+{
+    Tables tables;
+    std::memcpy(tables.t16, TABLES16, sizeof(TABLES16));
+    std::memcpy(tables.t8, TABLES8, sizeof(TABLES8));
+
+    ViewerRegistry::instance();
+    const std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create("TEXT", "");
+    if (!viewer) return tables;
+
+    for (int e = 0; e < Charsets::EncodingCount; e++) {
+        for (int c = 0; c < 256; c++) {
+            const dsk_tools::BYTES byte(1, static_cast<uint8_t>(c));
+            std::string text = ViewerText::toPlainText(viewer->process_as_text(byte, NAMES[e]));
+            while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+
+            const char16_t u = singleCode(text);
+            if (!isGlyph(u) || u == tables.t16[e].code[c]) continue;
+            tables.t16[e].code[c] = u;
+            for (int k = 0; k < 3; k++) tables.t8[e].bytes[c][k] = utf8Byte(u, k);
+            tables.t8[e].length[c] = utf8Length(u);
+        }
+    }
+    return tables;
+}
+
+const Tables & tables()
+{
+    static const Tables instance = makeTables();
+    return instance;
+}
+
+} // namespace
+
+// ============================================================================
+// Charsets
+
+bool Charsets::fromName(const std::string & name, Encoding & encoding)
+{
+    for (int i = 0; i < EncodingCount; i++) {
+        if (name == NAMES[i]) {
+            encoding = static_cast<Encoding>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char * Charsets::name(Encoding encoding)
+{
+    return NAMES[encoding];
+}
+
+const char16_t * Charsets::table(Encoding encoding)
+{
+    return tables().t16[encoding].code;
+}
+
+const char16_t * Charsets::builtinTable(Encoding encoding)
+{
+    return TABLES16[encoding].code;
+}
+
+void Charsets::toUtf16(Encoding encoding, const uint8_t * data, size_t size, char16_t * out)
+{
+    const char16_t * t = tables().t16[encoding].code;
+    for (size_t i = 0; i < size; i++) out[i] = t[data[i]];
+}
+
+QString Charsets::toQString(Encoding encoding, const uint8_t * data, size_t size)
+{
+    QString result(static_cast<int>(size), Qt::Uninitialized);
+    toUtf16(encoding, data, size, reinterpret_cast<char16_t *>(result.data()));
+    return result;
+}
+
+std::string Charsets::toUtf8(Encoding encoding, const uint8_t * data, size_t size)
+{
+    const Table8 & t = tables().t8[encoding];
+    // Up to 3 bytes per character plus the padding of the last one
+    std::string result(size * 3 + 1, '\0');
+    char * out = &result[0];
+    size_t pos = 0;
+    for (size_t i = 0; i < size; i++) {
+        const uint8_t c = data[i];
+        std::memcpy(out + pos, t.bytes[c], 4);
+        pos += t.length[c];
+    }
+    result.resize(pos);
+    return result;
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: 8-bit character sets as lookup tables for the sector view and search
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <QString>
+
+// The encodings of the text viewer, decoded here for the sector view and for searching file
+// data (SearchContents::Bytes). The text viewer itself is not switched over: it decodes in
+// dsk_tools, which keeps its own definitions. The maps in Charsets.cpp are built at compile
+// time after them; on first use every byte is also decoded by the dsk_tools TEXT viewer, and
+// where it shows another character the library's one is used. bench_charsets lists such bytes.
+class Charsets {
+public:
+    // The same ids as the viewer's encoding list
+    enum Encoding {
+        Agat,
+        Apple2,
+        Apple2c,
+        Ascii,
+        Koi7N0N1,
+        Koi7N2,
+        EncodingCount
+    };
+
+    // "agat", "apple2", "apple2c", "ascii", "koi7_n0_n1", "koi7_n2"; false if unknown
+    static bool fromName(const std::string & name, Encoding & encoding);
+    static const char * name(Encoding encoding);
+
+    // One UTF-16 code per byte. The first call builds the tables, see above;
+    // make it on a thread that may register viewers.
+    static const char16_t * table(Encoding encoding);
+
+    // The compile-time table, without the corrections taken from dsk_tools
+    static const char16_t * builtinTable(Encoding encoding);
+
+    static char16_t toUnicode(Encoding encoding, uint8_t c) { return table(encoding)[c]; }
+
+    // Bulk translation without branches per byte
+    static void toUtf16(Encoding encoding, const uint8_t * data, size_t size, char16_t * out);
+    static QString toQString(Encoding encoding, const uint8_t * data, size_t size);
+    static std::string toUtf8(Encoding encoding, const uint8_t * data, size_t size);
+};
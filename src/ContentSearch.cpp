@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Searches names and contents of files inside many disk images
+
+#include "ContentSearch.h"
+#include "ImageUtils.h"
+#include "ViewerText.h"
+#include "ViewerRegistry.h"
+#include "stringutils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <QCoreApplication>
+
+namespace {
+
+const int MAX_DEPTH = 10;           // The same limit as FileOperations::putFiles()
+const size_t EXCERPT_BEFORE = 24;   // Bytes of context around an occurrence
+const size_t EXCERPT_AFTER = 48;
+
+bool isContinuation(char c)
+{
+    return (static_cast<uint8_t>(c) & 0xC0) == 0x80;
+}
+
+} // namespace
+
+// ============================================================================
+//  TextFinder
+// ============================================================================
+
+TextFinder::TextFinder(const std::string & pattern, bool case_sensitive)
+    : m_pattern(pattern)
+    , m_case_sensitive(case_sensitive)
+{
+    if (!m_case_sensitive) fold(m_pattern);
+}
+
+size_t TextFinder::find(const std::string & text, size_t from) const
+{
+    const size_t length = m_pattern.size();
+    if (length == 0 || text.size() < length || from > text.size() - length) return std::string::npos;
+
+    const char * begin = text.data();
+    const char * last = begin + text.size() - length;     // The last possible start
+    const char first = m_pattern[0];
+    const char * p = begin + from;
+    while (p <= last) {
+        p = static_cast<const char *>(std::memchr(p, first, static_cast<size_t>(last - p) + 1));
+        if (!p) break;
+        if (std::memcmp(p + 1, m_pattern.data() + 1, length - 1) == 0) return static_cast<size_t>(p - begin);
+        p++;
+    }
+    return std::string::npos;
+}
+
+void TextFinder::fold(std::string & text)
+{
+    const size_t n = text.size();
+    size_t i = 0;
+    while (i < n) {
+        const uint8_t c = static_cast<uint8_t>(text[i]);
+        if (c >= 'A' && c <= 'Z') {
+            text[i] = static_cast<char>(c + 0x20);
+        } else if (c == 0xD0 && i + 1 < n) {
+            // U+0401..U+042F: capital Cyrillic letters and Ё
+            const uint8_t c2 = static_cast<uint8_t>(text[i + 1]);
+            if (c2 >= 0x90 && c2 <= 0x9F) {             // А..П -> а..п
+                text[i + 1] = static_cast<char>(c2 + 0x20);
+            } else if (c2 >= 0xA0 && c2 <= 0xAF) {      // Р..Я -> р..я
+                text[i] = static_cast<char>(0xD1);
+                text[i + 1] = static_cast<char>(c2 - 0x20);
+            } else if (c2 == 0x81) {                    // Ё -> ё
+                text[i] = static_cast<char>(0xD1);
+                text[i + 1] = static_cast<char>(0x91);
+            }
+            i++;
+        }
+        i++;
+    }
+}
+
+// ============================================================================
+//  ContentSearch
+// ============================================================================
+
+ContentSearch::ContentSearch(QObject *parent)
+    : BatchRunner(parent)
+{}
+
+ContentSearch::~ContentSearch()
+{
+    stop();
+}
+
+bool ContentSearch::beforeStart(QString & error)
+{
+    if (m_options.text.isEmpty()) {
+        error = tr("Nothing to search for");
+        return false;
+    }
+    if (!m_options.names && m_options.contents == SearchContents::None) {
+        error = tr("Neither names nor contents are searched");
+        return false;
+    }
+    if (!Charsets::fromName(m_options.encoding, m_charset)) {
+        error = tr("Unknown encoding '%1'").arg(QString::fromStdString(m_options.encoding));
+        return false;
+    }
+    m_finder = TextFinder(m_options.text.toStdString(), m_options.case_sensitive);
+
+    // Viewers are registered here, on the calling thread, and only created by workers.
+    // The charset tables are checked against the viewers here too, workers only read them.
+    ViewerRegistry::instance();
+    Charsets::table(m_charset);
+    return true;
+}
+
+dsk_tools::Result ContentSearch::processItem(int index, const QString & item, QString & message)
+{
+    Q_UNUSED(index);
+
+    LoadedImage loaded;
+    const dsk_tools::Result res = ImageUtils::openImage(_toStdString(item), loaded);
+    if (!res) return res;
+
+    int found = 0;
+    searchDir(loaded.filesystem.get(), item, QString(), 0, found);
+    message = tr("%1 files found").arg(found);
+    return dsk_tools::Result::ok();
+}
+
+bool ContentSearch::searchDir(dsk_tools::fileSystem * fs, const QString & image, const QString & path, int depth, int & found)
+{
+    dsk_tools::Files files;
+    if (!fs->dir(files, false)) return true;
+
+    for (const dsk_tools::UniversalFile & f : files) {
+        if (isCancelled()) return false;
+        if (f.name == "..") continue;
+
+        const QString name = QString::fromStdString(f.name);
+        const QString file_path = path.isEmpty() ? name : path + "/" + name;
+        searchFile(fs, f, image, file_path, found);
+
+        if (f.is_dir && depth < MAX_DEPTH) {
+            fs->cd(f);
+            const bool go_on = searchDir(fs, image, file_path, depth + 1, found);
+            fs->cd_up();
+            if (!go_on) return false;
+        }
+    }
+    return true;
+}
+
+void ContentSearch::searchFile(dsk_tools::fileSystem * fs, const dsk_tools::UniversalFile & f,
+                               const QString & image, const QString & path, int & found)
+{
+    int hits = 0;
+    QString context;
+
+    if (m_options.names) {
+        std::string name = f.name;
+        if (!m_finder.caseSensitive()) TextFinder::fold(name);
+        if (m_finder.find(name) != std::string::npos) hits++;
+    }
+
+    if (!f.is_dir && m_options.contents != SearchContents::None) {
+        dsk_tools::BYTES data;
+        if (fs->get_file(f, "", data) && !data.empty()) {
+            const std::string text = contentsText(f, data);
+
+            // Without case sensitivity occurrences are found in a folded copy of the same length
+            std::string folded;
+            if (!m_finder.caseSensitive()) {
+                folded = text;
+                TextFinder::fold(folded);
+            }
+            const std::string & haystack = m_finder.caseSensitive() ? text : folded;
+
+            size_t pos = m_finder.find(haystack);
+            if (pos != std::string::npos) context = excerpt(text, pos, m_finder.length());
+            while (pos != std::string::npos) {
+                hits++;
+                pos = m_finder.find(haystack, pos + m_finder.length());
+            }
+        }
+    }
+
+    if (hits == 0) return;
+    found++;
+    QMetaObject::invokeMethod(this, "onMatch", Qt::QueuedConnection,
+                              Q_ARG(QString, image),
+                              Q_ARG(QString, path),
+                              Q_ARG(int, hits),
+                              Q_ARG(QString, context));
+}
+
+std::string ContentSearch::contentsText(const dsk_tools::UniversalFile & f, const dsk_tools::BYTES & data) const
+{
+    if (m_options.contents == SearchContents::Bytes)
+        return Charsets::toUtf8(m_charset, data.data(), data.size());
+
+    // The viewer the file opens with, plain text if it has no text output
+    std::string type, subtype;
+    ViewerRegistry::suggest(f, data, type, subtype);
+    std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create(type, subtype);
+    if (!viewer || viewer->get_output_type() != dsk_tools::ViewerOutput::Text)
+        viewer = dsk_tools::ViewerManager::instance().create("TEXT", "");
+    if (!viewer) return Charsets::toUtf8(m_charset, data.data(), data.size());
+    return ViewerText::toPlainText(viewer->process_as_text(data, m_options.encoding));
+}
+
+QString ContentSearch::excerpt(const std::string & text, size_t pos, size_t length)
+{
+    size_t start = pos > EXCERPT_BEFORE ? pos - EXCERPT_BEFORE : 0;
+    size_t end = std::min(text.size(), pos + length + EXCERPT_AFTER);
+
+    // Only the line of the occurrence
+    for (size_t i = pos; i > start; i--) {
+        if (text[i - 1] == '\n' || text[i - 1] == '\r') {
+            start = i;
+            break;
+        }
+    }
+    for (size_t i = pos + length; i < end; i++) {
+        if (text[i] == '\n' || text[i] == '\r') {
+            end = i;
+            break;
+        }
+    }
+    while (start < pos && isContinuation(text[start])) start++;
+    while (end < text.size() && end > pos + length && isContinuation(text[end])) end--;
+
+    QString result = QString::fromUtf8(text.data() + start, static_cast<int>(end - start));
+    result.replace('\t', ' ');
+    if (start > 0 && text[start - 1] != '\n' && text[start - 1] != '\r') result.prepend(QStringLiteral("..."));
+    if (end < text.size() && text[end] != '\n' && text[end] != '\r') result.append(QStringLiteral("..."));
+    return result;
+}
+
+void ContentSearch::onMatch(const QString & image, const QString & path, int hits, const QString & excerpt)
+{
+    emit matchFound(image, path, hits, excerpt);
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Searches names and contents of files inside many disk images
+
+#pragma once
+
+#include <string>
+
+#include "BatchRunner.h"
+#include "Charsets.h"
+
+enum class SearchContents {
+    None,           // File names only
+    Bytes,          // File data translated by the charset
+    Text            // Output of the file's text viewer: detokenized BASIC, assembler listings, ...
+};
+
+struct SearchOptions {
+    QString root;
+    QString text;
+    bool case_sensitive {false};
+    bool names {true};
+    SearchContents contents {SearchContents::Bytes};
+    std::string encoding {"agat"};
+};
+
+// Substring search in UTF-8 text. Candidates are found by memchr() and checked by memcmp(),
+// both vectorized by the C library, so a miss costs a fraction of a byte comparison per byte.
+class TextFinder
+{
+public:
+    TextFinder() = default;
+    TextFinder(const std::string & pattern, bool case_sensitive);
+
+    bool isEmpty() const { return m_pattern.empty(); }
+    size_t length() const { return m_pattern.size(); }
+    bool caseSensitive() const { return m_case_sensitive; }
+
+    // Offset of the first occurrence at or after from, std::string::npos if none.
+    // Without case sensitivity the text must be passed through fold() first.
+    size_t find(const std::string & text, size_t from = 0) const;
+
+    // Lower case for Latin and Cyrillic letters, the only ones Charsets produce.
+    // Byte lengths are kept, so offsets in the folded text are valid in the original one.
+    static void fold(std::string & text);
+
+private:
+    std::string m_pattern;
+    bool m_case_sensitive {true};
+};
+
+class ContentSearch : public BatchRunner
+{
+    Q_OBJECT
+
+public:
+    explicit ContentSearch(QObject *parent = nullptr);
+    ~ContentSearch() override;
+
+    void setOptions(const SearchOptions & options) { m_options = options; }
+    const SearchOptions & options() const { return m_options; }
+
+    // A line of text around an occurrence, cut at UTF-8 character boundaries
+    static QString excerpt(const std::string & text, size_t pos, size_t length);
+
+signals:
+    // Sent as files are searched, on the owner's thread. path is the name inside the image
+    // with '/' between directories; excerpt is empty if only the name matched.
+    void matchFound(const QString & image, const QString & path, int hits, const QString & excerpt);
+
+protected:
+    dsk_tools::Result processItem(int index, const QString & item, QString & message) override;
+    bool beforeStart(QString & error) override;
+
+private slots:
+    void onMatch(const QString & image, const QString & path, int hits, const QString & excerpt);
+
+private:
+    // Snapshot of everything workers need, taken in beforeStart() and read-only afterwards
+    SearchOptions m_options;
+    TextFinder m_finder;
+    Charsets::Encoding m_charset {Charsets::Agat};
+
+    bool searchDir(dsk_tools::fileSystem * fs, const QString & image, const QString & path, int depth, int & found);
+    void searchFile(dsk_tools::fileSystem * fs, const dsk_tools::UniversalFile & f, const QString & image, const QString & path, int & found);
+    std::string contentsText(const dsk_tools::UniversalFile & f, const dsk_tools::BYTES & data) const;
+};
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Texts of dsk_tools error codes
+
+#pragma once
+
+#include <QString>
+
+#include "dsk_tools/dsk_tools.h"
+
+// Needs only Qt Core, so workers, the image server and dskfuse can use it
+class ErrorText {
+public:
+    // A translated text of the code, followed by the message of the result if there is one
+    static QString decode(const dsk_tools::Result& result);
+};
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Digests identifying file contents
+
+#include "FileDigest.h"
+#include "ViewerRegistry.h"
+
+#include <QCryptographicHash>
+
+FileDigest FileDigest::of(const dsk_tools::BYTES & data, bool sha256)
+{
+    FileDigest digest;
+    digest.size = data.size();
+    digest.hash = ViewerRegistry::contentHash(data);
+    if (sha256) {
+        digest.sha256 = QCryptographicHash::hash(
+            QByteArray::fromRawData(reinterpret_cast<const char *>(data.data()), static_cast<int>(data.size())),
+            QCryptographicHash::Sha256);
+    }
+    return digest;
+}
+
+bool FileDigest::operator<(const FileDigest & other) const
+{
+    if (size != other.size) return size < other.size;
+    if (hash != other.hash) return hash < other.hash;
+    return sha256 < other.sha256;
+}
+
+bool FileDigest::operator==(const FileDigest & other) const
+{
+    return size == other.size && hash == other.hash && sha256 == other.sha256;
+}
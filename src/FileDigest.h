@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Digests identifying file contents
+
+#pragma once
+
+#include <QByteArray>
+
+#include "dsk_tools/dsk_tools.h"
+
+// Identifies file contents. The fast hash is the one viewers and thumbnails are cached by;
+// SHA-256 is only computed if asked for, to rule out hash collisions.
+struct FileDigest {
+    quint64 size {0};
+    quint64 hash {0};
+    QByteArray sha256;
+
+    static FileDigest of(const dsk_tools::BYTES & data, bool sha256);
+
+    bool operator<(const FileDigest & other) const;
+    bool operator==(const FileDigest & other) const;
+    bool operator!=(const FileDigest & other) const { return !(*this == other); }
+};
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Shared directory listings and handles to their entries
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dsk_tools/dsk_tools.h"
+
+// A directory listing as a file system returned it. It is never changed once shared,
+// a new read of the directory makes a new listing.
+typedef std::shared_ptr<const dsk_tools::Files> FileListing;
+
+inline FileListing makeListing(dsk_tools::Files && files)
+{
+    return std::make_shared<const dsk_tools::Files>(std::move(files));
+}
+
+// An entry of a listing. Copying a handle copies a pointer and an index, not the entry,
+// and the entry stays valid while any handle to its listing exists.
+class FileHandle
+{
+public:
+    FileHandle() = default;
+    FileHandle(const FileListing & listing, size_t index)
+        : m_listing(listing)
+        , m_index(static_cast<uint32_t>(index))
+    {}
+
+    bool isNull() const { return !m_listing; }
+    const dsk_tools::UniversalFile & operator*() const { return (*m_listing)[m_index]; }
+    const dsk_tools::UniversalFile * operator->() const { return &(*m_listing)[m_index]; }
+
+private:
+    FileListing m_listing;
+    uint32_t m_index {0};
+};
+
+typedef std::vector<FileHandle> FileHandles;
+
+// Handles to all entries of a listing, in its order
+inline FileHandles makeHandles(const FileListing & listing)
+{
+    FileHandles handles;
+    handles.reserve(listing->size());
+    for (size_t i = 0; i < listing->size(); i++) handles.emplace_back(listing, i);
+    return handles;
+}
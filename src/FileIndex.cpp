@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Content hash index of the files inside many disk images
+
+#include "FileIndex.h"
+#include "ImageUtils.h"
+#include "stringutils.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const int MAX_DEPTH = 10;   // The same limit as FileOperations::putFiles()
+
+} // namespace
+
+// ============================================================================
+//  FileIndex
+// ============================================================================
+
+std::vector<FileIndex::Range> FileIndex::duplicates() const
+{
+    std::vector<Range> groups;
+    size_t first = 0;
+    while (first < entries.size()) {
+        size_t last = first + 1;
+        while (last < entries.size() && entries[last].digest == entries[first].digest) last++;
+        if (last - first > 1) groups.push_back(Range(first, last));
+        first = last;
+    }
+    // Entries go by size ascending, so the largest (most wasteful) groups are at the end
+    std::reverse(groups.begin(), groups.end());
+    return groups;
+}
+
+FileIndex::Range FileIndex::copies(const FileDigest & digest) const
+{
+    FileIndexEntry probe;
+    probe.digest = digest;
+    const auto range = std::equal_range(entries.begin(), entries.end(), probe,
+        [](const FileIndexEntry & a, const FileIndexEntry & b) { return a.digest < b.digest; });
+    return Range(static_cast<size_t>(range.first - entries.begin()), static_cast<size_t>(range.second - entries.begin()));
+}
+
+// ============================================================================
+//  FileIndexer
+// ============================================================================
+
+FileIndexer::FileIndexer(QObject *parent)
+    : BatchRunner(parent)
+{}
+
+FileIndexer::~FileIndexer()
+{
+    stop();
+}
+
+void FileIndexer::setOptions(const QString & root, bool sha256)
+{
+    m_root = root;
+    m_sha256 = sha256;
+}
+
+bool FileIndexer::beforeStart(QString & error)
+{
+    Q_UNUSED(error);
+    m_results.assign(items().size(), std::vector<FileIndexEntry>());
+    return true;
+}
+
+dsk_tools::Result FileIndexer::processItem(int index, const QString & item, QString & message)
+{
+    LoadedImage loaded;
+    const dsk_tools::Result res = ImageUtils::openImage(_toStdString(item), loaded);
+    if (!res) return res;
+
+    std::vector<FileIndexEntry> & out = m_results[index];
+    hashDir(loaded.filesystem.get(), static_cast<quint32>(index), QString(), 0, out);
+    message = tr("%1 files").arg(out.size());
+    return dsk_tools::Result::ok();
+}
+
+bool FileIndexer::hashDir(dsk_tools::fileSystem * fs, quint32 image, const QString & path, int depth, std::vector<FileIndexEntry> & out) const
+{
+    dsk_tools::Files files;
+    if (!fs->dir(files, false)) return true;
+
+    for (const dsk_tools::UniversalFile & f : files) {
+        if (isCancelled()) return false;
+        if (f.name == "..") continue;
+
+        const QString name = QString::fromStdString(f.name);
+        const QString file_path = path.isEmpty() ? name : path + "/" + name;
+        if (f.is_dir) {
+            if (depth >= MAX_DEPTH) continue;
+            fs->cd(f);
+            const bool go_on = hashDir(fs, image, file_path, depth + 1, out);
+            fs->cd_up();
+            if (!go_on) return false;
+            continue;
+        }
+
+        // Empty files are all the same and are not worth reporting
+        dsk_tools::BYTES data;
+        if (!fs->get_file(f, "", data) || data.empty()) continue;
+
+        FileIndexEntry entry;
+        entry.digest = FileDigest::of(data, m_sha256);
+        entry.image = image;
+        entry.path = file_path;
+        out.push_back(entry);
+    }
+    return true;
+}
+
+void FileIndexer::afterFinish()
+{
+    std::shared_ptr<FileIndex> index = std::make_shared<FileIndex>();
+    index->root = m_root;
+    index->sha256 = m_sha256;
+    index->complete = !isCancelled();
+    index->images = items();
+
+    size_t total = 0;
+    for (const auto & result : m_results) total += result.size();
+    index->entries.reserve(total);
+    for (auto & result : m_results) {
+        std::move(result.begin(), result.end(), std::back_inserter(index->entries));
+    }
+    m_results.clear();
+
+    std::sort(index->entries.begin(), index->entries.end(), [](const FileIndexEntry & a, const FileIndexEntry & b) {
+        if (a.digest != b.digest) return a.digest < b.digest;
+        if (a.image != b.image) return a.image < b.image;
+        return a.path < b.path;
+    });
+
+    m_index = index;
+}
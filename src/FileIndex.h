@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Content hash index of the files inside many disk images
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BatchRunner.h"
+#include "FileDigest.h"
+
+struct FileIndexEntry {
+    FileDigest digest;
+    quint32 image {0};      // Index in FileIndex::images
+    QString path;           // Inside the image, '/' between directories
+};
+
+class FileIndex
+{
+public:
+    typedef std::pair<size_t, size_t> Range;   // [first, last) in entries
+
+    QString root;
+    bool sha256 {false};
+    bool complete {true};               // false if indexing was stopped
+    QStringList images;
+    std::vector<FileIndexEntry> entries;        // Sorted by digest, then by image and path
+
+    // Groups of two or more files with the same contents, largest files first
+    std::vector<Range> duplicates() const;
+
+    // All files with these contents; the digest must be made with this index's sha256 setting
+    Range copies(const FileDigest & digest) const;
+};
+
+class FileIndexer : public BatchRunner
+{
+    Q_OBJECT
+
+public:
+    explicit FileIndexer(QObject *parent = nullptr);
+    ~FileIndexer() override;
+
+    void setOptions(const QString & root, bool sha256);
+
+    // Built after finished(), stays valid after the next run starts
+    std::shared_ptr<const FileIndex> index() const { return m_index; }
+
+protected:
+    dsk_tools::Result processItem(int index, const QString & item, QString & message) override;
+    bool beforeStart(QString & error) override;
+    void afterFinish() override;
+
+private:
+    QString m_root;
+    bool m_sha256 {false};
+
+    std::vector<std::vector<FileIndexEntry>> m_results;     // One slot per image, each written by its own worker only
+    std::shared_ptr<const FileIndex> m_index;
+
+    bool hashDir(dsk_tools::fileSystem * fs, quint32 image, const QString & path, int depth, std::vector<FileIndexEntry> & out) const;
+};
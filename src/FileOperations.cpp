@@ -10,7 +10,13 @@
 #include "fileparamdialog.h"
 #include "convertdialog.h"
 #include "viewdialog.h"
+#include "sectordialog.h"
+#include "gallerydialog.h"
+#include "comparedialog.h"
 #include "formatdialog.h"
+#include "ImageUtils.h"
+#include "ErrorText.h"
+#include "TrackTemplate.h"
 #include "fs_host.h"
 #include "host_helpers.h"
 #include "./ui_fileinfodialog.h"
@@ -29,7 +35,6 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <memory>
-#include <set>
 
 #include "dsk_tools/dsk_tools.h"
 
@@ -127,7 +132,9 @@ void FileOperations::openItem(FilePanel* panel, QWidget* parent, const QModelInd
             }
         }
     } else {
-        const auto f = panel->getFiles()[index.row()];
+        // The handle keeps the entry while a viewer is open and the panel is read again
+        const FileHandle handle = panel->fileHandle(index.row());
+        const dsk_tools::UniversalFile & f = *handle;
         if (f.is_dir){
             bool updir;
             panel->getFileSystem()->cd(f, updir);
@@ -148,7 +155,7 @@ void FileOperations::openItem(FilePanel* panel, QWidget* parent, const QModelInd
                                     f.is_deleted,
                                     panel->getImage(),
                                     panel->getFileSystem(),
-                                    f
+                                    handle
                 );
                 w->setAttribute(Qt::WA_DeleteOnClose);
                 w->setWindowTitle(w->windowTitle() + " (" + QString::fromStdString(f.name) + ")");
@@ -185,7 +192,7 @@ void FileOperations::viewFileInfo(FilePanel* panel, QWidget* parent)
 {
     const QModelIndex index = panel->getCurrentIndex();
     if (index.isValid()) {
-        const auto f = panel->getFiles()[index.row()];
+        const auto & f = panel->fileAt(index.row());
         infoDialog(parent, QString::fromStdString(panel->getFileSystem()->file_info(f)));
     }
 }
@@ -202,8 +209,8 @@ void FileOperations::editFile(FilePanel* panel, QWidget* parent)
             const dsk_tools::FSCaps funcs = panel->getFileSystem()->get_caps();
             if (dsk_tools::hasFlag(funcs, dsk_tools::FSCaps::Metadata)) {
                 auto filesystem = panel->getFileSystem();
-                auto f = panel->getFiles()[index.row()];
-                std::vector<dsk_tools::ParameterDescription> params = filesystem->file_get_metadata(f);
+                const FileHandle f = panel->fileHandle(index.row());
+                std::vector<dsk_tools::ParameterDescription> params = filesystem->file_get_metadata(*f);
 
                 for (auto & param : params) {
                     param.name = replacePlaceholders(QString::fromStdString(param.name)).toStdString();
@@ -212,7 +219,7 @@ void FileOperations::editFile(FilePanel* panel, QWidget* parent)
                 FileParamDialog dialog(params);
                 if (dialog.exec() == QDialog::Accepted) {
                     const auto values = dialog.getParameters();
-                    filesystem->file_set_metadata(f, values);
+                    filesystem->file_set_metadata(*f, values);
                     panel->storeTableState();
                     panel->dir();
                     panel->restoreTableState();
@@ -237,6 +244,46 @@ void FileOperations::viewFilesystemInfo(FilePanel* panel, QWidget* parent)
     showInfoDialog(info, FilePanel::tr("Filesystem Info"), parent);
 }
 
+void FileOperations::viewSectors(FilePanel* panel, QWidget* parent)
+{
+    if (!panel || !parent || panel->getMode() != panelMode::Image || !panel->getImage()) return;
+
+    // Modal: the view paints from the image of the panel, which may be closed or replaced
+    SectorDialog w(parent, panel->getSettings(), panel->getImage());
+    w.setWindowTitle(w.windowTitle() + " (" + QFileInfo(QString::fromStdString(panel->getImage()->file_name())).fileName() + ")");
+    w.exec();
+}
+
+void FileOperations::viewGallery(FilePanel* panel, QWidget* parent)
+{
+    if (!panel || !parent || panel->getMode() != panelMode::Image || !panel->getImage()) return;
+
+    // Modal: the gallery reads files from the current directory of the panel
+    GalleryDialog w(parent, panel->getSettings(), panel->getImage(), panel->getFileSystem());
+    w.setWindowTitle(w.windowTitle() + " (" + QFileInfo(QString::fromStdString(panel->getImage()->file_name())).fileName() + ")");
+    w.exec();
+}
+
+void FileOperations::compareImages(FilePanel* left, FilePanel* right, QWidget* parent)
+{
+    if (!left || !right || !parent) return;
+    if (left->getMode() != panelMode::Image || right->getMode() != panelMode::Image
+        || !left->getImage() || !right->getImage()) {
+        QMessageBox::information(parent, FilePanel::tr("Compare images"), FilePanel::tr("Open images in both panels to compare them."));
+        return;
+    }
+
+    // Runs on the GUI thread: both images are in memory and the comparison takes milliseconds
+    const ImageDiffResult diff = ImageDiff::compare(left->getImage(), left->getLoadedFileSystem(),
+                                                    right->getImage(), right->getLoadedFileSystem());
+
+    CompareDialog w(parent,
+                    QFileInfo(QString::fromStdString(left->getImage()->file_name())).fileName(),
+                    QFileInfo(QString::fromStdString(right->getImage()->file_name())).fileName(),
+                    diff);
+    w.exec();
+}
+
 void FileOperations::copyFiles(FilePanel* source, FilePanel* target, QWidget* parent)
 {
     if (!source || !target || !parent) return;
@@ -276,7 +323,7 @@ void FileOperations::copyFiles(FilePanel* source, FilePanel* target, QWidget* pa
             // Save selected format to settings for next time
             source->getSettings()->setValue("export/extract_format_"+fs_string, selectedFormat);
 
-            const dsk_tools::Files files = source->getSelectedFiles();
+            const FileHandles files = source->getSelectedFiles();
             putFiles(source, target, parent, files, selectedFormat, 0);
             target->refresh();
             source->clearSelection();
@@ -296,7 +343,7 @@ void FileOperations::copyFiles(FilePanel* source, FilePanel* target, QWidget* pa
         );
 
         if (reply == QMessageBox::Yes) {
-            const dsk_tools::Files files = source->getSelectedFiles();
+            const FileHandles files = source->getSelectedFiles();
             putFiles(source, target, parent, files, "", 0);
             target->refresh();
             source->clearSelection();
@@ -310,7 +357,7 @@ void FileOperations::deleteFiles(FilePanel* panel, QWidget* parent)
     dsk_tools::fileSystem* filesystem = panel->getFileSystem();
     if (!filesystem) return;
 
-    dsk_tools::Files files = panel->getSelectedFiles();
+    const FileHandles files = panel->getSelectedFiles();
     panel->storeTableState();
     if (!files.empty()) {
         const QMessageBox::StandardButton reply_all = QMessageBox::question(parent,
@@ -320,7 +367,8 @@ void FileOperations::deleteFiles(FilePanel* panel, QWidget* parent)
         );
         if (reply_all == QMessageBox::Yes) {
             bool recursively = false;
-            foreach (const dsk_tools::UniversalFile & f, files) {
+            for (const FileHandle & handle : files) {
+                const dsk_tools::UniversalFile & f = *handle;
                 if (f.is_dir) {
                     if (!recursively) {
                         const QMessageBox::StandardButton reply_dir = QMessageBox::question(parent,
@@ -460,7 +508,7 @@ void FileOperations::renameFile(FilePanel* panel, QWidget* parent)
     dsk_tools::fileSystem* filesystem = panel->getFileSystem();
     if (!filesystem) return;
 
-    const dsk_tools::Files files = panel->getSelectedFiles();
+    const FileHandles files = panel->getSelectedFiles();
 
     // Rename only works on single files
     if (files.size() != 1) {
@@ -470,7 +518,7 @@ void FileOperations::renameFile(FilePanel* panel, QWidget* parent)
         return;
     }
 
-    const dsk_tools::UniversalFile & file = files[0];
+    const dsk_tools::UniversalFile & file = *files[0];
 
     // Don't allow renaming parent directory entry
     if (file.name == "..") {
@@ -572,28 +620,8 @@ void FileOperations::saveImageWithBackup(FilePanel* panel)
         if (use_backups) {
             const QString qfile_name = QString::fromStdString(file_name);
             if (QFile::exists(qfile_name)) {
-                const QFileInfo fileInfo(qfile_name);
-                const QString baseName = fileInfo.completeBaseName();
-                const QString suffix = fileInfo.suffix();
-                const QString dirPath = fileInfo.absolutePath();
-
-                // Find first available backup number
-                int backupNum = 1;
-                QString backupName;
-                while (true) {
-                    backupName = dirPath + "/" + baseName + "." + QString::number(backupNum);
-                    if (!suffix.isEmpty()) {
-                        backupName += "." + suffix;
-                    }
-
-                    if (!QFile::exists(backupName)) {
-                        break;
-                    }
-                    backupNum++;
-                }
-
                 // Rename old file to backup
-                QFile::rename(qfile_name, backupName);
+                QFile::rename(qfile_name, ImageUtils::backupFileName(qfile_name));
             }
         }
         auto writer = dsk_tools::make_unique<dsk_tools::WriterRAW>(current_format_id, image);
@@ -636,17 +664,8 @@ void FileOperations::saveImageAs(FilePanel* panel, QWidget* parent)
                         panel->currentDir()
     );
     if (dialog.exec(target_id, output_file, template_file, numtracks, volume_id) == QDialog::Accepted) {
-        std::unique_ptr<dsk_tools::Writer> writer;
-
-        std::set<QString> mfm_formats = {"FILE_HXC_MFM", "FILE_MFM_NIB", "FILE_MFM_NIC"};
-
-        if (mfm_formats.find(target_id) != mfm_formats.end()) {
-            writer = dsk_tools::make_unique<dsk_tools::WriterHxCMFM>(target_id.toStdString(), image, volume_id);
-        } else if (target_id == "FILE_HXC_HFE") {
-            writer = dsk_tools::make_unique<dsk_tools::WriterHxCHFE>(target_id.toStdString(), image, volume_id);
-        } else if (target_id == "FILE_RAW_MSB") {
-            writer = dsk_tools::make_unique<dsk_tools::WriterRAW>(target_id.toStdString(), image);
-        } else {
+        const std::unique_ptr<dsk_tools::Writer> writer = ImageUtils::createWriter(target_id, image, volume_id);
+        if (!writer) {
             QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Not implemented!"));
             return;
         }
@@ -660,29 +679,18 @@ void FileOperations::saveImageAs(FilePanel* panel, QWidget* parent)
         }
 
         if (numtracks > 0) {
-            dsk_tools::BYTES tmplt;
-
-            UTF8_ifstream tf(template_file.toStdString(), std::ios::binary);
-            if (!tf.good()) {
-                QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Error opening template file"));
-                return;
-            }
-            tf.seekg(0, std::ios::end);
-            auto tfsize = tf.tellg();
-            tf.seekg(0, std::ios::beg);
-            tmplt.resize(tfsize);
-            tf.read(reinterpret_cast<char*>(tmplt.data()), tfsize);
-            if (!tf.good()) {
-                QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Error reading template file"));
-                return;
-            }
-
-            result = writer->substitute_tracks(buffer, tmplt, numtracks);
+            std::shared_ptr<const TrackTemplate> tmplt;
+            result = TrackTemplate::load(template_file.toStdString(), target_id.toStdString(), tmplt);
+            if (result) result = tmplt->apply(*writer, buffer, numtracks);
             if (!result) {
                 if (result.code == dsk_tools::ErrorCode::WriteIncorrectTemplate)
                     QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("The selected template cannot be used - it must be the same type and size as the target."));
                 else if (result.code == dsk_tools::ErrorCode::WriteIncorrectSource)
                     QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Incorrect source data for tracks replacement."));
+                else if (result.code == dsk_tools::ErrorCode::FileNotFound)
+                    QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Error opening template file"));
+                else if (result.code == dsk_tools::ErrorCode::ReadError)
+                    QMessageBox::critical(parent, FilePanel::tr("Error"), FilePanel::tr("Error reading template file"));
                 else
                     QMessageBox::critical(parent, FilePanel::tr("Error"), FileOperations::decodeError(result));
                 return;
@@ -710,120 +718,7 @@ void FileOperations::saveImageAs(FilePanel* panel, QWidget* parent)
 
 QString FileOperations::decodeError(const dsk_tools::Result& result)
 {
-    QString error;
-    switch (result.code) {
-        case dsk_tools::ErrorCode::Ok:
-            error = QCoreApplication::translate("FilePanel", "No error");
-            break;
-        case dsk_tools::ErrorCode::NotImplementedYet:
-            error = QCoreApplication::translate("FilePanel", "Not implemented yet");
-            break;
-        case dsk_tools::ErrorCode::NotFound:
-            error = QCoreApplication::translate("FilePanel", "Item not found");
-            break;
-        case dsk_tools::ErrorCode::LoadError:
-            error = QCoreApplication::translate("FilePanel", "Error loading disk image file");
-            break;
-        case dsk_tools::ErrorCode::LoadSizeMismatch:
-            error = QCoreApplication::translate("FilePanel", "File size does not match expected disk image size");
-            break;
-        case dsk_tools::ErrorCode::LoadParamsMismatch:
-            error = QCoreApplication::translate("FilePanel", "File parameters do not match disk image parameters");
-            break;
-        case dsk_tools::ErrorCode::LoadIncorrectFile:
-            error = QCoreApplication::translate("FilePanel", "File format is not recognized");
-            break;
-        case dsk_tools::ErrorCode::LoadDataCorrupt:
-            error = QCoreApplication::translate("FilePanel", "Disk image data is corrupted");
-            break;
-        case dsk_tools::ErrorCode::OpenNotLoaded:
-            error = QCoreApplication::translate("FilePanel", "Image file is not loaded");
-            break;
-        case dsk_tools::ErrorCode::OpenBadFormat:
-            error = QCoreApplication::translate("FilePanel", "Unrecognized disk format or disk is damaged");
-            break;
-        case dsk_tools::ErrorCode::CreateError:
-            error = QCoreApplication::translate("FilePanel", "Error creating file");
-            break;
-        case dsk_tools::ErrorCode::WriteError:
-            error = QCoreApplication::translate("FilePanel", "Error writing file");
-            break;
-        case dsk_tools::ErrorCode::WriteUnsupported:
-            error = QCoreApplication::translate("FilePanel", "Writing to this format is not supported");
-            break;
-        case dsk_tools::ErrorCode::WriteIncorrectTemplate:
-            error = QCoreApplication::translate("FilePanel", "The selected template cannot be used - it must be the same type and size as the target");
-            break;
-        case dsk_tools::ErrorCode::WriteIncorrectSource:
-            error = QCoreApplication::translate("FilePanel", "Incorrect source data for tracks replacement");
-            break;
-        case dsk_tools::ErrorCode::DirError:
-            error = QCoreApplication::translate("FilePanel", "Error creating a directory");
-            break;
-        case dsk_tools::ErrorCode::DirErrorSpace:
-            error = QCoreApplication::translate("FilePanel", "No enough free space");
-            break;
-        case dsk_tools::ErrorCode::DirErrorAllocateDirEntry:
-            error = QCoreApplication::translate("FilePanel", "Can't allocate a directory entry");
-            break;
-        case dsk_tools::ErrorCode::DirErrorAllocateSector:
-            error = QCoreApplication::translate("FilePanel", "Can't allocate a sector");
-            break;
-        case dsk_tools::ErrorCode::DirNotEmpty:
-            error = QCoreApplication::translate("FilePanel", "Directory is not empty");
-            break;
-        case dsk_tools::ErrorCode::FileDeleteError:
-            error = QCoreApplication::translate("FilePanel", "Error deleting file");
-            break;
-        case dsk_tools::ErrorCode::FileAddError:
-            error = QCoreApplication::translate("FilePanel", "Error adding file");
-            break;
-        case dsk_tools::ErrorCode::FileAddErrorAllocateDirEntry:
-            error = QCoreApplication::translate("FilePanel", "Can't allocate a directory entry");
-            break;
-        case dsk_tools::ErrorCode::FileAddErrorAllocateSector:
-            error = QCoreApplication::translate("FilePanel", "Can't allocate a sector");
-            break;
-        case dsk_tools::ErrorCode::FileAddErrorSpace:
-            error = QCoreApplication::translate("FilePanel", "No enough free space");
-            break;
-        case dsk_tools::ErrorCode::FileRenameError:
-            error = QCoreApplication::translate("FilePanel", "Error renaming file");
-            break;
-        case dsk_tools::ErrorCode::FileIncorrectFS:
-            error = QCoreApplication::translate("FilePanel", "File is not compatible with this filesystem");
-            break;
-        case dsk_tools::ErrorCode::ReadError:
-            error = QCoreApplication::translate("FilePanel", "Error reading file");
-            break;
-        case dsk_tools::ErrorCode::FileNotFound:
-            error = QCoreApplication::translate("FilePanel", "File not found");
-            break;
-        case dsk_tools::ErrorCode::FileAlreadyExists:
-            error = QCoreApplication::translate("FilePanel", "File already exists");
-            break;
-        case dsk_tools::ErrorCode::DirAlreadyExists:
-            error = QCoreApplication::translate("FilePanel", "Directory already exists");
-            break;
-        case dsk_tools::ErrorCode::InvalidName:
-            error = QCoreApplication::translate("FilePanel", "Invalid name");
-            break;
-        case dsk_tools::ErrorCode::DetectError:
-            error = QCoreApplication::translate("FilePanel", "Error detecting disk image format");
-            break;
-        case dsk_tools::ErrorCode::FileMetadataError:
-            error = QCoreApplication::translate("FilePanel", "File metadata error");
-            break;
-        default:
-            error = QCoreApplication::translate("FilePanel", "Unknown error");
-            break;
-    }
-
-    if (!result.message.empty()) {
-        error += ": " + QString::fromStdString(result.message);
-    }
-
-    return error;
+    return ErrorText::decode(result);
 }
 
 void FileOperations::showInfoDialog(const std::string& info, const QString& title, QWidget* parent)
@@ -851,14 +746,15 @@ void FileOperations::showInfoDialog(const std::string& info, const QString& titl
     delete file_info;
 }
 
-void FileOperations::putFiles(FilePanel* source, FilePanel* target, QWidget* parent, const dsk_tools::Files & files, const QString & format, const int recursion)
+void FileOperations::putFiles(FilePanel* source, FilePanel* target, QWidget* parent, const FileHandles & files, const QString & format, const int recursion)
 {
     dsk_tools::fileSystem* sourceFs = source->getFileSystem();
     dsk_tools::fileSystem* targetFs = target->getFileSystem();
 
     if (!sourceFs || !targetFs || !target->allowPutFiles() || recursion > 10) return;
     const std::string std_format = format.toStdString();
-    foreach (const dsk_tools::UniversalFile & f, files) {
+    for (const FileHandle & handle : files) {
+        const dsk_tools::UniversalFile & f = *handle;
         if (f.is_dir) {
             if (f.name != "..") {
                 dsk_tools::UniversalFile new_dir;
@@ -872,7 +768,7 @@ void FileOperations::putFiles(FilePanel* source, FilePanel* target, QWidget* par
 
                     // Putting files
                     targetFs->cd(new_dir);
-                    putFiles(source, target, parent, dir_files, format, recursion+1);
+                    putFiles(source, target, parent, makeHandles(makeListing(std::move(dir_files))), format, recursion+1);
 
                     // Both return
                     sourceFs->cd_up();
@@ -951,7 +847,7 @@ void FileOperations::restoreFiles(FilePanel* panel, QWidget* parent)
     dsk_tools::fileSystem* fs = panel->getFileSystem();
     if (!fs) return;
 
-    dsk_tools::Files files = panel->getSelectedFiles();
+    const FileHandles files = panel->getSelectedFiles();
     panel->storeTableState();
     if (!files.empty()) {
         const QMessageBox::StandardButton reply_all = QMessageBox::question(parent,
@@ -960,8 +856,8 @@ void FileOperations::restoreFiles(FilePanel* panel, QWidget* parent)
                             QMessageBox::Yes|QMessageBox::No
         );
         if (reply_all == QMessageBox::Yes) {
-            foreach (const dsk_tools::UniversalFile & f, files) {
-                fs->restore_file(f);
+            for (const FileHandle & f : files) {
+                fs->restore_file(*f);
             }
             panel->refresh();
             panel->restoreTableState();
@@ -8,6 +8,7 @@
 #include <QWidget>
 #include <QSettings>
 #include "dsk_tools/dsk_tools.h"
+#include "FileHandle.h"
 
 class FilePanel;
 
@@ -17,6 +18,9 @@ public:
     static void editFile(FilePanel* panel, QWidget* parent);
     static void viewFileInfo(FilePanel* panel, QWidget* parent);
     static void viewFilesystemInfo(FilePanel* panel, QWidget* parent);
+    static void viewSectors(FilePanel* panel, QWidget* parent);
+    static void viewGallery(FilePanel* panel, QWidget* parent);
+    static void compareImages(FilePanel* left, FilePanel* right, QWidget* parent);
     static void copyFiles(FilePanel* source, FilePanel* target, QWidget* parent);
     static void deleteFiles(FilePanel* panel, QWidget* parent);
     static void restoreFiles(FilePanel* panel, QWidget* parent);
@@ -25,6 +29,7 @@ public:
     static void saveImage(FilePanel* panel, QWidget* parent);
     static void saveImageAs(FilePanel* panel, QWidget* parent);
 
+    // The same as ErrorText::decode(), kept for the dialogs
     static QString decodeError(const dsk_tools::Result& result);
     static void openItem(FilePanel* panel, QWidget* parent, const QModelIndex& index);
 
@@ -33,6 +38,6 @@ public:
 private:
     static void showInfoDialog(const std::string& info, const QString& title, QWidget* parent);
     static void deleteRecursively(FilePanel* panel, QWidget* parent, const dsk_tools::UniversalFile & f);
-    static void putFiles(FilePanel* source, FilePanel* target, QWidget* parent, const dsk_tools::Files & files, const QString & format, int recursion);
+    static void putFiles(FilePanel* source, FilePanel* target, QWidget* parent, const FileHandles & files, const QString & format, int recursion);
     static void saveImageWithBackup(FilePanel* panel);
 };
\ No newline at end of file
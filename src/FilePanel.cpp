@@ -262,7 +262,15 @@ void FilePanel::setupPanel() {
     // Model for the file system
     host_model = new HostModel(this);
 
-    image_model = new QStandardItemModel(this);
+    image_model = new ImageModel(this);
+
+    // Any change of the rows makes the name index stale
+    for (QAbstractItemModel * model : {static_cast<QAbstractItemModel*>(host_model), static_cast<QAbstractItemModel*>(image_model)}) {
+        connect(model, &QAbstractItemModel::modelReset, this, [this]() { m_name_rows_valid = false; });
+        connect(model, &QAbstractItemModel::rowsInserted, this, [this]() { m_name_rows_valid = false; });
+        connect(model, &QAbstractItemModel::rowsRemoved, this, [this]() { m_name_rows_valid = false; });
+        connect(model, &QAbstractItemModel::layoutChanged, this, [this]() { m_name_rows_valid = false; });
+    }
 
     // Upper tooldar
     topToolBar = new QToolBar(this);
@@ -502,6 +510,9 @@ void FilePanel::retranslateUi()
         host_model->setHorizontalHeaderItem(2, new QStandardItem(tr("Date")));
     }
 
+    // ImageModel translates its headers when asked
+    if (image_model) emit image_model->headerDataChanged(Qt::Horizontal, 0, image_model->columnCount() - 1);
+
     // Retranslate toolbar elements
     upButton->setToolTip(tr("Up"));
     dirButton->setToolTip(tr("Choose..."));
@@ -798,7 +809,7 @@ dsk_tools::Result FilePanel::openImage(QString path)
 
     // Load file
 
-    image_model->removeRows(0, image_model->rowCount());
+    image_model->setListing(makeListing(dsk_tools::Files()), std::vector<uint32_t>());
 
     m_image = dsk_tools::prepare_image(file_name, format_id, type_id);
 
@@ -856,6 +867,7 @@ void FilePanel::processImage(const std::string &filesystem_type)
 void FilePanel::setMode(panelMode new_mode)
 {
     mode = new_mode;
+    m_name_rows_valid = false;
 
     // Update toolbar widget visibility based on mode
     updateToolbarVisibility();
@@ -870,6 +882,7 @@ void FilePanel::setMode(panelMode new_mode)
         tableView->setupForHostMode();
         m_filesystem = dsk_tools::make_unique<dsk_tools::fsHost>(nullptr);
     } else {
+        image_model->setCaps(m_filesystem->get_caps());
         tableView->setModel(image_model);
         tableView->setupForImageMode(m_filesystem->get_caps());
     }
@@ -909,54 +922,6 @@ void FilePanel::updateToolbarVisibility() const
 
 void FilePanel::updateTable()
 {
-    const dsk_tools::FSCaps funcs = m_filesystem->get_caps();
-
-    image_model->removeRows(0, image_model->rowCount());
-
-    foreach (const dsk_tools::UniversalFile & f, m_files) {
-        QList<QStandardItem*> items;
-
-        if (dsk_tools::hasFlag(funcs, dsk_tools::FSCaps::Protect)) {
-            auto * protect_item = new QStandardItem();
-            protect_item->setText((f.is_protected)?"*":"");
-            protect_item->setTextAlignment(Qt::AlignCenter);
-            items.append(protect_item);
-        }
-
-        if (dsk_tools::hasFlag(funcs, dsk_tools::FSCaps::Types)) {
-            auto * type_item = new QStandardItem();
-            type_item->setText(QString::fromStdString(f.type_label));
-            type_item->setTextAlignment(Qt::AlignCenter);
-            items.append(type_item);
-        }
-
-        QString file_name = QString::fromStdString(f.name);
-
-        auto * size_item = new QStandardItem();
-        size_item->setText((file_name != "..")?HostModel::formatSize(f.size):"");
-        size_item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        items.append(size_item);
-
-        QStandardItem *nameItem;
-        if (f.is_dir) {
-            nameItem = new QStandardItem("[" + file_name + "]");
-            QFont dirFont;
-            dirFont.setBold(true);
-            if (f.is_deleted) dirFont.setStrikeOut(true);
-            nameItem->setFont(dirFont);
-        } else {
-            nameItem = new QStandardItem(file_name);
-            if (f.is_deleted) {
-                QFont fileFont;
-                fileFont.setStrikeOut(true);
-                nameItem->setFont(fileFont);
-            }
-        }
-        items.append(nameItem);
-        image_model->appendRow( items );
-    }
-
-
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
     for (int row = 0; row < tableView->model()->rowCount(); ++row) {
         tableView->setRowHeight(row, 24);
@@ -988,41 +953,41 @@ void FilePanel::dir()
         QMessageBox::critical(this, FilePanel::tr("Error"), FilePanel::tr("Error reading files list!"));
     }
 
-    m_files.clear();
-    if (getSortOrder() != HostModel::SortOrder::NoOrder) {
-        // Separate directories and files
-        dsk_tools::Files dirs_only;
-        dsk_tools::Files files_only;
+    // Entries are never copied: the list is taken over and sorted by indices.
+    // Handles given out keep their listing after the directory is read again.
+    const FileListing listing = makeListing(std::move(files));
+    image_model->setListing(listing, sortFiles(*listing));
+    updateTable();
+}
 
-        for (const dsk_tools::UniversalFile& f : files) {
-            if (f.is_dir) {
-                dirs_only.push_back(f);
-            } else {
-                files_only.push_back(f);
-            }
-        }
+std::vector<uint32_t> FilePanel::sortFiles(const dsk_tools::Files & files) const
+{
+    std::vector<uint32_t> order(files.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<uint32_t>(i);
 
-        // Sort directories and files separately
-        auto sortByName = [this](const dsk_tools::UniversalFile& a, const dsk_tools::UniversalFile& b) {
-            return m_sort_ascending? a.name<b.name : a.name>b.name;
-        };
-        auto sortBySize = [this](const dsk_tools::UniversalFile& a, const dsk_tools::UniversalFile& b) {
-            return m_sort_ascending? a.size<b.size : a.size>b.size;
-        };
+    // [..] is always the first row, the table looks for it only there
+    const auto entries_begin = std::stable_partition(order.begin(), order.end(),
+                                                     [&files](uint32_t i) { return files[i].name == ".."; });
+    if (getSortOrder() == HostModel::SortOrder::NoOrder) return order;
 
-        if (getSortOrder() == HostModel::SortOrder::ByName) {
-            std::sort(dirs_only.begin(), dirs_only.end(), sortByName);
-            std::sort(files_only.begin(), files_only.end(), sortByName);
-        } else {
-            std::sort(dirs_only.begin(), dirs_only.end(), sortByName);  // Dirs still by name
-            std::sort(files_only.begin(), files_only.end(), sortBySize);
-        }
-        m_files.insert(m_files.end(), dirs_only.begin(), dirs_only.end());
-        m_files.insert(m_files.end(), files_only.begin(), files_only.end());
-    }  else {
-        m_files = files;
-    }
-    updateTable();
+    // Directories go first and are always sorted by name
+    const auto files_begin = std::stable_partition(entries_begin, order.end(),
+                                                   [&files](uint32_t i) { return files[i].is_dir; });
+
+    const bool ascending = m_sort_ascending;
+    auto sortByName = [&files, ascending](uint32_t a, uint32_t b) {
+        return ascending? files[a].name<files[b].name : files[a].name>files[b].name;
+    };
+    auto sortBySize = [&files, ascending](uint32_t a, uint32_t b) {
+        return ascending? files[a].size<files[b].size : files[a].size>files[b].size;
+    };
+
+    std::sort(entries_begin, files_begin, sortByName);
+    if (getSortOrder() == HostModel::SortOrder::ByName)
+        std::sort(files_begin, order.end(), sortByName);
+    else
+        std::sort(files_begin, order.end(), sortBySize);
+    return order;
 }
 
 QStringList FilePanel::selectedPaths() const {
@@ -1119,7 +1084,10 @@ void FilePanel::setSortOrder(HostModel::SortOrder order)
     if (mode == panelMode::Host && host_model) {
         host_model->setSortOrder(order, m_sort_ascending);
     } else {
-        dir();
+        // The files are already read, only the rows are reordered
+        const FileListing listing = image_model->listing();
+        image_model->setListing(listing, sortFiles(*listing));
+        updateTable();
     }
     emit sortOrderChanged(order);
  }
@@ -1145,10 +1113,11 @@ bool FilePanel::allowPutFiles() const {
     return getMode() == panelMode::Host || dsk_tools::hasFlag(m_filesystem->get_caps(), dsk_tools::FSCaps::Add);
 }
 
-dsk_tools::Files FilePanel::getSelectedFiles() const {
-    dsk_tools::Files files;
+FileHandles FilePanel::getSelectedFiles() const {
+    FileHandles handles;
 
     if (mode == panelMode::Host) {
+        dsk_tools::Files files;
         QStringList paths = selectedPaths();
         foreach (const QString & path, paths) {
             QFileInfo fi(path);
@@ -1171,24 +1140,26 @@ dsk_tools::Files FilePanel::getSelectedFiles() const {
             f.metadata = dsk_tools::strToBytes(_toStdString(path));
             files.push_back(f);
         }
+        handles = makeHandles(makeListing(std::move(files)));
     } else {
         QItemSelectionModel * selection = tableView->selectionModel();
         if (selection->hasSelection()) {
             QModelIndexList rows = selection->selectedRows();
             if (!rows.empty()) {
+                handles.reserve(rows.size());
                 for (auto index : rows) {
-                    files.push_back(m_files[index.row()]);
+                    handles.push_back(fileHandle(index.row()));
                 }
             }
         } else {
             QModelIndex index = tableView->currentIndex();
             if (index.isValid()) {
-                files.push_back(m_files[index.row()]);
+                handles.push_back(fileHandle(index.row()));
             }
         }
     }
 
-    return files;
+    return handles;
 }
 
 void FilePanel::saveImage()
@@ -1320,15 +1291,17 @@ void FilePanel::storeTableState()
     // qDebug() << "storeTableState";
     if (!tableView) return;
 
-    // Store current row index
+    // Store current row index and the entry in it
     const QModelIndex currentIdx = tableView->currentIndex();
     const int row = currentIdx.isValid() ? currentIdx.row() : 0;
+    const QString name = currentIdx.isValid() ? nameOfRow(row) : QString();
+    const QByteArray id = currentIdx.isValid() ? idOfRow(row) : QByteArray();
 
     // Store vertical scroll bar position
     const int scroll = tableView->verticalScrollBar() ? tableView->verticalScrollBar()->value() : 0;
 
     // Push state onto the stack
-    m_tableStateStack.push_back({row, scroll});
+    m_tableStateStack.push_back({row, scroll, name, id});
 }
 
 void FilePanel::restoreTableState()
@@ -1338,15 +1311,20 @@ void FilePanel::restoreTableState()
     if (!tableView || !tableView->model() || m_tableStateStack.empty()) return;
 
     // Pop state from the stack
-    const auto savedState = m_tableStateStack.back();
-    const int savedRow = savedState.first;
-    const int savedScroll = savedState.second;
+    const TableState savedState = m_tableStateStack.back();
+    const int savedScroll = savedState.scroll;
     m_tableStateStack.pop_back();
 
-    // Restore current row if valid
+    // The same row if it still holds the entry, else the row the entry moved to,
+    // else the same row number if the entry is gone
     const int maxRow = tableView->model()->rowCount() - 1;
     if (maxRow >= 0) {
-        const int rowToRestore = std::min(savedRow, maxRow);
+        int rowToRestore = -1;
+        if (savedState.row <= maxRow && !savedState.name.isEmpty() && nameOfRow(savedState.row) == savedState.name)
+            rowToRestore = savedState.row;
+        else if (!savedState.id.isEmpty())
+            rowToRestore = rowOfId(savedState.id);
+        if (rowToRestore < 0) rowToRestore = std::min(savedState.row, maxRow);
         const QModelIndex index = tableView->model()->index(rowToRestore, 0);
         if (index.isValid()) {
             tableView->selectionModel()->clearSelection();
@@ -1371,33 +1349,69 @@ void FilePanel::highlight(const QString& title)
 {
     if (!tableView || !tableView->model()) return;
 
-    const auto model = qobject_cast<QStandardItemModel*>(tableView->model());
-    if (!model) return;
-
-    // The first one for host and the last one for image
-    const int column = getMode()==panelMode::Host ? 0 : model->columnCount() - 1;
+    const QAbstractItemModel * model = tableView->model();
+    const int row = rowOfName(title);
+    if (row < 0) return;
 
-    // Search through all rows to find a matching title
-    for (int row = 0; row < model->rowCount(); ++row) {
-        // Get the last item in the row (which is always the name item)
-        const auto nameItem = model->item(row, column);
-        if (!nameItem) continue;
+    const QModelIndex index = model->index(row, model->columnCount() - 1);
+    if (index.isValid())
+        tableView->selectionModel()->setCurrentIndex(index, QItemSelectionModel::NoUpdate);
+}
 
-        QString itemText = nameItem->text();
+QString FilePanel::nameOfRow(int row) const
+{
+    // Plain names, without the brackets of directories; [..] has none
+    if (mode == panelMode::Host) {
+        const QString path = host_model->filePath(host_model->index(row, 0));
+        return path.isEmpty() ? QString() : QFileInfo(path).fileName();
+    }
+    return (row >= 0 && row < image_model->rowCount()) ? QString::fromStdString(fileAt(row).name) : QString();
+}
 
-        // For image mode, directories have brackets like "[dirname]"
-        // For comparing, we need to handle both plain names and bracketed names
-        const QString bracketedTitle = "[" + title + "]";
+QByteArray FilePanel::idOfRow(int row) const
+{
+    // Host names are unique within a directory. In images the name is joined by the deleted flag
+    // and the metadata, where file systems keep the location of the directory entry.
+    if (mode == panelMode::Host) return nameOfRow(row).toUtf8();
+    if (row < 0 || row >= image_model->rowCount()) return QByteArray();
+
+    const dsk_tools::UniversalFile & f = fileAt(row);
+    QByteArray id = QByteArray::fromStdString(f.name);
+    id += '\0';
+    id += f.is_deleted ? 'D' : (f.is_dir ? 'd' : 'f');
+    id += '\0';
+    id += QByteArray(reinterpret_cast<const char *>(f.metadata.data()), static_cast<int>(f.metadata.size()));
+    return id;
+}
 
-        if (itemText == title || itemText == bracketedTitle) {
-            // Found a match, set it as current
-            const QModelIndex index = model->index(row, model->columnCount() - 1);
-            if (index.isValid()) {
-                tableView->selectionModel()->setCurrentIndex(index, QItemSelectionModel::NoUpdate);
-                return;
-            }
-        }
+void FilePanel::indexRows()
+{
+    if (m_name_rows_valid) return;
+    m_name_rows.clear();
+    m_id_rows.clear();
+    const int rows = (mode == panelMode::Host) ? host_model->rowCount() : image_model->rowCount();
+    m_name_rows.reserve(rows);
+    m_id_rows.reserve(rows);
+    // The first of equal keys wins, as with a scan from the top
+    for (int row = rows - 1; row >= 0; --row) {
+        const QString name = nameOfRow(row);
+        if (name.isEmpty()) continue;
+        m_name_rows.insert(name, row);
+        m_id_rows.insert(idOfRow(row), row);
     }
+    m_name_rows_valid = true;
+}
+
+int FilePanel::rowOfName(const QString& name)
+{
+    indexRows();
+    return m_name_rows.value(name, -1);
+}
+
+int FilePanel::rowOfId(const QByteArray& id)
+{
+    indexRows();
+    return m_id_rows.value(id, -1);
 }
 
 void FilePanel::clearSelection() const {
@@ -14,9 +14,12 @@
 #include <QMenu>
 #include <QDir>
 #include <QSettings>
+#include <QHash>
 #include <QStandardItemModel>
 
 #include "FileTable.h"
+#include "ImageModel.h"
+#include "FileHandle.h"
 #include "dsk_tools/dsk_tools.h"
 
 enum class panelMode {Host, Image};
@@ -99,7 +102,7 @@ public:
     int selectedCount() const;
     bool isIndexValid() const;
     bool allowPutFiles() const;
-    dsk_tools::Files getSelectedFiles() const;
+    FileHandles getSelectedFiles() const;
     // void putFiles(dsk_tools::fileSystem* sourceFs, const dsk_tools::Files & files, const QString & format, const bool copy);
 
     // Panel operations
@@ -112,7 +115,8 @@ public:
 
     QString getSelectedFormat() const;
     QString getSelectedType() const;
-    dsk_tools::Files& getFiles() {return m_files;};
+    const dsk_tools::UniversalFile& fileAt(int row) const {return image_model->fileAt(row);};
+    FileHandle fileHandle(int row) const {return image_model->fileHandle(row);};
     dsk_tools::fileSystem* getFileSytem() {return m_filesystem.get();};
     QSettings* getSettings() {return (m_settings);};
     QModelIndex getCurrentIndex() const {return tableView->currentIndex();};
@@ -122,6 +126,7 @@ public:
     const QJsonObject* getFileTypes() {return &m_file_types;};
     const QJsonObject* getFileSystems() {return &m_file_systems;};
     std::string getLoadedFormat() {return m_current_format_id;};
+    std::string getLoadedFileSystem() {return m_current_filesystem_id;};
 
 
     void dir();
@@ -170,7 +175,7 @@ private:
     QToolButton* saveAsButton {nullptr};  // Save As button (Image mode only)
     QMenu* historyMenu {nullptr};
     HostModel * host_model {nullptr};
-    QStandardItemModel * image_model {nullptr};
+    ImageModel * image_model {nullptr};
     QStringList m_directoryHistory;
 
     QString currentPath;
@@ -192,12 +197,28 @@ private:
     std::string m_current_type_id;        // Disk type: "TYPE_AGAT_140", "TYPE_AGAT_840", etc.
     std::string m_current_filesystem_id;  // Filesystem: "FS_DOS33", "FS_SPRITEOS", "FS_CPM", etc.
 
-    std::vector<dsk_tools::UniversalFile> m_files;
     HostModel::SortOrder m_sort_order {HostModel::SortOrder::NoOrder};
     bool m_sort_ascending {true};
 
     // Table state storage stack (for preserving position during nested updates)
-    std::vector<std::pair<int, int>> m_tableStateStack;  // Stack of (row, scroll) pairs
+    struct TableState {
+        int row;
+        int scroll;
+        QString name;               // The current entry
+        QByteArray id;              // Its identity, found again even if rows moved
+    };
+    std::vector<TableState> m_tableStateStack;
+
+    // Name -> row and identity -> row in the current model, rebuilt on first use after the rows change.
+    // Names may repeat in images (a deleted entry next to a live one), identities tell them apart.
+    QHash<QString, int> m_name_rows;
+    QHash<QByteArray, int> m_id_rows;
+    bool m_name_rows_valid {false};
+    void indexRows();
+    int rowOfName(const QString& name);
+    int rowOfId(const QByteArray& id);
+    QString nameOfRow(int row) const;
+    QByteArray idOfRow(int row) const;
 
     void setupPanel();
     void setupFilters();
@@ -207,6 +228,7 @@ private:
     static void setComboBoxByItemData(QComboBox* comboBox, const QVariant& value);
     void processImage(const std::string &filesystem_type);
     void updateTable();
+    std::vector<uint32_t> sortFiles(const dsk_tools::Files & files) const;
     void setMode(panelMode new_mode);
     void updateToolbarVisibility() const;
 
@@ -3,6 +3,8 @@
 // Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
 // Description: Custom table view for file panel
 
+#include <algorithm>
+
 #include <QEvent>
 #include <QKeyEvent>
 #include <QMouseEvent>
@@ -11,7 +13,6 @@
 #include <QItemSelectionModel>
 #include <QDebug>
 #include <QMessageBox>
-#include <QStandardItemModel>
 
 #include "FileTable.h"
 #include "definitions.h"
@@ -37,26 +38,17 @@
 // CurrentRowDelegate implementation
 // ============================================================================
 
-CurrentRowDelegate::CurrentRowDelegate(QTableView* view, QObject* parent)
+CurrentRowDelegate::CurrentRowDelegate(FileTable* view, QObject* parent)
     : QStyledItemDelegate(parent), m_tableView(view) {
 }
 
 void CurrentRowDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
                                 const QModelIndex& index) const
 {
-    // Get the current index from the table view
-    QModelIndex currentIndex = m_tableView->currentIndex();
-
-    // Check if this cell is in the current row
-    bool isCurrentRow = currentIndex.isValid() &&
-                        index.isValid() &&
-                        (index.row() == currentIndex.row()) &&
-                        (index.parent() == currentIndex.parent());
-
-    // Check if this row is selected
-    bool isSelected = m_tableView->selectionModel() &&
-                      m_tableView->selectionModel()->isRowSelected(index.row(), index.parent());
-
+    // The row state is one lookup, the same for every cell of the row
+    const quint8 state = index.isValid() ? m_tableView->rowState(index.row()) : 0;
+    bool isCurrentRow = (state & FileTable::RowCurrent) != 0;
+    bool isSelected = (state & FileTable::RowSelected) != 0;
 
     // Create a modified copy of the style option
     QStyleOptionViewItem opt = option;
@@ -68,8 +60,7 @@ void CurrentRowDelegate::paint(QPainter* painter, const QStyleOptionViewItem& op
         painter->save();
 
         // Check if the table is active
-        FileTable* fileTable = qobject_cast<FileTable*>(m_tableView);
-        bool isTableActive = fileTable && fileTable->isActive();
+        bool isTableActive = m_tableView->isActive();
 
         // Background - only show blue highlight for current row if table is active
         if (isCurrentRow && isTableActive) {
@@ -213,6 +204,8 @@ void FileTable::setupForHostMode() {
 
     verticalHeader()->setDefaultSectionSize(24);
 
+    m_nameColumn = 0;
+
     // Reconnect selection model signals (new model was set in FilePanel)
     reconnectSelectionModel();
 
@@ -223,34 +216,13 @@ void FileTable::setupForImageMode(dsk_tools::FSCaps capabilities) {
     setSelectionBehavior(QAbstractItemView::SelectRows);
     setSelectionMode(QAbstractItemView::ExtendedSelection);
 
-    int const_columns = 2;
+    // Headers come from the model, the columns are the same: [P] [T] Size Name
     int columns = 0;
-    auto image_model = dynamic_cast<QStandardItemModel*>(model());
-
-    image_model->clear();
-
-    if (dsk_tools::hasFlag(capabilities, dsk_tools::FSCaps::Protect)) {
-        image_model->setColumnCount(const_columns + columns + 1);
-        image_model->setHeaderData(columns, Qt::Horizontal, FileTable::tr("P"));
-        image_model->horizontalHeaderItem(columns)->setToolTip(FileTable::tr("Protection"));
-        setColumnWidth(columns, 20);
-        columns++;
-    }
-    if (dsk_tools::hasFlag(capabilities, dsk_tools::FSCaps::Types)) {
-        image_model->setColumnCount(const_columns + columns + 1);
-        image_model->setHeaderData(columns, Qt::Horizontal, FileTable::tr("T"));
-        image_model->horizontalHeaderItem(columns)->setToolTip(FileTable::tr("Type"));
-        setColumnWidth(columns, 30);
-        columns++;
-    }
-
-    setColumnWidth(columns, 60);
-    image_model->setHeaderData(columns, Qt::Horizontal, FileTable::tr("Size"));
-    image_model->horizontalHeaderItem(columns++)->setToolTip(FileTable::tr("Size in bytes"));
-
-    setColumnWidth(columns, 230);
-    image_model->setHeaderData(columns, Qt::Horizontal, FileTable::tr("Name"));
-    image_model->horizontalHeaderItem(columns++)->setToolTip(FileTable::tr("Name of the file"));
+    if (dsk_tools::hasFlag(capabilities, dsk_tools::FSCaps::Protect)) setColumnWidth(columns++, 20);
+    if (dsk_tools::hasFlag(capabilities, dsk_tools::FSCaps::Types)) setColumnWidth(columns++, 30);
+    setColumnWidth(columns++, 60);
+    setColumnWidth(columns++, 230);
+    m_nameColumn = columns - 1;
 
     verticalHeader()->setDefaultSectionSize(8);
     horizontalHeader()->setMinimumSectionSize(20);
@@ -590,13 +562,7 @@ bool FileTable::handleArrowKeys(QKeyEvent* keyEvent) {
 }
 
 bool FileTable::isParentDirEntry(int row) const {
-    if (!model()) return false;
-
-    QModelIndex idx = model()->index(row, 0, rootIndex());
-    if (!idx.isValid()) return false;
-
-    QString displayText = idx.data(Qt::DisplayRole).toString();
-    return (displayText == "[..]" || displayText == "<..>");
+    return (rowState(row) & RowParentDir) != 0;
 }
 
 bool FileTable::handleSelectionKeys(QKeyEvent* keyEvent) {
@@ -714,6 +680,10 @@ void FileTable::reconnectSelectionModel() {
     if (m_currentIndexChangedConnection) {
         disconnect(m_currentIndexChangedConnection);
     }
+    for (const QMetaObject::Connection & connection : m_rowStateConnections) {
+        disconnect(connection);
+    }
+    m_rowStateConnections.clear();
 
     // Create new connection and store the handle for future disconnection
     if (selectionModel()) {
@@ -723,6 +693,87 @@ void FileTable::reconnectSelectionModel() {
             this,
             &FileTable::onCurrentIndexChanged
         );
+        m_rowStateConnections.append(connect(selectionModel(), &QItemSelectionModel::selectionChanged,
+                                             this, &FileTable::onSelectionChanged));
+    }
+
+    // Resets and reordering rebuild the states; panels fill the model a row at a time,
+    // so inserted and removed rows only touch their own range
+    if (model()) {
+        m_rowStateConnections.append(connect(model(), &QAbstractItemModel::modelReset, this, &FileTable::rebuildRowStates));
+        m_rowStateConnections.append(connect(model(), &QAbstractItemModel::rowsInserted, this, &FileTable::onRowsInserted));
+        m_rowStateConnections.append(connect(model(), &QAbstractItemModel::rowsRemoved, this, &FileTable::onRowsRemoved));
+        m_rowStateConnections.append(connect(model(), &QAbstractItemModel::layoutChanged, this, &FileTable::rebuildRowStates));
+    }
+    rebuildRowStates();
+}
+
+void FileTable::rebuildRowStates()
+{
+    const int rows = model() ? model()->rowCount(rootIndex()) : 0;
+    m_rowStates.assign(rows, 0);
+
+    // Panels put [..] first, so only the first row is asked for its name
+    if (rows > 0) m_rowStates[0] = parentDirState(0);
+
+    if (selectionModel()) {
+        const QItemSelection selection = selectionModel()->selection();
+        onSelectionChanged(selection, QItemSelection());
+        const QModelIndex current = currentIndex();
+        if (current.isValid() && current.row() < rows) m_rowStates[current.row()] |= RowCurrent;
+    }
+}
+
+quint8 FileTable::parentDirState(int row) const
+{
+    const QString text = model()->index(row, m_nameColumn, rootIndex()).data(Qt::DisplayRole).toString();
+    return (text == "[..]" || text == "<..>") ? RowParentDir : 0;
+}
+
+void FileTable::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent != rootIndex()) return;
+    if (first < 0 || first > static_cast<int>(m_rowStates.size())) {
+        rebuildRowStates();
+        return;
+    }
+
+    // New rows are neither selected nor current; the selection model moves the others itself
+    m_rowStates.insert(m_rowStates.begin() + first, last - first + 1, 0);
+    if (first == 0) {
+        m_rowStates[0] = parentDirState(0);
+        if (last + 1 < static_cast<int>(m_rowStates.size())) m_rowStates[last + 1] &= ~RowParentDir;
+    }
+}
+
+void FileTable::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent != rootIndex()) return;
+    if (first < 0 || last >= static_cast<int>(m_rowStates.size())) {
+        rebuildRowStates();
+        return;
+    }
+
+    m_rowStates.erase(m_rowStates.begin() + first, m_rowStates.begin() + last + 1);
+
+    // The selection model may move the current index while the rows are removed,
+    // so the flag is put where it ended up
+    const QModelIndex current = currentIndex();
+    for (quint8 & state : m_rowStates) state &= ~RowCurrent;
+    if (current.isValid() && current.row() < static_cast<int>(m_rowStates.size())) m_rowStates[current.row()] |= RowCurrent;
+}
+
+void FileTable::onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    // Rows are selected whole, so every range covers entire rows
+    const int rows = static_cast<int>(m_rowStates.size());
+    for (const QItemSelectionRange & range : deselected) {
+        for (int row = std::max(0, range.top()); row <= std::min(range.bottom(), rows - 1); ++row)
+            m_rowStates[row] &= ~RowSelected;
+    }
+    for (const QItemSelectionRange & range : selected) {
+        for (int row = std::max(0, range.top()); row <= std::min(range.bottom(), rows - 1); ++row)
+            m_rowStates[row] |= RowSelected;
     }
 }
 
@@ -735,6 +786,9 @@ void FileTable::onCurrentIndexChanged(const QModelIndex& current, const QModelIn
     LOG_ACTION(QString("CurrentIndex changed: %1 -> %2").arg(prevRow).arg(currRow));
     logSelectionState(QString("After currentIndex change"));
 
+    if (prevRow >= 0 && prevRow < static_cast<int>(m_rowStates.size())) m_rowStates[prevRow] &= ~RowCurrent;
+    if (currRow >= 0 && currRow < static_cast<int>(m_rowStates.size())) m_rowStates[currRow] |= RowCurrent;
+
     // When the current row changes, we need to repaint both the previous and new current rows
     // to ensure the delegate updates the highlight correctly across all columns
 
@@ -10,6 +10,8 @@
 #include <QPainter>
 #include <QTimer>
 #include <QModelIndex>
+#include <QItemSelection>
+#include <vector>
 
 #include "libs/dsk_tools/src/definitions.h"
 
@@ -17,19 +19,20 @@
 class QEvent;
 class QMouseEvent;
 class QKeyEvent;
+class FileTable;
 
 // Custom delegate for highlighting current row
 class CurrentRowDelegate : public QStyledItemDelegate {
     Q_OBJECT
 
 public:
-    explicit CurrentRowDelegate(QTableView* view, QObject* parent = nullptr);
+    explicit CurrentRowDelegate(FileTable* view, QObject* parent = nullptr);
 
     void paint(QPainter* painter, const QStyleOptionViewItem& option,
                const QModelIndex& index) const override;
 
 private:
-    QTableView* m_tableView;
+    FileTable* m_tableView;
 };
 
 // Custom table view with Norton Commander-style selection behavior
@@ -48,6 +51,17 @@ public:
     void setActive(bool active);
     bool isActive() const { return m_isActive; }
 
+    // Per-row state, kept up to date from the selection model signals,
+    // so painting a cell does not walk the selection ranges
+    enum RowState : quint8 {
+        RowCurrent = 1,
+        RowSelected = 2,
+        RowParentDir = 4
+    };
+    quint8 rowState(int row) const {
+        return (row >= 0 && row < static_cast<int>(m_rowStates.size())) ? m_rowStates[row] : 0;
+    }
+
 signals:
     // Emitted when the view receives focus or is clicked
     void focusReceived();
@@ -65,6 +79,10 @@ protected:
 private slots:
     // Handle current index changes to repaint affected rows
     void onCurrentIndexChanged(const QModelIndex& current, const QModelIndex& previous);
+    void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
+    void rebuildRowStates();
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
 
 private:
     // Timer for distinguishing single-click from double-click
@@ -79,6 +97,11 @@ private:
     // Active state (whether this panel is active)
     bool m_isActive = false;
 
+    // RowState flags by row; "[..]" is looked for in the name column of the first row
+    std::vector<quint8> m_rowStates;
+    int m_nameColumn = 0;
+    quint8 parentDirState(int row) const;
+
     // Helper methods
     void handleMousePress(QMouseEvent* mouseEvent);
     void handleMouseDoubleClick();
@@ -95,5 +118,6 @@ private:
 
     // Signal-slot connection management
     QMetaObject::Connection m_currentIndexChangedConnection;
+    QList<QMetaObject::Connection> m_rowStateConnections;
     void reconnectSelectionModel();
 };
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Background rendering of a full animation cycle of a picture viewer
+
+#include "FrameRing.h"
+
+#include <QRunnable>
+#include <QMetaObject>
+
+namespace {
+
+class FrameRingTask : public QRunnable
+{
+public:
+    FrameRingTask(FrameRing * ring, quint64 generation, const std::shared_ptr<FrameRingJob> & job,
+                  std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data)
+        : m_ring(ring)
+        , m_generation(generation)
+        , m_job(job)
+        , m_viewer(std::move(viewer))
+        , m_data(data)
+    {}
+
+    void run() override
+    {
+        dsk_tools::BYTES first;
+        int first_sx = 0, first_sy = 0;
+        for (int i = 0; i <= FrameRing::MAX_FRAMES; i++) {
+            if (m_job->cancelled.loadAcquire()) return;
+
+            int sx = 0, sy = 0;
+            const dsk_tools::BYTES pixels = m_viewer->process_picture(m_data, sx, sy, i);
+            if (i == 0) {
+                first = pixels;
+                first_sx = sx;
+                first_sy = sy;
+            } else if (sx == first_sx && sy == first_sy && pixels == first) {
+                m_job->periodic = true;
+                break;
+            }
+            if (i == FrameRing::MAX_FRAMES) break;
+
+            // copy() detaches the image from the pixel buffer, which is gone after this iteration
+            m_job->frames.push_back(QImage(pixels.data(), sx, sy, QImage::Format_RGBA8888).copy());
+            m_job->delays.push_back(m_viewer->get_frame_delay());
+        }
+        QMetaObject::invokeMethod(m_ring, "onRendered", Qt::QueuedConnection, Q_ARG(quint64, m_generation));
+    }
+
+private:
+    FrameRing * m_ring;
+    quint64 m_generation;
+    std::shared_ptr<FrameRingJob> m_job;
+    std::unique_ptr<dsk_tools::ViewerPic> m_viewer;
+    dsk_tools::BYTES m_data;
+};
+
+} // namespace
+
+FrameRing::FrameRing(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+FrameRing::~FrameRing()
+{
+    // Queued onRendered() calls die with the object, but the worker must not outlive it
+    clear();
+    m_pool.waitForDone();
+}
+
+void FrameRing::render(std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data)
+{
+    clear();
+    m_job = std::make_shared<FrameRingJob>();
+    m_pool.start(new FrameRingTask(this, ++m_generation, m_job, std::move(viewer), data));
+}
+
+void FrameRing::clear()
+{
+    if (m_job) m_job->cancelled.storeRelease(1);
+    m_job.reset();
+    m_ready = false;
+}
+
+void FrameRing::onRendered(quint64 generation)
+{
+    if (generation != m_generation || !m_job) return;
+    if (m_job->periodic && !m_job->frames.empty()) {
+        m_ready = true;
+        emit ready();
+    }
+}
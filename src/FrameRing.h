@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Background rendering of a full animation cycle of a picture viewer
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QImage>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+#include "dsk_tools/dsk_tools.h"
+
+// Filled by the worker, read by the ring after onRendered()
+struct FrameRingJob {
+    QAtomicInt cancelled;
+    std::vector<QImage> frames;
+    std::vector<int> delays;
+    bool periodic {false};
+};
+
+// Renders frames 0, 1, ... with its own viewer until a frame repeats the first one, so
+// playback can cycle through ready images instead of decoding every tick. Animations
+// without a period of at most MAX_FRAMES frames are left to live rendering.
+class FrameRing : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_FRAMES = 64;
+
+    explicit FrameRing(QObject *parent = nullptr);
+    ~FrameRing() override;
+
+    // The viewer must be prepared and have its selectors set; it is used only by the worker.
+    // A rendering in progress is abandoned.
+    void render(std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data);
+    void clear();
+
+    bool isReady() const { return m_ready; }
+    int size() const { return m_ready ? static_cast<int>(m_job->frames.size()) : 0; }
+    const QImage & frame(int index) const { return m_job->frames[index]; }
+    int delay(int index) const { return m_job->delays[index]; }
+
+signals:
+    void ready();
+
+private slots:
+    void onRendered(quint64 generation);
+
+private:
+    QThreadPool m_pool;
+    std::shared_ptr<FrameRingJob> m_job;
+    quint64 m_generation {0};
+    bool m_ready {false};
+};
@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Client library for the local image server
+
+#include "ImageClient.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using ImageProtocol::Op;
+using ImageProtocol::Status;
+using ImageProtocol::Response;
+
+namespace {
+
+// Builds a payload from any number of fields
+class Payload {
+public:
+    Payload() : m_stream(&m_data, QIODevice::WriteOnly) { ImageProtocol::setupStream(m_stream); }
+    template<typename T> Payload & operator<<(const T & value) { m_stream << value; return *this; }
+    QByteArray data() const { return m_data; }
+private:
+    QByteArray m_data;
+    QDataStream m_stream;
+};
+
+} // namespace
+
+ImageClient::ImageClient() = default;
+
+ImageClient::~ImageClient()
+{
+    disconnectFromServer();
+}
+
+bool ImageClient::connectToServer(const QString & name, int timeout_ms)
+{
+    m_socket.connectToServer(name);
+    if (!m_socket.waitForConnected(timeout_ms)) {
+        m_error = m_socket.errorString();
+        m_error_code = 0;
+        return false;
+    }
+
+    Response response;
+    if (!receive(send(Op::Hello), response, timeout_ms) || !check(response)) {
+        disconnectFromServer();
+        return false;
+    }
+    QDataStream in(response.payload);
+    ImageProtocol::setupStream(in);
+    quint32 version = 0;
+    in >> version;
+    if (in.status() != QDataStream::Ok || version != ImageProtocol::VERSION) {
+        m_error = QCoreApplication::translate("ImageClient", "Server protocol version %1, expected %2")
+                      .arg(version).arg(ImageProtocol::VERSION);
+        m_error_code = 0;
+        disconnectFromServer();
+        return false;
+    }
+    return true;
+}
+
+void ImageClient::disconnectFromServer()
+{
+    if (m_socket.state() == QLocalSocket::ConnectedState) {
+        m_socket.disconnectFromServer();
+        if (m_socket.state() != QLocalSocket::UnconnectedState) m_socket.waitForDisconnected(1000);
+    }
+    m_buffer.clear();
+    m_pending.clear();
+    m_received.clear();
+}
+
+bool ImageClient::isConnected() const
+{
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+quint32 ImageClient::send(Op op, const QByteArray & payload)
+{
+    const quint32 id = m_next_id++;
+    m_socket.write(ImageProtocol::frame(id, static_cast<quint8>(op), payload));
+    m_pending.insert(id);
+    return id;
+}
+
+bool ImageClient::receive(quint32 id, Response & response, int timeout_ms)
+{
+    m_socket.flush();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (true) {
+        const auto it = m_received.find(id);
+        if (it != m_received.end()) {
+            response = it->second;
+            m_received.erase(it);
+            m_pending.erase(id);
+            return true;
+        }
+        if (!m_pending.count(id)) {
+            m_error = QCoreApplication::translate("ImageClient", "No such request");
+            m_error_code = 0;
+            return false;
+        }
+
+        // Everything already buffered is parsed at once, pipelined answers arrive together
+        int offset = 0;
+        Response r;
+        quint8 code = 0;
+        bool broken = false;
+        while (ImageProtocol::takeFrame(m_buffer, offset, r.id, code, r.payload, broken)) {
+            r.status = static_cast<Status>(code);
+            if (m_pending.count(r.id)) m_received[r.id] = r;
+        }
+        m_buffer.remove(0, offset);
+        if (broken) {
+            m_error = QCoreApplication::translate("ImageClient", "Protocol error");
+            m_error_code = 0;
+            m_socket.abort();
+            m_buffer.clear();
+            m_pending.clear();
+            m_received.clear();
+            return false;
+        }
+        if (m_received.count(id)) continue;
+
+        const int left = timeout_ms - static_cast<int>(timer.elapsed());
+        if (left <= 0 || !m_socket.waitForReadyRead(left)) {
+            m_error = m_socket.errorString();
+            m_error_code = 0;
+            // Nobody will ask for this response again; after a disconnect no response will come
+            m_pending.erase(id);
+            if (!isConnected()) {
+                m_buffer.clear();
+                m_pending.clear();
+                m_received.clear();
+            }
+            return false;
+        }
+        m_buffer.append(m_socket.readAll());
+    }
+}
+
+bool ImageClient::check(const Response & response)
+{
+    switch (response.status) {
+        case Status::Ok:
+            return true;
+        case Status::Error: {
+            QDataStream in(response.payload);
+            ImageProtocol::setupStream(in);
+            qint32 code = 0;
+            in >> code >> m_error;
+            m_error_code = code;
+            return false;
+        }
+        case Status::BadHandle:
+            m_error = QCoreApplication::translate("ImageClient", "Image is not open");
+            break;
+        default:
+            m_error = QCoreApplication::translate("ImageClient", "Bad request");
+            break;
+    }
+    m_error_code = 0;
+    return false;
+}
+
+bool ImageClient::call(Op op, const QByteArray & payload, Response & response)
+{
+    return receive(send(op, payload), response) && check(response);
+}
+
+// ==========================================================================
+// Requests
+
+QByteArray ImageClient::openRequest(const QString & file_name)
+{
+    return (Payload() << file_name).data();
+}
+
+QByteArray ImageClient::listRequest(quint32 handle, const QString & dir)
+{
+    return (Payload() << handle << dir).data();
+}
+
+QByteArray ImageClient::getRequest(quint32 handle, const QString & path, const QString & format)
+{
+    return (Payload() << handle << path << format).data();
+}
+
+QByteArray ImageClient::putRequest(quint32 handle, const QString & dir, const QString & name, const QString & format,
+                                   const QByteArray & data, bool overwrite)
+{
+    return (Payload() << handle << dir << name << format << data << overwrite).data();
+}
+
+QByteArray ImageClient::pathRequest(quint32 handle, const QString & path)
+{
+    return (Payload() << handle << path).data();
+}
+
+QByteArray ImageClient::saveRequest(quint32 handle, bool backup)
+{
+    return (Payload() << handle << backup).data();
+}
+
+bool ImageClient::open(const QString & file_name, ImageInfo & info)
+{
+    Response response;
+    if (!call(Op::Open, openRequest(file_name), response)) return false;
+    QDataStream in(response.payload);
+    ImageProtocol::setupStream(in);
+    in >> info.handle >> info.format_id >> info.type_id >> info.filesystem_id;
+    return true;
+}
+
+bool ImageClient::close(quint32 handle)
+{
+    Response response;
+    return call(Op::Close, (Payload() << handle).data(), response);
+}
+
+bool ImageClient::list(quint32 handle, const QString & dir, std::vector<ImageProtocol::Entry> & entries)
+{
+    entries.clear();
+    Response response;
+    if (!call(Op::List, listRequest(handle, dir), response)) return false;
+    QDataStream in(response.payload);
+    ImageProtocol::setupStream(in);
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        ImageProtocol::Entry entry;
+        in >> entry;
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool ImageClient::get(quint32 handle, const QString & path, const QString & format, QByteArray & data)
+{
+    Response response;
+    if (!call(Op::Get, getRequest(handle, path, format), response)) return false;
+    QDataStream in(response.payload);
+    ImageProtocol::setupStream(in);
+    in >> data;
+    return true;
+}
+
+bool ImageClient::put(quint32 handle, const QString & dir, const QString & name, const QString & format,
+                      const QByteArray & data, bool overwrite)
+{
+    Response response;
+    return call(Op::Put, putRequest(handle, dir, name, format, data, overwrite), response);
+}
+
+bool ImageClient::remove(quint32 handle, const QString & path)
+{
+    Response response;
+    return call(Op::Delete, pathRequest(handle, path), response);
+}
+
+bool ImageClient::save(quint32 handle, bool backup, QString * backup_file)
+{
+    Response response;
+    if (!call(Op::Save, saveRequest(handle, backup), response)) return false;
+    if (backup_file) {
+        QDataStream in(response.payload);
+        ImageProtocol::setupStream(in);
+        in >> *backup_file;
+    }
+    return true;
+}
+
+bool ImageClient::shutdown()
+{
+    Response response;
+    return call(Op::Shutdown, QByteArray(), response);
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Client library for the local image server
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <QLocalSocket>
+
+#include "ImageProtocol.h"
+
+// Blocking client, usable without an event loop. The simple calls send one request and wait
+// for its answer. To avoid a round trip per request, send() several requests first and then
+// receive() their responses by id.
+class ImageClient
+{
+public:
+    struct ImageInfo {
+        quint32 handle {0};
+        QString format_id;
+        QString type_id;
+        QString filesystem_id;
+    };
+
+    ImageClient();
+    ~ImageClient();
+
+    // Connects and checks that the server speaks the same protocol version
+    bool connectToServer(const QString & name = ImageProtocol::defaultServerName(), int timeout_ms = 3000);
+    void disconnectFromServer();
+    bool isConnected() const;
+
+    // Text of the last failure: a transport error or the server's error message
+    QString errorString() const { return m_error; }
+    // dsk_tools::ErrorCode of the last failed operation, 0 for transport errors
+    int errorCode() const { return m_error_code; }
+
+    // Pipelining. A request whose receive() timed out is given up, its late response is dropped.
+    quint32 send(ImageProtocol::Op op, const QByteArray & payload = QByteArray());
+    bool receive(quint32 id, ImageProtocol::Response & response, int timeout_ms = 30000);
+
+    // One request each
+    bool open(const QString & file_name, ImageInfo & info);
+    bool close(quint32 handle);
+    bool list(quint32 handle, const QString & dir, std::vector<ImageProtocol::Entry> & entries);
+    bool get(quint32 handle, const QString & path, const QString & format, QByteArray & data);
+    bool put(quint32 handle, const QString & dir, const QString & name, const QString & format,
+             const QByteArray & data, bool overwrite = false);
+    bool remove(quint32 handle, const QString & path);
+    bool save(quint32 handle, bool backup = true, QString * backup_file = nullptr);
+    bool shutdown();
+
+    // Request payloads, for building pipelined batches
+    static QByteArray openRequest(const QString & file_name);
+    static QByteArray listRequest(quint32 handle, const QString & dir);
+    static QByteArray getRequest(quint32 handle, const QString & path, const QString & format);
+    static QByteArray putRequest(quint32 handle, const QString & dir, const QString & name, const QString & format,
+                                 const QByteArray & data, bool overwrite);
+    static QByteArray pathRequest(quint32 handle, const QString & path);
+    static QByteArray saveRequest(quint32 handle, bool backup);
+
+    // Checks the status and takes the error message out of a failed response
+    bool check(const ImageProtocol::Response & response);
+
+private:
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+    std::set<quint32> m_pending;                                // Sent and still waited for
+    std::map<quint32, ImageProtocol::Response> m_received;     // Responses read while waiting for another id
+    quint32 m_next_id {1};
+    QString m_error;
+    int m_error_code {0};
+
+    bool call(ImageProtocol::Op op, const QByteArray & payload, ImageProtocol::Response & response);
+};
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Sector and file level comparison of two disk images
+
+#include "ImageDiff.h"
+#include "FileDigest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include <QElapsedTimer>
+#include <QHash>
+
+namespace {
+
+const int MAX_DEPTH = 10;   // The same limit as FileOperations::putFiles()
+
+// FNV-1a as in ViewerRegistry::contentHash(), over a part of a buffer
+const quint64 FNV_OFFSET = 14695981039346656037ULL;
+const quint64 FNV_PRIME = 1099511628211ULL;
+
+quint64 blockHash(const uint8_t * data, size_t size)
+{
+    quint64 hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Blocks of a single repeated byte are in many files and free sectors, they identify nothing
+bool isFill(const uint8_t * data, size_t size)
+{
+    return size < 2 || std::memcmp(data, data + 1, size - 1) == 0;
+}
+
+// A sector-aligned part of a file, pointing into Side::contents
+struct Part {
+    QString file;
+    const uint8_t * data;
+};
+typedef QHash<quint64, std::vector<Part>> PartIndex;
+
+// Files of one image and the sector-sized parts of their contents
+struct Side {
+    std::map<QString, FileDigest> files;
+    std::deque<dsk_tools::BYTES> contents;     // Data of every file; a deque keeps the parts valid
+    PartIndex blocks;                           // Hash of a whole part -> parts
+    std::vector<PartIndex> tails;               // Last parts shorter than a sector, by size, then by hash
+
+    // Hashes only pick candidates, the bytes are compared before a file is taken
+    QStringList owners(const uint8_t * sector, int sector_size) const
+    {
+        const size_t size = static_cast<size_t>(sector_size);
+        if (isFill(sector, size)) return QStringList();
+
+        // FNV-1a goes byte by byte, so the hash of every prefix comes on the way to the whole
+        QStringList tail_owners;
+        quint64 hash = FNV_OFFSET;
+        for (size_t i = 0; i < size; i++) {
+            if (i < tails.size() && !tails[i].isEmpty()) match(tails[i], hash, sector, i, tail_owners);
+            hash ^= sector[i];
+            hash *= FNV_PRIME;
+        }
+
+        QStringList result;
+        match(blocks, hash, sector, size, result);
+        for (const QString & file : tail_owners) {
+            if (!result.contains(file)) result.append(file);
+        }
+        return result;
+    }
+
+    static void match(const PartIndex & index, quint64 hash, const uint8_t * sector, size_t size, QStringList & result)
+    {
+        const auto it = index.constFind(hash);
+        if (it == index.constEnd()) return;
+        for (const Part & part : it.value()) {
+            if (std::memcmp(part.data, sector, size) == 0 && !result.contains(part.file))
+                result.append(part.file);
+        }
+    }
+};
+
+void listFiles(dsk_tools::fileSystem * fs, const QString & path, int depth, int sector_size, Side & side)
+{
+    dsk_tools::Files files;
+    if (!fs->dir(files, false)) return;
+
+    for (const dsk_tools::UniversalFile & f : files) {
+        if (f.name == "..") continue;
+
+        const QString name = QString::fromStdString(f.name);
+        const QString file_path = path.isEmpty() ? name : path + "/" + name;
+        if (f.is_dir) {
+            if (depth >= MAX_DEPTH) continue;
+            fs->cd(f);
+            listFiles(fs, file_path, depth + 1, sector_size, side);
+            fs->cd_up();
+            continue;
+        }
+
+        dsk_tools::BYTES data;
+        if (!fs->get_file(f, "", data)) continue;
+        side.files[file_path] = FileDigest::of(data, false);
+        if (sector_size <= 0) continue;
+
+        side.contents.push_back(std::move(data));
+        const dsk_tools::BYTES & contents = side.contents.back();
+        const size_t step = static_cast<size_t>(sector_size);
+        for (size_t offset = 0; offset < contents.size(); offset += step) {
+            const uint8_t * part = contents.data() + offset;
+            const size_t size = std::min(step, contents.size() - offset);
+            if (isFill(part, size)) continue;
+            PartIndex & index = (size == step) ? side.blocks : side.tails[size];
+            std::vector<Part> & parts = index[blockHash(part, size)];
+            // One part per file is enough, any of them proves the owner
+            bool known = false;
+            for (const Part & p : parts) {
+                if (p.file == file_path && std::memcmp(p.data, part, size) == 0) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) parts.push_back(Part{file_path, part});
+        }
+    }
+}
+
+void listImage(dsk_tools::diskImage * image, const std::string & fs_id, int sector_size, Side & side)
+{
+    if (!image || fs_id.empty()) return;
+    std::unique_ptr<dsk_tools::fileSystem> fs = dsk_tools::prepare_filesystem(image, fs_id);
+    if (!fs || !fs->open()) return;
+    if (sector_size > 0) side.tails.resize(static_cast<size_t>(sector_size));
+    listFiles(fs.get(), QString(), 0, sector_size, side);
+}
+
+} // namespace
+
+ImageDiffResult ImageDiff::compare(dsk_tools::diskImage * left, const std::string & left_fs_id,
+                                   dsk_tools::diskImage * right, const std::string & right_fs_id)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ImageDiffResult result;
+    result.tracks = std::min(left->get_tracks(), right->get_tracks());
+    result.heads = std::min(left->get_heads(), right->get_heads());
+    result.sectors = std::min(left->get_sectors(), right->get_sectors());
+    result.sector_size = left->get_sector_size();
+    result.same_geometry = left->get_tracks() == right->get_tracks()
+                        && left->get_heads() == right->get_heads()
+                        && left->get_sectors() == right->get_sectors()
+                        && left->get_sector_size() == right->get_sector_size();
+    // Sectors of different sizes are not comparable, only files are
+    const bool compare_sectors = left->get_sector_size() == right->get_sector_size() && result.sector_size > 0;
+
+    Side left_side, right_side;
+    listImage(left, left_fs_id, compare_sectors ? result.sector_size : 0, left_side);
+    listImage(right, right_fs_id, compare_sectors ? result.sector_size : 0, right_side);
+
+    // Sectors -----------------------------------------------------------------
+    std::map<QString, int> file_sectors;
+    if (compare_sectors) {
+        const size_t size = static_cast<size_t>(result.sector_size);
+        for (int track = 0; track < result.tracks; track++) {
+            for (int head = 0; head < result.heads; head++) {
+                for (int sector = 0; sector < result.sectors; sector++) {
+                    const uint8_t * a = left->get_sector_data(head, track, sector);
+                    const uint8_t * b = right->get_sector_data(head, track, sector);
+                    if (!a || !b) {
+                        result.sectors_unreadable++;
+                        continue;
+                    }
+                    result.sectors_compared++;
+
+                    // memcmp() is vectorized, equal sectors never reach the byte loop
+                    if (std::memcmp(a, b, size) == 0) continue;
+
+                    SectorDiff diff;
+                    diff.track = track;
+                    diff.head = head;
+                    diff.sector = sector;
+                    for (size_t i = 0; i < size; i++) diff.bytes += (a[i] != b[i]) ? 1 : 0;
+                    diff.left_files = left_side.owners(a, result.sector_size);
+                    diff.right_files = right_side.owners(b, result.sector_size);
+
+                    QStringList owners = diff.left_files;
+                    for (const QString & file : diff.right_files) {
+                        if (!owners.contains(file)) owners.append(file);
+                    }
+                    for (const QString & file : owners) file_sectors[file]++;
+
+                    result.sector_diffs.push_back(diff);
+                }
+            }
+        }
+    }
+
+    // Files -------------------------------------------------------------------
+    auto l = left_side.files.begin();
+    auto r = right_side.files.begin();
+    while (l != left_side.files.end() || r != right_side.files.end()) {
+        FileDiff diff;
+        if (r == right_side.files.end() || (l != left_side.files.end() && l->first < r->first)) {
+            diff.path = l->first;
+            diff.change = FileDiff::Removed;
+            diff.left_size = l->second.size;
+            ++l;
+        } else if (l == left_side.files.end() || r->first < l->first) {
+            diff.path = r->first;
+            diff.change = FileDiff::Added;
+            diff.right_size = r->second.size;
+            ++r;
+        } else {
+            const bool same = l->second == r->second;
+            diff.path = l->first;
+            diff.change = FileDiff::Changed;
+            diff.left_size = l->second.size;
+            diff.right_size = r->second.size;
+            ++l;
+            ++r;
+            if (same) continue;
+        }
+        const auto sectors = file_sectors.find(diff.path);
+        if (sectors != file_sectors.end()) diff.sectors = sectors->second;
+        result.file_diffs.push_back(diff);
+    }
+
+    result.elapsed_ms = timer.elapsed();
+    return result;
+}
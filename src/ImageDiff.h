@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Sector and file level comparison of two disk images
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#include "dsk_tools/dsk_tools.h"
+
+struct SectorDiff {
+    int track {0};
+    int head {0};
+    int sector {0};
+    int bytes {0};              // Bytes that differ
+    QStringList left_files;     // Files the sector belongs to on each side, empty for system areas
+    QStringList right_files;
+};
+
+struct FileDiff {
+    enum Change {
+        Added,                  // Only in the right image
+        Removed,                // Only in the left image
+        Changed
+    };
+
+    QString path;               // '/' between directories
+    Change change {Changed};
+    quint64 left_size {0};
+    quint64 right_size {0};
+    int sectors {0};            // Differing sectors owned by the file on either side
+};
+
+struct ImageDiffResult {
+    int tracks {0};             // Compared area, the common part of both geometries
+    int heads {0};
+    int sectors {0};
+    int sector_size {0};
+    bool same_geometry {true};
+    int sectors_compared {0};
+    int sectors_unreadable {0};
+    std::vector<SectorDiff> sector_diffs;       // In track, side, sector order
+    std::vector<FileDiff> file_diffs;           // By path
+    qint64 elapsed_ms {0};
+};
+
+class ImageDiff {
+public:
+    // Images are compared sector by sector. Files are listed through new file systems over the
+    // same images, so the panels' file systems and their current directories are not touched.
+    // Sectors are tied to files by contents: a sector belongs to a file if it equals one of the
+    // file's sector-aligned parts. The library exposes no T/S lists or block maps, so catalog
+    // and allocation sectors stay without a file.
+    static ImageDiffResult compare(dsk_tools::diskImage * left, const std::string & left_fs_id,
+                                   dsk_tools::diskImage * right, const std::string & right_fs_id);
+};
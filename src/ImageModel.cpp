@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Table model over the files list of an opened image
+
+#include "ImageModel.h"
+#include "FilePanel.h"
+
+#include <QCoreApplication>
+
+ImageModel::ImageModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    m_dir_font.setBold(true);
+    m_deleted_font.setStrikeOut(true);
+    m_deleted_dir_font.setBold(true);
+    m_deleted_dir_font.setStrikeOut(true);
+}
+
+void ImageModel::setCaps(dsk_tools::FSCaps caps)
+{
+    beginResetModel();
+    m_columns.clear();
+    if (dsk_tools::hasFlag(caps, dsk_tools::FSCaps::Protect)) m_columns.push_back(Protect);
+    if (dsk_tools::hasFlag(caps, dsk_tools::FSCaps::Types)) m_columns.push_back(Type);
+    m_columns.push_back(Size);
+    m_columns.push_back(Name);
+    endResetModel();
+}
+
+void ImageModel::setListing(const FileListing & listing, std::vector<uint32_t> order)
+{
+    beginResetModel();
+    m_files = listing;
+    m_order = std::move(order);
+    endResetModel();
+}
+
+int ImageModel::rowCount(const QModelIndex & parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_order.size());
+}
+
+int ImageModel::columnCount(const QModelIndex & parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_columns.size());
+}
+
+QVariant ImageModel::data(const QModelIndex & index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount() || index.column() >= columnCount()) return QVariant();
+
+    const dsk_tools::UniversalFile & f = fileAt(index.row());
+    const Column column = m_columns[index.column()];
+
+    switch (role) {
+        case Qt::DisplayRole:
+            switch (column) {
+                case Protect:   return f.is_protected ? QStringLiteral("*") : QString();
+                case Type:      return QString::fromStdString(f.type_label);
+                case Size:      return (f.name != "..") ? HostModel::formatSize(f.size) : QString();
+                case Name: {
+                    const QString name = QString::fromStdString(f.name);
+                    return f.is_dir ? "[" + name + "]" : name;
+                }
+            }
+            break;
+        case Qt::FontRole:
+            if (column != Name) break;
+            if (f.is_dir) return f.is_deleted ? m_deleted_dir_font : m_dir_font;
+            if (f.is_deleted) return m_deleted_font;
+            break;
+        case Qt::TextAlignmentRole:
+            switch (column) {
+                case Protect:
+                case Type:      return static_cast<int>(Qt::AlignCenter);
+                case Size:      return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+                case Name:      break;
+            }
+            break;
+    }
+    return QVariant();
+}
+
+QVariant ImageModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || section < 0 || section >= columnCount())
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    // Translations are those of the former FileTable headers
+    const bool tip = role == Qt::ToolTipRole;
+    if (role != Qt::DisplayRole && !tip) return QVariant();
+    switch (m_columns[section]) {
+        case Protect:   return tip ? QCoreApplication::translate("FileTable", "Protection") : QCoreApplication::translate("FileTable", "P");
+        case Type:      return tip ? QCoreApplication::translate("FileTable", "Type") : QCoreApplication::translate("FileTable", "T");
+        case Size:      return tip ? QCoreApplication::translate("FileTable", "Size in bytes") : QCoreApplication::translate("FileTable", "Size");
+        case Name:      return tip ? QCoreApplication::translate("FileTable", "Name of the file") : QCoreApplication::translate("FileTable", "Name");
+    }
+    return QVariant();
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Table model over the files list of an opened image
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QAbstractTableModel>
+#include <QFont>
+
+#include "dsk_tools/dsk_tools.h"
+#include "FileHandle.h"
+
+// Rows are the entries of a listing in the given order, cells are formatted only when shown.
+// The listing is held by the model and replaced only within a model reset.
+class ImageModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ImageModel(QObject *parent = nullptr);
+
+    // Protection and type columns are shown if the file system has them
+    void setCaps(dsk_tools::FSCaps caps);
+    // order maps rows to indices in listing
+    void setListing(const FileListing & listing, std::vector<uint32_t> order);
+
+    const FileListing & listing() const { return m_files; }
+    const dsk_tools::UniversalFile & fileAt(int row) const { return (*m_files)[m_order[row]]; }
+    FileHandle fileHandle(int row) const { return FileHandle(m_files, m_order[row]); }
+
+    int nameColumn() const { return static_cast<int>(m_columns.size()) - 1; }
+
+    int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    enum Column {
+        Protect,
+        Type,
+        Size,
+        Name
+    };
+
+    FileListing m_files {makeListing(dsk_tools::Files())};
+    std::vector<uint32_t> m_order;              // Row -> index in m_files
+    std::vector<Column> m_columns {Size, Name};
+
+    QFont m_dir_font;
+    QFont m_deleted_font;
+    QFont m_deleted_dir_font;
+};
@@ -0,0 +1,452 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Read-only tree of disk image contents for dskfuse
+
+#include "ImageMount.h"
+#include "stringutils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ImageMount::ImageMount(size_t cache_bytes)
+    : m_cache_limit(cache_bytes)
+{}
+
+bool ImageMount::setSource(const std::string & source, std::string & error)
+{
+    struct stat st;
+    if (::stat(source.c_str(), &st) != 0) {
+        error = source + ": " + std::strerror(errno);
+        return false;
+    }
+    // FUSE changes to "/" when it goes to the background
+    char * real = ::realpath(source.c_str(), nullptr);
+    if (!real) {
+        error = source + ": " + std::strerror(errno);
+        return false;
+    }
+    m_source = real;
+    std::free(real);
+    m_single = !S_ISDIR(st.st_mode);
+
+    if (m_single) {
+        // A single image must open now, there is nothing else to show
+        Target target;
+        if (resolve("/", target) != 0) {
+            error = source + ": not a supported disk image";
+            return false;
+        }
+        std::lock_guard<std::mutex> guard(target.image->lock);
+        if (ensureLoaded(*target.image) != 0) {
+            error = source + ": cannot open the image";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==========================================================================
+// Path resolution
+
+std::vector<std::string> ImageMount::split(const std::string & path)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        if (end > start) parts.push_back(path.substr(start, end - start));
+        start = end + 1;
+    }
+    return parts;
+}
+
+std::string ImageMount::join(const std::vector<std::string> & parts, size_t count)
+{
+    std::string result;
+    for (size_t i = 0; i < count && i < parts.size(); i++) {
+        if (i) result += '/';
+        result += parts[i];
+    }
+    return result;
+}
+
+int ImageMount::resolve(const std::string & path, Target & target)
+{
+    const std::vector<std::string> parts = split(path);
+
+    if (m_single) {
+        target.host_path = m_source;
+        target.image = imageFor(m_source);
+        target.inner = parts;
+        target.kind = parts.empty() ? Kind::ImageDir : Kind::ImageFile;
+        return 0;
+    }
+
+    std::string host = m_source;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (parts[i] == "." || parts[i] == "..") return -ENOENT;
+        host += "/" + parts[i];
+
+        struct stat st;
+        if (::stat(host.c_str(), &st) != 0) return -ENOENT;
+        if (S_ISDIR(st.st_mode)) continue;
+        if (!S_ISREG(st.st_mode)) return -ENOENT;
+
+        if (isImage(host, st.st_mtime, static_cast<uint64_t>(st.st_size))) {
+            target.host_path = host;
+            target.image = imageFor(host);
+            target.inner.assign(parts.begin() + i + 1, parts.end());
+            target.kind = target.inner.empty() ? Kind::ImageDir : Kind::ImageFile;
+            return 0;
+        }
+        if (i + 1 != parts.size()) return -ENOTDIR;
+        target.host_path = host;
+        target.kind = Kind::HostFile;
+        return 0;
+    }
+    target.host_path = host;
+    target.kind = Kind::HostDir;
+    return 0;
+}
+
+bool ImageMount::isImage(const std::string & host_path, time_t mtime, uint64_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const auto it = m_detected.find(host_path);
+        if (it != m_detected.end() && it->second.mtime == mtime && it->second.size == size)
+            return it->second.is_image;
+    }
+
+    // Detection reads only what it needs to identify the container; loading waits for the first access
+    LoadedImage probe;
+    const bool is_image = ImageUtils::detectImage(host_path, probe) && !probe.filesystem_id.empty();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_detected[host_path] = Detected {mtime, size, is_image};
+    return is_image;
+}
+
+std::shared_ptr<ImageMount::Image> ImageMount::imageFor(const std::string & host_path)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::shared_ptr<Image> & image = m_images[host_path];
+    if (!image) {
+        image = std::make_shared<Image>();
+        image->host_path = host_path;
+    }
+    return image;
+}
+
+// ==========================================================================
+// Images
+
+int ImageMount::ensureLoaded(Image & image)
+{
+    struct stat st;
+    if (::stat(image.host_path.c_str(), &st) != 0) return -ENOENT;
+
+    if (image.loaded || image.load_error) {
+        if (st.st_mtime == image.mtime && static_cast<uint64_t>(st.st_size) == image.host_size)
+            return image.load_error;
+
+        // Changed on disk: everything derived from the old contents goes
+        image.loaded = false;
+        image.load_error = 0;
+        image.listings.clear();
+        image.cwd.clear();
+        image.image = LoadedImage();
+        dropCached(image.host_path + "\n");
+    }
+
+    image.mtime = st.st_mtime;
+    image.host_size = static_cast<uint64_t>(st.st_size);
+    if (!ImageUtils::openImage(image.host_path, image.image)) {
+        image.load_error = -EIO;
+        return image.load_error;
+    }
+    image.loaded = true;
+    return 0;
+}
+
+int ImageMount::enter(Image & image, const std::vector<std::string> & dir)
+{
+    dsk_tools::fileSystem * fs = image.image.filesystem.get();
+
+    size_t common = 0;
+    while (common < image.cwd.size() && common < dir.size() && image.cwd[common] == dir[common]) common++;
+    while (image.cwd.size() > common) {
+        fs->cd_up();
+        image.cwd.pop_back();
+    }
+
+    // Every parent is listed before its children, so the entries are already known
+    for (size_t i = common; i < dir.size(); i++) {
+        const auto it = image.listings.find(join(dir, i));
+        if (it == image.listings.end()) return -ENOENT;
+        const Entry * entry = nullptr;
+        for (const Entry & e : it->second) {
+            if (e.name == dir[i]) entry = &e;
+        }
+        if (!entry || !entry->is_dir) return -ENOENT;
+        fs->cd(entry->file);
+        image.cwd.push_back(dir[i]);
+    }
+    return 0;
+}
+
+int ImageMount::listing(Image & image, const std::vector<std::string> & dir, Listing *& out)
+{
+    const std::string key = join(dir, dir.size());
+    auto it = image.listings.find(key);
+    if (it != image.listings.end()) {
+        out = &it->second;
+        return 0;
+    }
+
+    if (!dir.empty()) {
+        Listing * parent = nullptr;
+        const std::vector<std::string> parent_dir(dir.begin(), dir.end() - 1);
+        const int res = listing(image, parent_dir, parent);
+        if (res != 0) return res;
+    }
+    const int res = enter(image, dir);
+    if (res != 0) return res;
+
+    dsk_tools::Files files;
+    if (!image.image.filesystem->dir(files, false)) return -EIO;
+
+    Listing entries;
+    std::set<std::string> used;
+    for (const dsk_tools::UniversalFile & f : files) {
+        if (f.name == ".." || f.is_deleted) continue;
+
+        std::string name = _toStdString(ImageUtils::hostFileName(QString::fromStdString(f.name)));
+        if (used.count(name)) {
+            int n = 1;
+            while (used.count(name + "~" + std::to_string(n))) n++;
+            name += "~" + std::to_string(n);
+        }
+        used.insert(name);
+
+        Entry entry;
+        entry.name = name;
+        entry.is_dir = f.is_dir;
+        entry.size = f.size;
+        entry.file = f;
+        entries.push_back(entry);
+    }
+    out = &(image.listings[key] = entries);
+    return 0;
+}
+
+int ImageMount::findEntry(Image & image, const std::vector<std::string> & inner, Entry *& out)
+{
+    Listing * parent = nullptr;
+    const std::vector<std::string> dir(inner.begin(), inner.end() - 1);
+    const int res = listing(image, dir, parent);
+    if (res != 0) return res;
+    for (Entry & e : *parent) {
+        if (e.name == inner.back()) {
+            out = &e;
+            return 0;
+        }
+    }
+    return -ENOENT;
+}
+
+// ==========================================================================
+// Decoded files cache
+
+ImageMount::FileData ImageMount::cached(const std::string & key)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    const auto it = m_files.find(key);
+    if (it == m_files.end()) return FileData();
+    m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+    return it->second.first;
+}
+
+void ImageMount::store(const std::string & key, const FileData & data)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_files.count(key) || data->size() > m_cache_limit) return;
+
+    m_lru.push_front(key);
+    m_files[key] = std::make_pair(data, m_lru.begin());
+    m_cache_bytes += data->size();
+    while (m_cache_bytes > m_cache_limit && !m_lru.empty()) {
+        const auto it = m_files.find(m_lru.back());
+        m_cache_bytes -= it->second.first->size();
+        m_files.erase(it);
+        m_lru.pop_back();
+    }
+}
+
+void ImageMount::dropCached(const std::string & prefix)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto it = m_lru.begin(); it != m_lru.end();) {
+        if (it->compare(0, prefix.size(), prefix) == 0) {
+            const auto file = m_files.find(*it);
+            m_cache_bytes -= file->second.first->size();
+            m_files.erase(file);
+            it = m_lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ==========================================================================
+// File system operations
+
+int ImageMount::stat(const std::string & path, Stat & st)
+{
+    Target target;
+    int res = resolve(path, target);
+    if (res != 0) return res;
+
+    struct stat host;
+    if (::stat(target.host_path.c_str(), &host) != 0) return -errno;
+    st.mtime = host.st_mtime;
+
+    switch (target.kind) {
+        case Kind::HostDir:
+        case Kind::ImageDir:
+            st.is_dir = true;
+            st.size = 0;
+            return 0;
+        case Kind::HostFile:
+            st.is_dir = false;
+            st.size = static_cast<uint64_t>(host.st_size);
+            return 0;
+        case Kind::ImageFile: {
+            std::lock_guard<std::mutex> guard(target.image->lock);
+            res = ensureLoaded(*target.image);
+            if (res != 0) return res;
+            Entry * entry = nullptr;
+            res = findEntry(*target.image, target.inner, entry);
+            if (res != 0) return res;
+            st.is_dir = entry->is_dir;
+            st.size = entry->is_dir ? 0 : entry->size;
+            return 0;
+        }
+    }
+    return -ENOENT;
+}
+
+int ImageMount::list(const std::string & path, std::vector<std::pair<std::string, Stat>> & entries)
+{
+    Target target;
+    int res = resolve(path, target);
+    if (res != 0) return res;
+
+    if (target.kind == Kind::HostDir) {
+        DIR * dir = ::opendir(target.host_path.c_str());
+        if (!dir) return -errno;
+        while (struct dirent * de = ::readdir(dir)) {
+            const std::string name = de->d_name;
+            if (name == "." || name == "..") continue;
+            const std::string host = target.host_path + "/" + name;
+            struct stat st;
+            if (::stat(host.c_str(), &st) != 0) continue;
+
+            Stat s;
+            s.mtime = st.st_mtime;
+            if (S_ISDIR(st.st_mode)) {
+                s.is_dir = true;
+            } else if (S_ISREG(st.st_mode)) {
+                s.is_dir = isImage(host, st.st_mtime, static_cast<uint64_t>(st.st_size));
+                s.size = s.is_dir ? 0 : static_cast<uint64_t>(st.st_size);
+            } else {
+                continue;
+            }
+            entries.push_back(std::make_pair(name, s));
+        }
+        ::closedir(dir);
+        return 0;
+    }
+
+    if (target.kind == Kind::HostFile) return -ENOTDIR;
+
+    std::lock_guard<std::mutex> guard(target.image->lock);
+    res = ensureLoaded(*target.image);
+    if (res != 0) return res;
+    Listing * listing_entries = nullptr;
+    res = listing(*target.image, target.inner, listing_entries);
+    if (res != 0) return res;
+    for (const Entry & e : *listing_entries) {
+        Stat s;
+        s.is_dir = e.is_dir;
+        s.size = e.is_dir ? 0 : e.size;
+        s.mtime = target.image->mtime;
+        entries.push_back(std::make_pair(e.name, s));
+    }
+    return 0;
+}
+
+int ImageMount::open(const std::string & path)
+{
+    Stat st;
+    const int res = stat(path, st);
+    if (res != 0) return res;
+    return st.is_dir ? -EISDIR : 0;
+}
+
+int ImageMount::read(const std::string & path, char * buf, size_t size, uint64_t offset)
+{
+    Target target;
+    int res = resolve(path, target);
+    if (res != 0) return res;
+
+    if (target.kind == Kind::HostFile) {
+        const int fd = ::open(target.host_path.c_str(), O_RDONLY);
+        if (fd < 0) return -errno;
+        const ssize_t n = ::pread(fd, buf, size, static_cast<off_t>(offset));
+        const int err = errno;
+        ::close(fd);
+        return n < 0 ? -err : static_cast<int>(n);
+    }
+    if (target.kind != Kind::ImageFile) return -EISDIR;
+
+    const std::string key = target.host_path + "\n" + join(target.inner, target.inner.size());
+    FileData data = cached(key);
+    if (!data) {
+        std::lock_guard<std::mutex> guard(target.image->lock);
+        Image & image = *target.image;
+        res = ensureLoaded(image);
+        if (res != 0) return res;
+        Entry * entry = nullptr;
+        res = findEntry(image, target.inner, entry);
+        if (res != 0) return res;
+        if (entry->is_dir) return -EISDIR;
+
+        const std::vector<std::string> dir(target.inner.begin(), target.inner.end() - 1);
+        res = enter(image, dir);
+        if (res != 0) return res;
+
+        std::shared_ptr<dsk_tools::BYTES> bytes = std::make_shared<dsk_tools::BYTES>();
+        if (!image.image.filesystem->get_file(entry->file, "", *bytes)) return -EIO;
+
+        // From now on stat() reports the exact size
+        entry->size = bytes->size();
+        data = bytes;
+        store(key, data);
+    }
+
+    if (offset >= data->size()) return 0;
+    const size_t n = std::min<size_t>(size, data->size() - offset);
+    std::memcpy(buf, data->data() + offset, n);
+    return static_cast<int>(n);
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Read-only tree of disk image contents for dskfuse
+
+#pragma once
+
+#include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ImageUtils.h"
+
+// Maps paths of a mount point onto image contents. The source is either a single image
+// (its root is the mount root) or a host directory, where every image is shown as a
+// subdirectory with the same name and other files are passed through.
+//
+// Images are detected when their directory is listed and loaded on first access inside.
+// Directory listings are kept for the life of the image; decoded files share one LRU cache
+// limited in bytes. An image whose file changes on disk is dropped and loaded again.
+//
+// All methods return 0 / a byte count on success and -errno on failure, as FUSE expects,
+// and can be called from several threads.
+class ImageMount
+{
+public:
+    struct Stat {
+        bool is_dir {false};
+        uint64_t size {0};
+        time_t mtime {0};
+    };
+
+    explicit ImageMount(size_t cache_bytes);
+
+    bool setSource(const std::string & source, std::string & error);
+
+    int stat(const std::string & path, Stat & st);
+    int list(const std::string & path, std::vector<std::pair<std::string, Stat>> & entries);
+    int open(const std::string & path);
+    int read(const std::string & path, char * buf, size_t size, uint64_t offset);
+
+private:
+    struct Entry {
+        std::string name;           // Host-safe and unique within the directory
+        bool is_dir {false};
+        uint64_t size {0};          // An estimate until the file is decoded once
+        dsk_tools::UniversalFile file;
+    };
+    typedef std::vector<Entry> Listing;
+
+    struct Image {
+        std::mutex lock;            // dsk_tools objects are not thread-safe
+        std::string host_path;
+        time_t mtime {0};
+        uint64_t host_size {0};
+        bool loaded {false};
+        int load_error {0};
+        LoadedImage image;
+        std::map<std::string, Listing> listings;    // Inner directory ("" = root) -> entries
+        std::vector<std::string> cwd;               // Current directory of the file system
+    };
+
+    enum class Kind { HostDir, HostFile, ImageDir, ImageFile };
+
+    struct Target {
+        Kind kind {Kind::HostDir};
+        std::string host_path;
+        std::shared_ptr<Image> image;
+        std::vector<std::string> inner;             // Path inside the image
+    };
+
+    std::string m_source;
+    bool m_single {false};
+
+    std::mutex m_lock;                              // Guards everything below
+    std::map<std::string, std::shared_ptr<Image>> m_images;
+    struct Detected { time_t mtime; uint64_t size; bool is_image; };
+    std::map<std::string, Detected> m_detected;
+
+    // Decoded files, most recently used first
+    typedef std::shared_ptr<const dsk_tools::BYTES> FileData;
+    std::list<std::string> m_lru;
+    std::unordered_map<std::string, std::pair<FileData, std::list<std::string>::iterator>> m_files;
+    size_t m_cache_bytes {0};
+    size_t m_cache_limit;
+
+    int resolve(const std::string & path, Target & target);
+    bool isImage(const std::string & host_path, time_t mtime, uint64_t size);
+    std::shared_ptr<Image> imageFor(const std::string & host_path);
+
+    // Called with image.lock held
+    int ensureLoaded(Image & image);
+    int listing(Image & image, const std::vector<std::string> & dir, Listing *& out);
+    int enter(Image & image, const std::vector<std::string> & dir);
+    int findEntry(Image & image, const std::vector<std::string> & inner, Entry *& out);
+
+    FileData cached(const std::string & key);
+    void store(const std::string & key, const FileData & data);
+    void dropCached(const std::string & prefix);
+
+    static std::vector<std::string> split(const std::string & path);
+    static std::string join(const std::vector<std::string> & parts, size_t count);
+};
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Wire format of the local image server
+
+#include "ImageProtocol.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace ImageProtocol {
+
+QString defaultServerName()
+{
+    // One server per user, local socket names are shared on Windows
+    QString user = QString::fromLocal8Bit(qgetenv("USER"));
+    if (user.isEmpty()) user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+    return user.isEmpty() ? QString("dsk_commander") : QString("dsk_commander-%1").arg(user);
+}
+
+QByteArray frame(quint32 id, quint8 code, const QByteArray & payload)
+{
+    QByteArray result;
+    result.resize(HEADER_SIZE + payload.size());
+    uchar * p = reinterpret_cast<uchar *>(result.data());
+    qToBigEndian<quint32>(static_cast<quint32>(HEADER_SIZE - 4 + payload.size()), p);
+    qToBigEndian<quint32>(id, p + 4);
+    p[8] = code;
+    if (!payload.isEmpty()) std::memcpy(p + HEADER_SIZE, payload.constData(), payload.size());
+    return result;
+}
+
+bool takeFrame(const QByteArray & buffer, int & offset, quint32 & id, quint8 & code, QByteArray & payload, bool & broken)
+{
+    broken = false;
+    const quint32 available = static_cast<quint32>(buffer.size() - offset);
+    if (available < 4) return false;
+
+    const uchar * p = reinterpret_cast<const uchar *>(buffer.constData()) + offset;
+    const quint32 size = qFromBigEndian<quint32>(p);
+    if (size < HEADER_SIZE - 4 || size > MAX_FRAME) {
+        broken = true;
+        return false;
+    }
+    if (available < 4 + size) return false;
+
+    id = qFromBigEndian<quint32>(p + 4);
+    code = p[8];
+    payload = buffer.mid(offset + HEADER_SIZE, size - (HEADER_SIZE - 4));
+    offset += 4 + size;
+    return true;
+}
+
+void setupStream(QDataStream & stream)
+{
+    stream.setVersion(QDataStream::Qt_5_6);
+}
+
+QDataStream & operator<<(QDataStream & stream, const Entry & entry)
+{
+    return stream << entry.name << entry.is_dir << entry.size << entry.preferred_type << entry.is_protected;
+}
+
+QDataStream & operator>>(QDataStream & stream, Entry & entry)
+{
+    return stream >> entry.name >> entry.is_dir >> entry.size >> entry.preferred_type >> entry.is_protected;
+}
+
+} // namespace ImageProtocol
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Wire format of the local image server
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+// Every message is a frame:
+//
+//     quint32  size       bytes following this field
+//     quint32  id         request id chosen by the client, echoed in the response
+//     quint8   code       Op in requests, Status in responses
+//     ...      payload    QDataStream (Qt_5_6) fields listed below
+//
+// A client may send any number of requests without waiting. The server answers each
+// connection's requests in the order they arrive, so responses can be matched by id.
+//
+//  Op          request payload                                     response payload
+//  Hello       -                                                   quint32 version
+//  Open        QString path                                        quint32 handle, QString format, type, filesystem
+//  Close       quint32 handle                                      -
+//  List        quint32 handle, QString dir                         quint32 count, count x Entry
+//  Get         quint32 handle, QString path, QString format        QByteArray data
+//  Put         quint32 handle, QString dir, QString name,          -
+//              QString format, QByteArray data, bool overwrite
+//  Delete      quint32 handle, QString path                        -
+//  Save        quint32 handle, bool backup                         QString backup file ("" if none)
+//  Shutdown    -                                                   -
+//
+//  Entry:      QString name, bool is_dir, quint32 size, quint8 preferred type, bool is_protected
+//  Error:      qint32 dsk_tools::ErrorCode, QString message
+//
+// Paths inside images use '/' and are relative to the root ("" is the root itself).
+// Every Open returns a new handle that only the connection which opened it can use; it is
+// released by Close or when that connection is closed. Handles to the same file share one
+// loaded image, which stays loaded while any handle refers to it. Open loads the file again
+// if it was changed by someone else while the image had no unsaved changes; handles opened
+// before keep the image they had.
+
+namespace ImageProtocol {
+
+const quint32 VERSION = 2;
+const quint32 HEADER_SIZE = 9;                      // size + id + code
+const quint32 MAX_FRAME = 64 * 1024 * 1024;         // Far above any disk image, protects against garbage
+
+enum class Op : quint8 {
+    Hello = 0,
+    Open,
+    Close,
+    List,
+    Get,
+    Put,
+    Delete,
+    Save,
+    Shutdown
+};
+
+enum class Status : quint8 {
+    Ok = 0,
+    Error,              // The operation failed, see the error payload
+    BadRequest,         // Unknown op or malformed payload
+    BadHandle           // No image with this handle
+};
+
+struct Entry {
+    QString name;
+    bool is_dir {false};
+    quint32 size {0};
+    quint8 preferred_type {0};
+    bool is_protected {false};
+};
+
+struct Response {
+    quint32 id {0};
+    Status status {Status::Ok};
+    QByteArray payload;
+};
+
+QString defaultServerName();
+
+// Serialized header + payload
+QByteArray frame(quint32 id, quint8 code, const QByteArray & payload);
+
+// Reads the frame starting at offset and moves offset past it. Returns false if the frame
+// is not complete yet; sets broken if the size field is impossible and the connection must
+// be dropped. Callers remove consumed bytes once per read, not once per frame.
+bool takeFrame(const QByteArray & buffer, int & offset, quint32 & id, quint8 & code, QByteArray & payload, bool & broken);
+
+// QDataStream with the version both sides agree on
+void setupStream(QDataStream & stream);
+
+QDataStream & operator<<(QDataStream & stream, const Entry & entry);
+QDataStream & operator>>(QDataStream & stream, Entry & entry);
+
+} // namespace ImageProtocol
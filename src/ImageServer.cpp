@@ -0,0 +1,386 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Local server keeping disk images loaded for external tools
+
+#include "ImageServer.h"
+#include "ErrorText.h"
+#include "stringutils.h"
+
+#include <vector>
+
+#include <QFileInfo>
+#include <QLocalSocket>
+
+using ImageProtocol::Op;
+using ImageProtocol::Status;
+
+ImageServer::ImageServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QLocalServer::newConnection, this, &ImageServer::onNewConnection);
+}
+
+ImageServer::~ImageServer()
+{
+    m_server.close();
+}
+
+bool ImageServer::listen(const QString & name, QString & error)
+{
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (m_server.listen(name)) return true;
+
+    // A socket file left by a crashed server blocks listen() on Unix; remove it only if nobody answers
+    if (m_server.serverError() == QAbstractSocket::AddressInUseError) {
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (!probe.waitForConnected(500)) {
+            QLocalServer::removeServer(name);
+            if (m_server.listen(name)) return true;
+        }
+    }
+    error = m_server.errorString();
+    return false;
+}
+
+void ImageServer::onNewConnection()
+{
+    while (QLocalSocket * socket = m_server.nextPendingConnection()) {
+        m_buffers[socket] = QByteArray();
+        connect(socket, &QLocalSocket::readyRead, this, &ImageServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &ImageServer::onDisconnected);
+    }
+}
+
+void ImageServer::onDisconnected()
+{
+    QLocalSocket * socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) return;
+    m_buffers.erase(socket);
+
+    std::vector<quint32> handles;
+    for (const auto & handle : m_handles) {
+        if (handle.second.owner == socket) handles.push_back(handle.first);
+    }
+    for (quint32 handle : handles) release(handle);
+
+    socket->deleteLater();
+}
+
+void ImageServer::onReadyRead()
+{
+    QLocalSocket * socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) return;
+
+    QByteArray & buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    // All complete requests are answered with a single write, so a pipelining client
+    // gets its responses in one go
+    QByteArray out;
+    int offset = 0;
+    quint32 id = 0;
+    quint8 code = 0;
+    QByteArray payload;
+    bool broken = false;
+    while (!m_stopping && ImageProtocol::takeFrame(buffer, offset, id, code, payload, broken)) {
+        Status status = Status::Ok;
+        const QByteArray reply = process(socket, code, payload, status);
+        out += ImageProtocol::frame(id, static_cast<quint8>(status), reply);
+    }
+    buffer.remove(0, offset);
+
+    if (!out.isEmpty()) socket->write(out);
+    if (broken) {
+        socket->disconnectFromServer();
+        return;
+    }
+    if (m_stopping) {
+        socket->flush();
+        emit shutdownRequested();
+    }
+}
+
+// ==========================================================================
+// Requests
+
+QByteArray ImageServer::process(QLocalSocket * socket, quint8 code, const QByteArray & payload, Status & status)
+{
+    QDataStream in(payload);
+    ImageProtocol::setupStream(in);
+    QByteArray reply;
+    QDataStream out(&reply, QIODevice::WriteOnly);
+    ImageProtocol::setupStream(out);
+
+    quint32 handle = 0;
+    OpenImage * image = nullptr;
+    dsk_tools::Result result = dsk_tools::Result::ok();
+
+    // Every request except Hello, Open and Shutdown starts with a handle
+    const Op op = static_cast<Op>(code);
+    if (op != Op::Hello && op != Op::Open && op != Op::Shutdown) {
+        in >> handle;
+        image = find(socket, handle);
+        if (in.status() != QDataStream::Ok) {
+            status = Status::BadRequest;
+            return QByteArray();
+        }
+        if (!image) {
+            status = Status::BadHandle;
+            return QByteArray();
+        }
+    }
+
+    switch (op) {
+        case Op::Hello:
+            out << ImageProtocol::VERSION;
+            break;
+
+        case Op::Open: {
+            QString path;
+            in >> path;
+            if (in.status() != QDataStream::Ok) break;
+            result = open(socket, path, handle);
+            if (result) {
+                const LoadedImage & loaded = m_handles[handle].image->loaded;
+                out << handle
+                    << QString::fromStdString(loaded.format_id)
+                    << QString::fromStdString(loaded.type_id)
+                    << QString::fromStdString(loaded.filesystem_id);
+            }
+            break;
+        }
+
+        case Op::Close:
+            release(handle);
+            break;
+
+        case Op::List: {
+            QString dir;
+            in >> dir;
+            if (in.status() != QDataStream::Ok) break;
+            result = enter(*image, splitPath(dir));
+            if (!result) break;
+            dsk_tools::Files files;
+            result = image->loaded.filesystem->dir(files, false);
+            if (!result) break;
+            out << static_cast<quint32>(files.size());
+            foreach (const dsk_tools::UniversalFile & f, files) {
+                ImageProtocol::Entry entry;
+                entry.name = QString::fromStdString(f.name);
+                entry.is_dir = f.is_dir;
+                entry.size = static_cast<quint32>(f.size);
+                entry.preferred_type = static_cast<quint8>(f.type_preferred);
+                entry.is_protected = f.is_protected;
+                out << entry;
+            }
+            break;
+        }
+
+        case Op::Get: {
+            QString path, format;
+            in >> path >> format;
+            if (in.status() != QDataStream::Ok) break;
+            dsk_tools::UniversalFile f;
+            result = locate(*image, path, f);
+            if (!result) break;
+            dsk_tools::BYTES data;
+            result = image->loaded.filesystem->get_file(f, format.toStdString(), data);
+            if (result) out << QByteArray(reinterpret_cast<const char *>(data.data()), static_cast<int>(data.size()));
+            break;
+        }
+
+        case Op::Put: {
+            QString dir, name, format;
+            QByteArray data;
+            bool overwrite = false;
+            in >> dir >> name >> format >> data >> overwrite;
+            if (in.status() != QDataStream::Ok) break;
+            result = enter(*image, splitPath(dir));
+            if (!result) break;
+
+            // Described the way FilePanel describes host files
+            const std::string std_name = _toStdString(name);
+            dsk_tools::UniversalFile f;
+            f.fs = dsk_tools::FS::Host;
+            f.name = std_name;
+            f.original_name = dsk_tools::strToBytes(std_name);
+            f.size = data.size();
+            f.is_dir = false;
+            f.is_protected = false;
+            f.is_deleted = false;
+            f.type_preferred = dsk_tools::PreferredType::Binary;
+            f.attributes = 0;
+            f.metadata = dsk_tools::strToBytes(std_name);
+
+            const dsk_tools::BYTES bytes(data.constData(), data.constData() + data.size());
+            result = image->loaded.filesystem->put_file(f, format.toStdString(), bytes, overwrite);
+            break;
+        }
+
+        case Op::Delete: {
+            QString path;
+            in >> path;
+            if (in.status() != QDataStream::Ok) break;
+            dsk_tools::UniversalFile f;
+            result = locate(*image, path, f);
+            if (result) result = image->loaded.filesystem->delete_file(f);
+            break;
+        }
+
+        case Op::Save: {
+            bool backup = true;
+            in >> backup;
+            if (in.status() != QDataStream::Ok) break;
+            QString backup_file;
+            result = ImageUtils::saveInPlace(image->loaded, backup, backup_file);
+            if (result) {
+                const QFileInfo fi(QString::fromStdString(image->loaded.file_name));
+                image->modified = fi.lastModified();
+                image->file_size = fi.size();
+                out << backup_file;
+            }
+            break;
+        }
+
+        case Op::Shutdown:
+            m_stopping = true;
+            break;
+
+        default:
+            status = Status::BadRequest;
+            return QByteArray();
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        status = Status::BadRequest;
+        return QByteArray();
+    }
+    if (!result) {
+        status = Status::Error;
+        reply.clear();
+        QDataStream error(&reply, QIODevice::WriteOnly);
+        ImageProtocol::setupStream(error);
+        error << static_cast<qint32>(result.code) << ErrorText::decode(result);
+    }
+    return reply;
+}
+
+dsk_tools::Result ImageServer::open(QLocalSocket * socket, const QString & path, quint32 & handle)
+{
+    const QFileInfo fi(path);
+    const QString key = fi.canonicalFilePath();
+    if (key.isEmpty())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::FileNotFound, _toStdString(path));
+
+    // An image is shared until its file is changed by someone else. Unsaved changes made
+    // through the server win over the file on disk. A reload only affects new handles,
+    // the ones already open keep the image they were given.
+    std::shared_ptr<OpenImage> image;
+    const auto it = m_images.find(key);
+    if (it != m_images.end()) image = it->second.lock();
+    if (image) {
+        const bool changed_on_disk = fi.lastModified() != image->modified || fi.size() != image->file_size;
+        if (changed_on_disk && !image->loaded.filesystem->get_changed()) image.reset();
+    }
+
+    if (!image) {
+        image = std::make_shared<OpenImage>();
+        const dsk_tools::Result result = ImageUtils::openImage(_toStdString(key), image->loaded);
+        if (!result) return result;
+        image->key = key;
+        image->modified = fi.lastModified();
+        image->file_size = fi.size();
+        m_images[key] = image;
+    }
+
+    handle = m_next_handle++;
+    Handle & h = m_handles[handle];
+    h.owner = socket;
+    h.image = image;
+    return dsk_tools::Result::ok();
+}
+
+ImageServer::OpenImage * ImageServer::find(QLocalSocket * socket, quint32 handle)
+{
+    const auto it = m_handles.find(handle);
+    return it != m_handles.end() && it->second.owner == socket ? it->second.image.get() : nullptr;
+}
+
+void ImageServer::release(quint32 handle)
+{
+    const auto it = m_handles.find(handle);
+    if (it == m_handles.end()) return;
+    const QString key = it->second.image->key;
+    m_handles.erase(it);
+
+    // The image itself goes with its last handle
+    const auto image = m_images.find(key);
+    if (image != m_images.end() && image->second.expired()) m_images.erase(image);
+}
+
+QStringList ImageServer::splitPath(const QString & path)
+{
+    QStringList parts = path.split('/');
+    parts.removeAll(QString());
+    return parts;
+}
+
+bool ImageServer::findEntry(dsk_tools::fileSystem * fs, const QString & name, dsk_tools::UniversalFile & f)
+{
+    dsk_tools::Files files;
+    if (!fs->dir(files, false)) return false;
+
+    // Exact match first, then the way the panels compare names
+    foreach (const dsk_tools::UniversalFile & file, files) {
+        if (QString::fromStdString(file.name) == name) {
+            f = file;
+            return true;
+        }
+    }
+    foreach (const dsk_tools::UniversalFile & file, files) {
+        if (QString::fromStdString(file.name).compare(name, Qt::CaseInsensitive) == 0) {
+            f = file;
+            return true;
+        }
+    }
+    return false;
+}
+
+dsk_tools::Result ImageServer::enter(OpenImage & image, const QStringList & dir)
+{
+    dsk_tools::fileSystem * fs = image.loaded.filesystem.get();
+
+    int common = 0;
+    while (common < image.cwd.size() && common < dir.size()
+           && image.cwd[common].compare(dir[common], Qt::CaseInsensitive) == 0)
+        common++;
+    while (image.cwd.size() > common) {
+        fs->cd_up();
+        image.cwd.removeLast();
+    }
+
+    for (int i = common; i < dir.size(); i++) {
+        dsk_tools::UniversalFile f;
+        if (!findEntry(fs, dir[i], f) || !f.is_dir)
+            return dsk_tools::Result::error(dsk_tools::ErrorCode::FileNotFound, _toStdString(dir.mid(0, i + 1).join("/")));
+        fs->cd(f);
+        image.cwd.append(QString::fromStdString(f.name));
+    }
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result ImageServer::locate(OpenImage & image, const QString & path, dsk_tools::UniversalFile & f)
+{
+    QStringList parts = splitPath(path);
+    if (parts.isEmpty())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::InvalidName, _toStdString(path));
+    const QString name = parts.takeLast();
+
+    const dsk_tools::Result result = enter(image, parts);
+    if (!result) return result;
+    if (!findEntry(image.loaded.filesystem.get(), name, f))
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::FileNotFound, _toStdString(path));
+    return dsk_tools::Result::ok();
+}
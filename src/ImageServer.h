@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Local server keeping disk images loaded for external tools
+
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include <QObject>
+#include <QLocalServer>
+#include <QStringList>
+#include <QDateTime>
+
+#include "ImageUtils.h"
+#include "ImageProtocol.h"
+
+class QLocalSocket;
+
+class ImageServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageServer(QObject *parent = nullptr);
+    ~ImageServer() override;
+
+    bool listen(const QString & name, QString & error);
+    QString serverName() const { return m_server.fullServerName(); }
+
+signals:
+    void shutdownRequested();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    // Shared by every handle opened on the same file while it is unchanged
+    struct OpenImage {
+        LoadedImage loaded;
+        QString key;                // Canonical path
+        QDateTime modified;         // File time when loaded or saved, to notice changes made by others
+        qint64 file_size {0};
+        QStringList cwd;            // Current directory of the file system, so requests only walk the difference
+    };
+
+    // Handles belong to the connection that opened them, so a Close or a reload
+    // never takes an image away from another client
+    struct Handle {
+        QLocalSocket * owner {nullptr};
+        std::shared_ptr<OpenImage> image;
+    };
+
+    QLocalServer m_server;
+    std::map<QLocalSocket *, QByteArray> m_buffers;
+    std::map<quint32, Handle> m_handles;
+    std::map<QString, std::weak_ptr<OpenImage>> m_images;     // Canonical path -> the image new handles share
+    quint32 m_next_handle {1};
+    bool m_stopping {false};
+
+    QByteArray process(QLocalSocket * socket, quint8 code, const QByteArray & payload, ImageProtocol::Status & status);
+
+    dsk_tools::Result open(QLocalSocket * socket, const QString & path, quint32 & handle);
+    OpenImage * find(QLocalSocket * socket, quint32 handle);
+    void release(quint32 handle);
+
+    // Makes dir the current directory of the image file system
+    dsk_tools::Result enter(OpenImage & image, const QStringList & dir);
+    // Enters the parent directory of path and finds the entry itself
+    dsk_tools::Result locate(OpenImage & image, const QString & path, dsk_tools::UniversalFile & f);
+
+    static QStringList splitPath(const QString & path);
+    static bool findEntry(dsk_tools::fileSystem * fs, const QString & name, dsk_tools::UniversalFile & f);
+};
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: UI-independent helpers for loading and writing disk images
+
+#include "ImageUtils.h"
+#include "host_helpers.h"
+#include "stringutils.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFile>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#include <set>
+
+dsk_tools::Result ImageUtils::openImage(const std::string & file_name, LoadedImage & out, bool open_filesystem)
+{
+    const auto detect_result = detectImage(file_name, out);
+    if (!detect_result) return detect_result;
+
+    return loadImage(out, open_filesystem);
+}
+
+dsk_tools::Result ImageUtils::detectImage(const std::string & file_name, LoadedImage & out)
+{
+    out.file_name = file_name;
+    out.format_id.clear();
+    out.type_id.clear();
+    out.filesystem_id.clear();
+    out.filesystem.reset();
+    out.image.reset();
+
+    return dsk_tools::detect_fdd_type(file_name, out.format_id, out.type_id, out.filesystem_id);
+}
+
+dsk_tools::Result ImageUtils::loadImage(LoadedImage & loaded, bool open_filesystem)
+{
+    loaded.image = dsk_tools::prepare_image(loaded.file_name, loaded.format_id, loaded.type_id);
+    if (!loaded.image)
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::LoadError, "Failed to prepare image");
+
+    const auto check_result = loaded.image->check();
+    if (!check_result) return check_result;
+
+    const auto load_result = loaded.image->load();
+    if (!load_result) return load_result;
+
+    if (open_filesystem) return openFileSystem(loaded);
+
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result ImageUtils::openFileSystem(LoadedImage & loaded)
+{
+    loaded.filesystem = dsk_tools::prepare_filesystem(loaded.image.get(), loaded.filesystem_id);
+    if (!loaded.filesystem)
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::OpenBadFormat, "File system initialization error");
+
+    const auto open_result = loaded.filesystem->open();
+    if (!open_result) {
+        loaded.filesystem.reset();
+        return open_result;
+    }
+
+    return dsk_tools::Result::ok();
+}
+
+QStringList ImageUtils::collectImages(const QString & root, const QStringList & name_filters, bool recursive)
+{
+    QStringList result;
+    QDirIterator it(
+        root,
+        name_filters,
+        QDir::Files | QDir::Readable | QDir::NoDotAndDotDot,
+        recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags
+    );
+    while (it.hasNext()) {
+        result.append(it.next());
+    }
+    // Directory iteration order is filesystem-dependent; keep reports reproducible
+    result.sort(Qt::CaseInsensitive);
+    return result;
+}
+
+QStringList ImageUtils::sourceFilters(const QJsonObject & file_formats)
+{
+    std::set<QString> unique;
+    foreach (const QString & key, file_formats.keys()) {
+        const QJsonObject format = file_formats[key].toObject();
+        if (!format["source"].toBool()) continue;
+        foreach (const QString & ext, format["extensions"].toString().split(";")) {
+            const QString mask = ext.trimmed().toLower();
+            if (mask.isEmpty() || mask == "*" || mask == "*.*") continue;
+            unique.insert(mask);
+        }
+    }
+
+    // QDirIterator matches name filters case-insensitively unless QDir::CaseSensitive is set
+    QStringList filters;
+    for (const QString & mask : unique) {
+        filters.append(mask);
+    }
+    return filters;
+}
+
+bool ImageUtils::matchMask(const QString & mask, const QString & name)
+{
+    // Iterative wildcard matching with backtracking to the last '*'
+    int m = 0, n = 0, star = -1, mark = 0;
+    while (n < name.size()) {
+        if (m < mask.size() && (mask[m] == '?' || mask[m].toCaseFolded() == name[n].toCaseFolded())) {
+            m++;
+            n++;
+        } else if (m < mask.size() && mask[m] == '*') {
+            star = m++;
+            mark = n;
+        } else if (star >= 0) {
+            m = star + 1;
+            n = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (m < mask.size() && mask[m] == '*') m++;
+    return m == mask.size();
+}
+
+bool ImageUtils::matchMasks(const QStringList & masks, const QString & name)
+{
+    foreach (const QString & mask, masks) {
+        if (matchMask(mask.trimmed(), name)) return true;
+    }
+    return false;
+}
+
+QString ImageUtils::formatExtension(const QJsonObject & file_formats, const QString & format_id)
+{
+    const QJsonObject format = file_formats[format_id].toObject();
+    const QString first = format["extensions"].toString().split(";").at(0);
+    return first.startsWith("*.") ? first.mid(2) : QString();
+}
+
+std::unique_ptr<dsk_tools::Writer> ImageUtils::createWriter(const QString & target_id, dsk_tools::diskImage * image, uint8_t volume_id)
+{
+    std::unique_ptr<dsk_tools::Writer> writer;
+
+    static const std::set<QString> mfm_formats = {"FILE_HXC_MFM", "FILE_MFM_NIB", "FILE_MFM_NIC"};
+
+    if (mfm_formats.find(target_id) != mfm_formats.end()) {
+        writer = dsk_tools::make_unique<dsk_tools::WriterHxCMFM>(target_id.toStdString(), image, volume_id);
+    } else if (target_id == "FILE_HXC_HFE") {
+        writer = dsk_tools::make_unique<dsk_tools::WriterHxCHFE>(target_id.toStdString(), image, volume_id);
+    } else if (target_id == "FILE_RAW_MSB") {
+        writer = dsk_tools::make_unique<dsk_tools::WriterRAW>(target_id.toStdString(), image);
+    }
+
+    return writer;
+}
+
+bool ImageUtils::loadConfig(QJsonObject & file_formats, QJsonObject & file_types, QJsonObject & file_systems, QString & error)
+{
+    QFile file(":/files/config");
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QCoreApplication::translate("MainWindow", "Error reading config file");
+        return false;
+    }
+    const QByteArray config_contents = file.readAll();
+    file.close();
+
+    QJsonParseError err;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(config_contents, &err);
+    if (jsonDoc.isNull()) {
+        error = QCoreApplication::translate("Main", "Config parse error: %1").arg(err.errorString());
+        return false;
+    }
+    const QJsonObject jsonRoot = jsonDoc.object();
+    file_formats = jsonRoot["file_formats"].toObject();
+    file_types = jsonRoot["file_types"].toObject();
+    file_systems = jsonRoot["file_systems"].toObject();
+    return true;
+}
+
+QString ImageUtils::hostFileName(const QString & name)
+{
+    static const QString forbidden("<>:\"/\\|?*");
+    QString result;
+    result.reserve(name.size());
+    for (const QChar c : name) {
+        if (c.unicode() < 0x20 || forbidden.contains(c))
+            result += '_';
+        else
+            result += c;
+    }
+    while (result.endsWith(' ') || result.endsWith('.')) result.chop(1);
+    if (result.isEmpty()) result = "_";
+    return result;
+}
+
+QString ImageUtils::pathKey(const QString & path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath()).toCaseFolded();
+}
+
+QString ImageUtils::backupFileName(const QString & file_name)
+{
+    const QFileInfo fileInfo(file_name);
+    const QString baseName = fileInfo.completeBaseName();
+    const QString suffix = fileInfo.suffix();
+    const QString dirPath = fileInfo.absolutePath();
+
+    // Find first available backup number
+    int backupNum = 1;
+    QString backupName;
+    while (true) {
+        backupName = dirPath + "/" + baseName + "." + QString::number(backupNum);
+        if (!suffix.isEmpty()) {
+            backupName += "." + suffix;
+        }
+
+        if (!QFile::exists(backupName)) {
+            break;
+        }
+        backupNum++;
+    }
+    return backupName;
+}
+
+dsk_tools::Result ImageUtils::saveInPlace(LoadedImage & loaded, bool backup, QString & backup_file)
+{
+    backup_file.clear();
+    if (loaded.format_id != "FILE_RAW_MSB")
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, loaded.format_id);
+
+    // The buffer is ready before the old file is touched
+    dsk_tools::WriterRAW writer(loaded.format_id, loaded.image.get());
+    dsk_tools::BYTES buffer;
+    dsk_tools::Result result = writer.write(buffer);
+    if (!result) return result;
+
+    const QString file_name = QString::fromStdString(loaded.file_name);
+    if (backup) {
+        backup_file = backupFileName(file_name);
+        if (!QFile::rename(file_name, backup_file))
+            return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteError, _toStdString(backup_file));
+    }
+
+    result = writeFile(loaded.file_name, buffer);
+    if (!result) return result;
+
+    if (loaded.filesystem) loaded.filesystem->reset_changed();
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result ImageUtils::readFile(const std::string & file_name, dsk_tools::BYTES & data)
+{
+    UTF8_ifstream file(file_name, std::ios::binary);
+    if (!file.good())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::FileNotFound, file_name);
+
+    file.seekg(0, std::ios::end);
+    const auto size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size < 0)
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::ReadError, file_name);
+
+    data.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(data.data()), size);
+    if (!file.good())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::ReadError, file_name);
+
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result ImageUtils::writeFile(const std::string & file_name, const dsk_tools::BYTES & data)
+{
+    UTF8_ofstream file(file_name, std::ios::binary);
+    if (!file.good())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::CreateError, file_name);
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!file.good())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteError, file_name);
+
+    return dsk_tools::Result::ok();
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: UI-independent helpers for loading and writing disk images
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include "dsk_tools/dsk_tools.h"
+
+// A fully opened disk image: the container and (optionally) its file system.
+// Owns both objects, so it can be moved to and used from a worker thread.
+struct LoadedImage {
+    std::string file_name;
+    std::string format_id;
+    std::string type_id;
+    std::string filesystem_id;
+    std::unique_ptr<dsk_tools::diskImage> image;
+    std::unique_ptr<dsk_tools::fileSystem> filesystem;
+};
+
+class ImageUtils {
+public:
+    // Detects format, type and file system, then loads the image and opens the file system.
+    // Does not show any messages, so it is safe to call outside of the GUI thread.
+    static dsk_tools::Result openImage(const std::string & file_name, LoadedImage & out, bool open_filesystem = true);
+
+    // The same in steps: detection only fills the ids, so callers can reject an image before loading it
+    static dsk_tools::Result detectImage(const std::string & file_name, LoadedImage & out);
+    static dsk_tools::Result loadImage(LoadedImage & loaded, bool open_filesystem = true);
+    static dsk_tools::Result openFileSystem(LoadedImage & loaded);
+
+    // Collects image files under root matching name_filters (e.g. "*.dsk").
+    static QStringList collectImages(const QString & root, const QStringList & name_filters, bool recursive);
+
+    // Name filters of all source formats from the config, without catch-all masks
+    static QStringList sourceFilters(const QJsonObject & file_formats);
+
+    // Case-insensitive wildcard match with '*' and '?', the way DOS-like names are compared
+    static bool matchMask(const QString & mask, const QString & name);
+    static bool matchMasks(const QStringList & masks, const QString & name);
+
+    // The first extension of the format ("dsk" for "*.dsk;*.do")
+    static QString formatExtension(const QJsonObject & file_formats, const QString & format_id);
+
+    static std::unique_ptr<dsk_tools::Writer> createWriter(const QString & target_id, dsk_tools::diskImage * image, uint8_t volume_id);
+
+    // Reads file_formats, file_types and file_systems from the embedded config.json
+    static bool loadConfig(QJsonObject & file_formats, QJsonObject & file_types, QJsonObject & file_systems, QString & error);
+
+    // Names inside images may contain anything, host names may not: replaces characters
+    // forbidden on Windows and drops trailing dots and spaces
+    static QString hostFileName(const QString & name);
+
+    // Compares host paths the way the least forgiving file system does: absolute, cleaned and
+    // case-folded, so "A.DSK" and "a.dsk" are one file as on Windows and macOS
+    static QString pathKey(const QString & path);
+
+    // First free "name.N.ext" next to the file, as used for backups on save
+    static QString backupFileName(const QString & file_name);
+
+    // Writes a raw image back to its file, optionally renaming the old file to backupFileName() first.
+    // Other container formats cannot be written in place.
+    static dsk_tools::Result saveInPlace(LoadedImage & loaded, bool backup, QString & backup_file);
+
+    static dsk_tools::Result readFile(const std::string & file_name, dsk_tools::BYTES & data);
+    static dsk_tools::Result writeFile(const std::string & file_name, const dsk_tools::BYTES & data);
+};
@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Checks many disk images for bad sectors and the files they damage
+
+#include "IntegrityScanner.h"
+#include "ErrorText.h"
+#include "ImageUtils.h"
+#include "stringutils.h"
+#include "placeholders.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+
+namespace {
+
+// Sectors the container could not read cleanly
+const QStringList SECTOR_MARKERS = QStringList() << "{$NORMAL_DATA_WITH_ERROR}" << "{$UNKNOWN_DATA_MARKER}";
+
+// information() and file_info() are plain text for the info dialogs, a finding per line marked
+// by a placeholder. A marker alone on its line heads a list that lasts until an empty line or
+// the next placeholder. The marker itself is dropped unless keep_marker is set.
+QJsonArray findings(const std::string & text, const QStringList & markers, bool keep_marker = false)
+{
+    QJsonArray result;
+    bool in_list = false;
+    foreach (const QString & raw, QString::fromStdString(text).split('\n')) {
+        const QString line = raw.trimmed();
+
+        int pos = -1;
+        QString marker;
+        foreach (const QString & m, markers) {
+            pos = line.indexOf(m);
+            if (pos >= 0) {
+                marker = m;
+                break;
+            }
+        }
+
+        if (pos >= 0) {
+            QString rest = keep_marker ? line : (line.left(pos) + line.mid(pos + marker.size())).trimmed();
+            while (rest.startsWith(':') || rest.startsWith('-')) rest = rest.mid(1).trimmed();
+            in_list = rest.isEmpty();
+            if (!in_list) result.append(rest);
+        } else if (in_list) {
+            if (line.isEmpty() || line.contains("{$")) in_list = false;
+            else result.append(line);
+        }
+    }
+    return result;
+}
+
+bool hasMarker(const std::string & text, const char * marker)
+{
+    return text.find(marker) != std::string::npos;
+}
+
+QString csvField(const QString & value)
+{
+    if (!value.contains('"') && !value.contains(',') && !value.contains(';')
+        && !value.contains('\r') && !value.contains('\n')) return value;
+    QString quoted = value;
+    quoted.replace("\"", "\"\"");
+    return "\"" + quoted + "\"";
+}
+
+} // namespace
+
+IntegrityScanner::IntegrityScanner(QObject *parent)
+    : BatchRunner(parent)
+{
+    connect(this, &BatchRunner::itemFinished, this, &IntegrityScanner::onItemFinished);
+}
+
+IntegrityScanner::~IntegrityScanner()
+{
+    stop();
+}
+
+void IntegrityScanner::setOptions(const QString & root, const QString & checkpoint_file)
+{
+    m_root = root;
+    m_checkpoint_file = checkpoint_file;
+    m_resumed.clear();
+}
+
+int IntegrityScanner::resume(QStringList & images)
+{
+    m_resumed.clear();
+    QFile file(m_checkpoint_file);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+
+    // The last record of an image wins; a line cut short by a crash is not valid JSON and is skipped
+    std::map<QString, QJsonObject> records;
+    while (!file.atEnd()) {
+        const QJsonObject record = QJsonDocument::fromJson(file.readLine()).object();
+        if (!record.isEmpty()) records[QDir::fromNativeSeparators(record["image"].toString())] = record;
+    }
+
+    QStringList pending;
+    foreach (const QString & image, images) {
+        const auto it = records.find(image);
+        const QFileInfo fi(image);
+        if (it != records.end()
+            && it->second["size"].toDouble() == static_cast<double>(fi.size())
+            && it->second["modified"].toDouble() == static_cast<double>(fi.lastModified().toMSecsSinceEpoch())) {
+            m_resumed.push_back(it->second);
+        } else {
+            pending.append(image);
+        }
+    }
+    images = pending;
+    return static_cast<int>(m_resumed.size());
+}
+
+bool IntegrityScanner::beforeStart(QString & error)
+{
+    m_results.assign(items().size(), QJsonObject());
+    m_report = QJsonObject();
+
+    // Rewritten with the records taken over, which drops the ones of changed or removed images
+    QDir().mkpath(QFileInfo(m_checkpoint_file).absolutePath());
+    m_checkpoint.setFileName(m_checkpoint_file);
+    if (!m_checkpoint.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = tr("Cannot write checkpoint '%1'").arg(QDir::toNativeSeparators(m_checkpoint_file));
+        return false;
+    }
+    for (const QJsonObject & record : m_resumed) {
+        m_checkpoint.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + "\n");
+    }
+    m_checkpoint.flush();
+    return true;
+}
+
+dsk_tools::Result IntegrityScanner::processItem(int index, const QString & item, QString & message)
+{
+    const QFileInfo fi(item);
+    QJsonObject result;
+    result["image"] = QDir::toNativeSeparators(item);
+    result["size"] = static_cast<double>(fi.size());
+    result["modified"] = static_cast<double>(fi.lastModified().toMSecsSinceEpoch());
+
+    LoadedImage loaded;
+    const dsk_tools::Result res = ImageUtils::openImage(_toStdString(item), loaded, false);
+    result["format"] = QString::fromStdString(loaded.format_id);
+    result["type"] = QString::fromStdString(loaded.type_id);
+    result["filesystem"] = QString::fromStdString(loaded.filesystem_id);
+    if (!res) {
+        message = ErrorText::decode(res);
+        result["status"] = QString("error");
+        result["message"] = message;
+        m_results[index] = result;
+        return res;
+    }
+
+    // Container: CRCs and data markers of every sector
+    const std::unique_ptr<dsk_tools::Loader> loader = dsk_tools::create_loader(loaded.file_name, loaded.format_id, loaded.type_id);
+    const QJsonArray bad_sectors = loader ? findings(loader->file_info(), SECTOR_MARKERS, true) : QJsonArray();
+
+    // File system: where the bad sectors fall
+    QJsonArray files, reserved, directory;
+    bool disk_damaged = false;
+    const dsk_tools::Result fs_res = ImageUtils::openFileSystem(loaded);
+    if (fs_res) {
+        const std::string info = loaded.filesystem->information();
+        disk_damaged = hasMarker(info, "{$DISK_HAS_BAD_SECTORS}");
+        files = findings(info, QStringList() << "{$FILE_HAS_BAD_SECTORS}");
+        reserved = findings(info, QStringList() << "{$BAD_SECTOR_IN_RESERVED}");
+        directory = findings(info, QStringList() << "{$BAD_SECTOR_IN_DIRECTORY}");
+    } else {
+        result["message"] = ErrorText::decode(fs_res);
+    }
+
+    const bool damaged = disk_damaged || !bad_sectors.isEmpty() || !files.isEmpty() || !reserved.isEmpty() || !directory.isEmpty();
+    result["status"] = QString(damaged ? "damaged" : "ok");
+    result["bad_sectors"] = bad_sectors;
+    result["files"] = files;
+    result["reserved"] = reserved;
+    result["directory"] = directory;
+    m_results[index] = result;
+
+    message = damaged ? tr("%1 bad sectors, %2 damaged files").arg(bad_sectors.size()).arg(files.size())
+                      : tr("No bad sectors");
+    return dsk_tools::Result::ok();
+}
+
+void IntegrityScanner::onItemFinished(int index, const QString & item, bool ok, const QString & message)
+{
+    Q_UNUSED(item);
+    Q_UNUSED(ok);
+    Q_UNUSED(message);
+
+    // Images skipped after cancel() have no record and are checked on resume
+    const QJsonObject & record = m_results[index];
+    if (record.isEmpty() || !m_checkpoint.isOpen()) return;
+    m_checkpoint.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + "\n");
+    m_checkpoint.flush();
+}
+
+void IntegrityScanner::afterFinish()
+{
+    m_checkpoint.close();
+
+    std::vector<QJsonObject> records = m_resumed;
+    for (const QJsonObject & record : m_results) {
+        if (!record.isEmpty()) records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(), [](const QJsonObject & a, const QJsonObject & b) {
+        return QString::compare(a["image"].toString(), b["image"].toString(), Qt::CaseInsensitive) < 0;
+    });
+
+    QJsonArray images;
+    int ok = 0, damaged = 0, failed = 0;
+    for (const QJsonObject & record : records) {
+        const QString status = record["status"].toString();
+        if (status == "ok") ok++;
+        else if (status == "damaged") damaged++;
+        else failed++;
+        images.append(record);
+    }
+
+    m_report["root"] = QDir::toNativeSeparators(m_root);
+    m_report["complete"] = !isCancelled();
+    m_report["images_total"] = static_cast<int>(records.size());
+    m_report["images_resumed"] = static_cast<int>(m_resumed.size());
+    m_report["images_ok"] = ok;
+    m_report["images_damaged"] = damaged;
+    m_report["images_failed"] = failed;
+    m_report["images"] = images;
+
+    m_results.clear();
+    m_resumed.clear();
+}
+
+QStringList IntegrityScanner::translate(const QJsonArray & findings)
+{
+    QStringList result;
+    for (const QJsonValue & value : findings) result.append(replacePlaceholders(value.toString()));
+    return result;
+}
+
+bool IntegrityScanner::writeReport(const QString & file_name, QString & error) const
+{
+    QDir().mkpath(QFileInfo(file_name).absolutePath());
+    QFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = tr("Cannot write report '%1'").arg(QDir::toNativeSeparators(file_name));
+        return false;
+    }
+
+    bool written;
+    if (QFileInfo(file_name).suffix().compare("csv", Qt::CaseInsensitive) == 0) {
+        written = writeCsv(file);
+    } else {
+        // Findings are translated here, the checkpoint keeps them as the library reports them
+        QJsonObject report = m_report;
+        QJsonArray images;
+        for (const QJsonValue & value : m_report["images"].toArray()) {
+            QJsonObject record = value.toObject();
+            for (const char * key : {"bad_sectors", "files", "reserved", "directory"}) {
+                if (record.contains(key)) record[key] = QJsonArray::fromStringList(translate(record[key].toArray()));
+            }
+            images.append(record);
+        }
+        report["images"] = images;
+        written = file.write(QJsonDocument(report).toJson(QJsonDocument::Indented)) >= 0;
+    }
+    file.close();
+    if (!written) {
+        error = tr("Cannot write report '%1'").arg(QDir::toNativeSeparators(file_name));
+        return false;
+    }
+
+    if (m_report["complete"].toBool()) QFile::remove(m_checkpoint_file);
+    return true;
+}
+
+bool IntegrityScanner::writeCsv(QFile & file) const
+{
+    QStringList lines;
+    lines.append("image,status,format,filesystem,bad_sectors,bad_sector_list,files,reserved,directory,message");
+    for (const QJsonValue & value : m_report["images"].toArray()) {
+        const QJsonObject record = value.toObject();
+        const QStringList fields = QStringList()
+            << record["image"].toString()
+            << record["status"].toString()
+            << record["format"].toString()
+            << record["filesystem"].toString()
+            << QString::number(record["bad_sectors"].toArray().size())
+            << translate(record["bad_sectors"].toArray()).join("; ")
+            << translate(record["files"].toArray()).join("; ")
+            << translate(record["reserved"].toArray()).join("; ")
+            << translate(record["directory"].toArray()).join("; ")
+            << record["message"].toString();
+
+        QStringList quoted;
+        foreach (const QString & field, fields) quoted.append(csvField(field));
+        lines.append(quoted.join(","));
+    }
+    return file.write((lines.join("\r\n") + "\r\n").toUtf8()) >= 0;
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Checks many disk images for bad sectors and the files they damage
+
+#pragma once
+
+#include <vector>
+
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "BatchRunner.h"
+
+// Every image is loaded, its container is checked the way "Container Info" does it (sector CRCs
+// and data markers), then bad sectors are mapped onto the file system the way "Filesystem Info"
+// does it. Findings are kept as the library reports them, with placeholders; translate() turns
+// them into text for people.
+//
+// A record of every finished image is appended to a checkpoint file at once, so a long run
+// that was stopped or crashed can be continued: resume() drops the images already checked.
+class IntegrityScanner : public BatchRunner
+{
+    Q_OBJECT
+
+public:
+    explicit IntegrityScanner(QObject *parent = nullptr);
+    ~IntegrityScanner() override;
+
+    void setOptions(const QString & root, const QString & checkpoint_file);
+
+    // Reads records of a previous run from the checkpoint and removes their images from the list.
+    // Images changed since then are checked again. Returns the number of images taken over.
+    int resume(QStringList & images);
+    const std::vector<QJsonObject> & resumed() const { return m_resumed; }
+
+    // The record of an image of the current run, empty if it was not checked
+    QJsonObject result(int index) const { return m_results[index]; }
+
+    // Available after finished(), with taken over and new records sorted by image
+    QJsonObject report() const { return m_report; }
+
+    // Writes CSV for *.csv file names and JSON otherwise. The checkpoint is removed
+    // once a complete report is written.
+    bool writeReport(const QString & file_name, QString & error) const;
+
+    static QString checkpointFileName(const QString & report_file) { return report_file + ".checkpoint"; }
+    static bool isDamaged(const QJsonObject & record) { return record["status"].toString() == "damaged"; }
+    static QStringList translate(const QJsonArray & findings);
+
+protected:
+    dsk_tools::Result processItem(int index, const QString & item, QString & message) override;
+    bool beforeStart(QString & error) override;
+    void afterFinish() override;
+
+private slots:
+    void onItemFinished(int index, const QString & item, bool ok, const QString & message);
+
+private:
+    QString m_root;
+    QString m_checkpoint_file;
+    QFile m_checkpoint;
+
+    std::vector<QJsonObject> m_resumed;
+    std::vector<QJsonObject> m_results;     // One slot per image, each written by its own worker only
+    QJsonObject m_report;
+
+    bool writeCsv(QFile & file) const;
+};
@@ -0,0 +1,638 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Runs declarative JSON jobs over many disk images
+
+#include "JobRunner.h"
+#include "ImageUtils.h"
+#include "ViewerText.h"
+#include "ViewerRegistry.h"
+#include "ErrorText.h"
+#include "stringutils.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+// ==========================================================================
+// Helpers
+
+namespace {
+
+const int MAX_DEPTH = 10;   // The same limit as FileOperations::putFiles()
+
+QString actionName(JobStep::Action action)
+{
+    switch (action) {
+        case JobStep::Action::Extract:  return "extract";
+        case JobStep::Action::Delete:   return "delete";
+        case JobStep::Action::SaveAs:   return "save_as";
+        case JobStep::Action::Save:     return "save";
+    }
+    return QString();
+}
+
+bool hasWildcards(const QString & s)
+{
+    return s.contains('*') || s.contains('?') || s.contains('[');
+}
+
+dsk_tools::Result writeOutput(const QString & file_name, const dsk_tools::BYTES & data, bool overwrite)
+{
+    if (!overwrite && QFileInfo(file_name).exists())
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::FileAlreadyExists, _toStdString(QDir::toNativeSeparators(file_name)));
+    QDir().mkpath(QFileInfo(file_name).absolutePath());
+    return ImageUtils::writeFile(_toStdString(file_name), data);
+}
+
+} // namespace
+
+// ==========================================================================
+// Loading
+
+JobRunner::JobRunner(const QJsonObject & file_formats, const QJsonObject & file_types, QObject *parent)
+    : BatchRunner(parent)
+    , m_file_formats(file_formats)
+    , m_file_types(file_types)
+{}
+
+JobRunner::~JobRunner()
+{
+    stop();
+}
+
+bool JobRunner::load(const QString & job_file, QString & error)
+{
+    m_steps.clear();
+    m_plans.clear();
+
+    QFile file(job_file);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = tr("Cannot open job file '%1'").arg(QDir::toNativeSeparators(job_file));
+        return false;
+    }
+    QJsonParseError parse_error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parse_error);
+    if (parse_error.error != QJsonParseError::NoError || !doc.isObject()) {
+        error = tr("Job file error at offset %1: %2").arg(parse_error.offset).arg(parse_error.errorString());
+        return false;
+    }
+    const QJsonObject root = doc.object();
+
+    m_job_file = QFileInfo(job_file).absoluteFilePath();
+    m_base_dir = QFileInfo(job_file).absolutePath();
+    const QDir base(m_base_dir);
+    m_output_dir = QDir::cleanPath(base.absoluteFilePath(root["output"].toString(".")));
+    m_report_file = root["report"].toString();
+    if (!m_report_file.isEmpty()) m_report_file = QDir::cleanPath(base.absoluteFilePath(m_report_file));
+    m_threads = root["threads"].toInt(0);
+
+    // Tasks run in "order", ties are broken by id so the result does not depend on JSON key order
+    const QJsonObject tasks = root["tasks"].toObject();
+    if (tasks.isEmpty()) {
+        error = tr("The job has no tasks");
+        return false;
+    }
+    QStringList task_ids = tasks.keys();
+    std::stable_sort(task_ids.begin(), task_ids.end(), [&tasks](const QString & a, const QString & b) {
+        return tasks[a].toObject()["order"].toInt() < tasks[b].toObject()["order"].toInt();
+    });
+
+    std::map<QString, int> plan_index;     // canonical path -> index in m_plans
+    foreach (const QString & task_id, task_ids) {
+        const QJsonObject task = tasks[task_id].toObject();
+
+        std::vector<int> task_steps;
+        foreach (const QJsonValue & value, task["steps"].toArray()) {
+            JobStep step;
+            if (!parseStep(value.toObject(), task_id, step, error)) return false;
+            task_steps.push_back(static_cast<int>(m_steps.size()));
+            m_steps.push_back(step);
+        }
+        if (task_steps.empty()) {
+            error = tr("Task '%1' has no steps").arg(task_id);
+            return false;
+        }
+
+        std::vector<std::pair<QString, QString>> images;
+        if (!resolveImages(task["images"], task_id, images, error)) return false;
+
+        for (const auto & image : images) {
+            // The same disk reached through different globs or links is loaded once
+            QString key = QFileInfo(image.first).canonicalFilePath();
+            if (key.isEmpty()) key = image.first;
+            auto it = plan_index.find(key);
+            if (it == plan_index.end()) {
+                ImagePlan plan;
+                plan.image = image.first;
+                plan.relative_dir = image.second;
+                it = plan_index.insert(std::make_pair(key, static_cast<int>(m_plans.size()))).first;
+                m_plans.push_back(plan);
+            }
+            ImagePlan & plan = m_plans[it->second];
+            for (int index : task_steps) {
+                plan.steps.push_back(index);
+                const JobStep & step = m_steps[index];
+                if (step.action != JobStep::Action::SaveAs || step.volume_id < 0)
+                    plan.needs_filesystem = true;
+            }
+        }
+    }
+
+    if (m_plans.empty()) {
+        error = tr("No images match the job");
+        return false;
+    }
+
+    // Snapshots for workers, see BatchConverter::beforeStart()
+    m_extensions.clear();
+    foreach (const QString & format_id, m_file_formats.keys()) {
+        m_extensions[format_id] = ImageUtils::formatExtension(m_file_formats, format_id);
+    }
+    m_targets.clear();
+    foreach (const QString & type_id, m_file_types.keys()) {
+        std::set<std::string> & targets = m_targets[type_id.toStdString()];
+        foreach (const QJsonValue & target, m_file_types[type_id].toObject()["targets"].toArray()) {
+            targets.insert(target.toString().toStdString());
+        }
+    }
+
+    // Viewers are registered here, on the calling thread, and only created by workers
+    ViewerRegistry::instance();
+
+    return true;
+}
+
+bool JobRunner::parseStep(const QJsonObject & obj, const QString & task_id, JobStep & step, QString & error) const
+{
+    const QString action = obj["action"].toString();
+    if (action == "extract")        step.action = JobStep::Action::Extract;
+    else if (action == "delete")    step.action = JobStep::Action::Delete;
+    else if (action == "save_as")   step.action = JobStep::Action::SaveAs;
+    else if (action == "save")      step.action = JobStep::Action::Save;
+    else {
+        error = tr("Task '%1': unknown action '%2'").arg(task_id, action);
+        return false;
+    }
+
+    step.task_id = task_id;
+    step.files = obj["files"].toString("*");
+    step.recursive = obj["recursive"].toBool(false);
+    step.as = obj["as"].toString("raw");
+    step.encoding = obj["encoding"].toString("agat").toStdString();
+    step.format = obj["format"].toString();
+    step.to = obj["to"].toString();
+    step.overwrite = obj["overwrite"].toBool(false);
+    step.backup = obj["backup"].toBool(true);
+
+    const QJsonValue types = obj["types"];
+    if (types.isString()) {
+        step.types.insert(types.toString().toStdString());
+    } else {
+        foreach (const QJsonValue & type, types.toArray()) step.types.insert(type.toString().toStdString());
+    }
+
+    const QString volume = obj["volume_id"].toString("auto");
+    if (volume != "auto") {
+        bool ok = false;
+        step.volume_id = QString(volume).remove('$').toInt(&ok, 16);
+        if (!ok || step.volume_id < 0 || step.volume_id > 255) {
+            error = tr("Task '%1': wrong volume ID '%2'").arg(task_id, volume);
+            return false;
+        }
+    }
+
+    if (step.action == JobStep::Action::SaveAs && !m_file_formats.contains(step.format)) {
+        error = tr("Task '%1': unknown format '%2'").arg(task_id, step.format);
+        return false;
+    }
+    if (step.action == JobStep::Action::Extract && step.as != "raw" && step.as != "text"
+        && !step.as.startsWith("FILE_")) {
+        error = tr("Task '%1': unknown output type '%2'").arg(task_id, step.as);
+        return false;
+    }
+    return true;
+}
+
+bool JobRunner::resolveImages(const QJsonValue & spec, const QString & task_id,
+                              std::vector<std::pair<QString, QString>> & images, QString & error) const
+{
+    QStringList patterns;
+    if (spec.isString()) {
+        patterns.append(spec.toString());
+    } else {
+        foreach (const QJsonValue & value, spec.toArray()) patterns.append(value.toString());
+    }
+    if (patterns.isEmpty()) {
+        error = tr("Task '%1' has no images").arg(task_id);
+        return false;
+    }
+
+    const QDir base(m_base_dir);
+    foreach (const QString & pattern, patterns) {
+        const QString path = QDir::cleanPath(base.absoluteFilePath(QDir::fromNativeSeparators(pattern)));
+        const int slash = path.lastIndexOf('/');
+        QString dir = path.left(slash);
+        const QString mask = path.mid(slash + 1);
+
+        // "dir/**/*.dsk" is the only form with wildcards above the file name
+        bool recursive = false;
+        if (dir.endsWith("/**")) {
+            dir.chop(3);
+            recursive = true;
+        }
+        if (hasWildcards(dir)) {
+            error = tr("Task '%1': wildcards are only supported in file names and as '**': %2").arg(task_id, pattern);
+            return false;
+        }
+
+        if (!hasWildcards(mask) && !recursive) {
+            if (!QFileInfo(path).isFile()) {
+                error = tr("Task '%1': image not found: %2").arg(task_id, QDir::toNativeSeparators(path));
+                return false;
+            }
+            images.push_back(std::make_pair(path, QString()));
+            continue;
+        }
+
+        foreach (const QString & file, ImageUtils::collectImages(dir, mask.split(';'), recursive)) {
+            QString relative = QDir(dir).relativeFilePath(QFileInfo(file).absolutePath());
+            if (relative == ".") relative.clear();
+            images.push_back(std::make_pair(file, relative));
+        }
+    }
+    return true;
+}
+
+QStringList JobRunner::images() const
+{
+    QStringList result;
+    for (const ImagePlan & plan : m_plans) result.append(plan.image);
+    return result;
+}
+
+QString JobRunner::expandPath(const QString & pattern, const ImagePlan & plan, const QString & task_id) const
+{
+    QString result = pattern;
+    result.replace("{output}", m_output_dir)
+          .replace("{image}", QFileInfo(plan.image).completeBaseName())
+          .replace("{path}", plan.relative_dir)
+          .replace("{task}", task_id);
+    return QDir::cleanPath(QDir(m_base_dir).absoluteFilePath(result));
+}
+
+QString JobRunner::outputPath(const JobStep & step, const ImagePlan & plan) const
+{
+    switch (step.action) {
+        case JobStep::Action::Extract:
+            return expandPath(step.to.isEmpty() ? "{output}/{path}/{image}" : step.to, plan, step.task_id);
+        case JobStep::Action::SaveAs: {
+            const auto ext = m_extensions.find(step.format);
+            QString pattern = step.to.isEmpty() ? "{output}/{path}/{image}.{ext}" : step.to;
+            pattern.replace("{ext}", ext != m_extensions.end() ? ext->second : QString());
+            return expandPath(pattern, plan, step.task_id);
+        }
+        default:
+            return QString();
+    }
+}
+
+bool JobRunner::resolveOutputs(QString & error)
+{
+    // Outputs are fixed before any worker runs. {image} is the base name only, so "game.dsk" and
+    // "game.po" would otherwise be written to the same place by two workers at once.
+    std::map<QString, int> inputs;      // path key -> plan
+    for (size_t i = 0; i < m_plans.size(); i++) inputs[ImageUtils::pathKey(m_plans[i].image)] = static_cast<int>(i);
+
+    std::map<QString, int> files;       // save_as outputs, path key -> plan
+    std::map<QString, int> dirs;        // extract directories, path key -> plan
+    for (size_t i = 0; i < m_plans.size(); i++) {
+        ImagePlan & plan = m_plans[i];
+        plan.outputs.clear();
+        for (int step_index : plan.steps) {
+            const JobStep & step = m_steps[step_index];
+            const QString output = outputPath(step, plan);
+            plan.outputs.push_back(output);
+            if (output.isEmpty()) continue;
+
+            const QString key = ImageUtils::pathKey(output);
+            if (inputs.count(key)) {
+                error = tr("Task '%1': '%2' would overwrite a source image").arg(step.task_id, QDir::toNativeSeparators(output));
+                return false;
+            }
+
+            // Steps of one image run one after another, but a file is never written twice;
+            // one image may extract to a directory several times
+            const bool is_file = step.action == JobStep::Action::SaveAs;
+            std::map<QString, int> & taken = is_file ? files : dirs;
+            const auto it = taken.find(key);
+            if (it != taken.end() && (is_file || it->second != static_cast<int>(i))) {
+                error = tr("Task '%1': '%2' and '%3' would both be written to '%4'").arg(
+                    step.task_id,
+                    QDir::toNativeSeparators(m_plans[it->second].image),
+                    QDir::toNativeSeparators(plan.image),
+                    QDir::toNativeSeparators(output)
+                );
+                return false;
+            }
+            taken[key] = static_cast<int>(i);
+        }
+    }
+    return true;
+}
+
+// ==========================================================================
+// Execution
+
+bool JobRunner::beforeStart(QString & error)
+{
+    if (static_cast<int>(m_plans.size()) != items().size()) {
+        error = tr("The job is not loaded");
+        return false;
+    }
+    if (!resolveOutputs(error)) return false;
+    m_results.assign(m_plans.size(), QJsonObject());
+    m_report = QJsonObject();
+    m_started = QDateTime::currentDateTime();
+    return true;
+}
+
+void JobRunner::afterFinish()
+{
+    QJsonArray images;
+    int succeeded = 0, failed = 0, cancelled = 0;
+    for (size_t i = 0; i < m_results.size(); i++) {
+        QJsonObject result = m_results[i];
+        if (result.isEmpty()) {
+            result["image"] = QDir::toNativeSeparators(m_plans[i].image);
+            result["status"] = QString("cancelled");
+        }
+        const QString status = result["status"].toString();
+        if (status == "ok") succeeded++;
+        else if (status == "cancelled") cancelled++;
+        else failed++;
+        images.append(result);
+    }
+
+    m_report["job"] = QDir::toNativeSeparators(m_job_file);
+    m_report["started"] = m_started.toString(Qt::ISODate);
+    m_report["elapsed_ms"] = static_cast<double>(m_started.msecsTo(QDateTime::currentDateTime()));
+    m_report["images_total"] = static_cast<int>(m_results.size());
+    m_report["images_ok"] = succeeded;
+    m_report["images_failed"] = failed;
+    m_report["images_cancelled"] = cancelled;
+    m_report["images"] = images;
+}
+
+bool JobRunner::writeReport(const QString & file_name, QString & error) const
+{
+    QDir().mkpath(QFileInfo(file_name).absolutePath());
+    QFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = tr("Cannot write report '%1'").arg(QDir::toNativeSeparators(file_name));
+        return false;
+    }
+    file.write(QJsonDocument(m_report).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+dsk_tools::Result JobRunner::processItem(int index, const QString & item, QString & message)
+{
+    const ImagePlan & plan = m_plans[index];
+
+    QJsonObject result;
+    result["image"] = QDir::toNativeSeparators(item);
+
+    LoadedImage loaded;
+    dsk_tools::Result res = ImageUtils::openImage(_toStdString(item), loaded, false);
+    if (res && plan.needs_filesystem) res = ImageUtils::openFileSystem(loaded);
+    result["format"] = QString::fromStdString(loaded.format_id);
+    result["type"] = QString::fromStdString(loaded.type_id);
+    result["filesystem"] = QString::fromStdString(loaded.filesystem_id);
+    if (!res) {
+        message = ErrorText::decode(res);
+        result["status"] = QString("error");
+        result["message"] = message;
+        m_results[index] = result;
+        return res;
+    }
+
+    QJsonArray steps;
+    int failed = 0;
+    bool blocked = false;
+    for (size_t k = 0; k < plan.steps.size(); k++) {
+        const JobStep & step = m_steps[plan.steps[k]];
+        QJsonObject step_result;
+        step_result["task"] = step.task_id;
+        step_result["action"] = actionName(step.action);
+
+        if (isCancelled()) {
+            step_result["status"] = QString("cancelled");
+        } else if (blocked && step.isWriting()) {
+            // Never write an image whose modification went only half way
+            step_result["status"] = QString("skipped");
+            step_result["message"] = tr("A previous step modifying the image failed");
+        } else {
+            dsk_tools::Result step_res;
+            switch (step.action) {
+                case JobStep::Action::Extract:  step_res = runExtract(step, loaded, plan.outputs[k], step_result); break;
+                case JobStep::Action::Delete:   step_res = runDelete(step, loaded, step_result); break;
+                case JobStep::Action::SaveAs:   step_res = runSaveAs(step, loaded, plan.outputs[k], step_result); break;
+                case JobStep::Action::Save:     step_res = runSave(step, loaded, step_result); break;
+            }
+            if (step_res) {
+                step_result["status"] = QString("ok");
+            } else {
+                failed++;
+                if (step.isMutating()) blocked = true;
+                step_result["status"] = QString("error");
+                if (!step_result.contains("message")) step_result["message"] = ErrorText::decode(step_res);
+            }
+        }
+        steps.append(step_result);
+    }
+
+    result["steps"] = steps;
+    result["status"] = QString(failed ? "error" : "ok");
+    m_results[index] = result;
+
+    message = tr("%1 steps, %2 failed").arg(plan.steps.size()).arg(failed);
+    if (failed) return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteError, _toStdString(message));
+    return dsk_tools::Result::ok();
+}
+
+bool JobRunner::walk(dsk_tools::fileSystem * fs, const JobStep & step, const QString & path, int depth, const FileVisitor & fn) const
+{
+    dsk_tools::Files files;
+    if (!fs->dir(files, false)) return true;
+
+    const QStringList masks = step.files.split(';');
+    foreach (const dsk_tools::UniversalFile & f, files) {
+        const QString name = QString::fromStdString(f.name);
+        if (f.is_dir) {
+            if (!step.recursive || f.name == ".." || depth >= MAX_DEPTH) continue;
+            fs->cd(f);
+            const bool go_on = walk(fs, step, path.isEmpty() ? name : path + "/" + name, depth + 1, fn);
+            fs->cd_up();
+            if (!go_on) return false;
+        } else if (ImageUtils::matchMasks(masks, name)) {
+            if (!fn(f, path)) return false;
+        }
+    }
+    return true;
+}
+
+dsk_tools::Result JobRunner::runExtract(const JobStep & step, LoadedImage & loaded, const QString & out_dir, QJsonObject & result) const
+{
+    const std::string format = step.as.startsWith("FILE_") ? step.as.toStdString() : std::string();
+    QString extension;
+    if (!format.empty()) {
+        const auto ext = m_extensions.find(step.as);
+        if (ext != m_extensions.end() && ext->second != "*") extension = ext->second;
+    }
+
+    QJsonArray files;
+    int errors = 0;
+    walk(loaded.filesystem.get(), step, QString(), 0, [&](const dsk_tools::UniversalFile & f, const QString & path) -> bool {
+        const QString name = path.isEmpty() ? QString::fromStdString(f.name) : path + "/" + QString::fromStdString(f.name);
+        QJsonObject file;
+        file["name"] = name;
+
+        dsk_tools::BYTES data;
+        dsk_tools::Result res = loaded.filesystem->get_file(f, format, data);
+        if (!res) {
+            file["error"] = ErrorText::decode(res);
+            files.append(file);
+            errors++;
+            return !isCancelled();
+        }
+
+        std::string type, subtype;
+        ViewerRegistry::suggest(f, data, type, subtype);
+        if (!step.types.empty() && step.types.count(type) == 0) return !isCancelled();
+        file["type"] = QString::fromStdString(type);
+
+        QString host_name = ImageUtils::hostFileName(QString::fromStdString(f.name));
+        if (step.as == "text") {
+            std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create(type, subtype);
+            if (!viewer || viewer->get_output_type() != dsk_tools::ViewerOutput::Text)
+                viewer = dsk_tools::ViewerManager::instance().create("TEXT", "");
+            if (!viewer) {
+                file["error"] = tr("No text viewer");
+                files.append(file);
+                errors++;
+                return !isCancelled();
+            }
+            const std::string text = ViewerText::toPlainText(viewer->process_as_text(data, step.encoding));
+            data.assign(text.begin(), text.end());
+            host_name += ".txt";
+        } else if (!extension.isEmpty()) {
+            host_name += "." + extension;
+        }
+
+        QString output = out_dir;
+        if (!path.isEmpty()) {
+            foreach (const QString & part, path.split('/')) output += "/" + ImageUtils::hostFileName(part);
+        }
+        output += "/" + host_name;
+
+        res = writeOutput(output, data, step.overwrite);
+        if (res) {
+            file["output"] = QDir::toNativeSeparators(output);
+        } else {
+            file["error"] = ErrorText::decode(res);
+            errors++;
+        }
+        files.append(file);
+        return !isCancelled();
+    });
+
+    result["files"] = files;
+    if (errors) {
+        result["message"] = tr("%1 of %2 files failed").arg(errors).arg(files.size());
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteError, _toStdString(result["message"].toString()));
+    }
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result JobRunner::runDelete(const JobStep & step, LoadedImage & loaded, QJsonObject & result) const
+{
+    QJsonArray files;
+    int errors = 0;
+    walk(loaded.filesystem.get(), step, QString(), 0, [&](const dsk_tools::UniversalFile & f, const QString & path) -> bool {
+        QJsonObject file;
+        file["name"] = path.isEmpty() ? QString::fromStdString(f.name) : path + "/" + QString::fromStdString(f.name);
+        const dsk_tools::Result res = loaded.filesystem->delete_file(f);
+        if (!res) {
+            file["error"] = ErrorText::decode(res);
+            errors++;
+        }
+        files.append(file);
+        // A half-done deletion must not continue, the following writes are skipped anyway
+        return res && !isCancelled();
+    });
+
+    result["files"] = files;
+    if (errors) {
+        result["message"] = tr("Error deleting file '%1'").arg(files.last().toObject()["name"].toString());
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteError, _toStdString(result["message"].toString()));
+    }
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result JobRunner::runSaveAs(const JobStep & step, LoadedImage & loaded, const QString & output, QJsonObject & result) const
+{
+    const auto targets = m_targets.find(loaded.type_id);
+    if (targets == m_targets.end() || targets->second.count(step.format.toStdString()) == 0) {
+        result["message"] = tr("Type '%1' cannot be saved in this format").arg(QString::fromStdString(loaded.type_id));
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, loaded.type_id);
+    }
+
+    uint8_t volume_id = 0xFE;
+    if (step.volume_id >= 0) {
+        volume_id = static_cast<uint8_t>(step.volume_id);
+    } else if (loaded.filesystem) {
+        const int fs_volume_id = loaded.filesystem->get_volume_id();
+        if (fs_volume_id > 0) volume_id = static_cast<uint8_t>(fs_volume_id);
+    }
+
+    const auto writer = ImageUtils::createWriter(step.format, loaded.image.get(), volume_id);
+    if (!writer) return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, step.format.toStdString());
+
+    dsk_tools::BYTES buffer;
+    dsk_tools::Result res = writer->write(buffer);
+    if (!res) return res;
+
+    res = writeOutput(output, buffer, step.overwrite);
+    if (!res) return res;
+
+    result["output"] = QDir::toNativeSeparators(output);
+    if (step.format != "FILE_RAW_MSB") result["volume_id"] = QString::fromStdString(dsk_tools::int_to_hex(volume_id));
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result JobRunner::runSave(const JobStep & step, LoadedImage & loaded, QJsonObject & result) const
+{
+    // The same restriction as the Save command: only raw images are written in place
+    if (loaded.format_id != "FILE_RAW_MSB") {
+        result["message"] = tr("Only raw images can be saved in place, use save_as");
+        return dsk_tools::Result::error(dsk_tools::ErrorCode::WriteUnsupported, loaded.format_id);
+    }
+    if (loaded.filesystem && !loaded.filesystem->get_changed()) {
+        result["message"] = tr("Not changed");
+        return dsk_tools::Result::ok();
+    }
+
+    QString backup;
+    const dsk_tools::Result res = ImageUtils::saveInPlace(loaded, step.backup, backup);
+    if (!backup.isEmpty()) result["backup"] = QDir::toNativeSeparators(backup);
+    if (!res) return res;
+
+    result["output"] = QDir::toNativeSeparators(QString::fromStdString(loaded.file_name));
+    return dsk_tools::Result::ok();
+}
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Runs declarative JSON jobs over many disk images
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+
+#include "BatchRunner.h"
+
+struct LoadedImage;
+
+struct JobStep {
+    enum class Action {
+        Extract,        // Copy files out of the image
+        Delete,         // Delete files inside the image
+        SaveAs,         // Write the image in another container format
+        Save            // Write a raw image back in place
+    };
+
+    Action action {Action::Extract};
+    QString task_id;
+    QString files {"*"};            // Name masks separated by ';'
+    bool recursive {false};         // Descend into subdirectories
+    std::set<std::string> types;    // Extract: viewer types to take ("BASIC", "TEXT", ...), empty = any
+    QString as {"raw"};             // Extract: "text", "raw" or a file format id ("FILE_FIL")
+    std::string encoding {"agat"};  // Extract as text: viewer encoding
+    QString format;                 // Save as: target format id
+    QString to;                     // Output path template
+    int volume_id {-1};             // Save as: -1 = from the file system
+    bool overwrite {false};
+    bool backup {true};             // Save: keep the previous file as name.N.ext
+
+    bool isMutating() const { return action == Action::Delete; }
+    bool isWriting() const { return action == Action::SaveAs || action == Action::Save; }
+};
+
+// Everything that happens to one image, in execution order. An image listed by several
+// tasks gets a single plan, so it is loaded once.
+struct ImagePlan {
+    QString image;
+    QString relative_dir;           // Relative to the root of the task that found it first
+    std::vector<int> steps;         // Indexes in JobRunner::m_steps
+    std::vector<QString> outputs;   // Per step: the extract directory or save_as file, set by beforeStart()
+    bool needs_filesystem {false};
+};
+
+class JobRunner : public BatchRunner
+{
+    Q_OBJECT
+
+public:
+    JobRunner(const QJsonObject & file_formats, const QJsonObject & file_types, QObject *parent = nullptr);
+    ~JobRunner() override;
+
+    // Parses the job and resolves image globs into per-image plans
+    bool load(const QString & job_file, QString & error);
+
+    QStringList images() const;
+    QString reportFileName() const { return m_report_file; }
+    int maxThreadsRequested() const { return m_threads; }
+
+    // Available after finished()
+    QJsonObject report() const { return m_report; }
+    bool writeReport(const QString & file_name, QString & error) const;
+
+protected:
+    dsk_tools::Result processItem(int index, const QString & item, QString & message) override;
+    bool beforeStart(QString & error) override;
+    void afterFinish() override;
+
+private:
+    const QJsonObject & m_file_formats;
+    const QJsonObject & m_file_types;
+
+    QString m_job_file;
+    QString m_base_dir;
+    QString m_output_dir;
+    QString m_report_file;
+    int m_threads {0};
+
+    std::vector<JobStep> m_steps;
+    std::vector<ImagePlan> m_plans;
+
+    // Read-only snapshots of the config for workers
+    std::map<QString, QString> m_extensions;                    // format_id -> extension
+    std::map<std::string, std::set<std::string>> m_targets;     // type_id -> allowed targets
+
+    std::vector<QJsonObject> m_results;     // One slot per image, each written by its own worker only
+    QJsonObject m_report;
+    QDateTime m_started;
+
+    bool parseStep(const QJsonObject & obj, const QString & task_id, JobStep & step, QString & error) const;
+    bool resolveImages(const QJsonValue & spec, const QString & task_id, std::vector<std::pair<QString, QString>> & images, QString & error) const;
+
+    QString expandPath(const QString & pattern, const ImagePlan & plan, const QString & task_id) const;
+    QString outputPath(const JobStep & step, const ImagePlan & plan) const;
+    bool resolveOutputs(QString & error);
+
+    dsk_tools::Result runExtract(const JobStep & step, LoadedImage & loaded, const QString & out_dir, QJsonObject & result) const;
+    dsk_tools::Result runDelete(const JobStep & step, LoadedImage & loaded, QJsonObject & result) const;
+    dsk_tools::Result runSaveAs(const JobStep & step, LoadedImage & loaded, const QString & output, QJsonObject & result) const;
+    dsk_tools::Result runSave(const JobStep & step, LoadedImage & loaded, QJsonObject & result) const;
+
+    // Calls fn for every file matching the step masks; the file system's current directory
+    // is the file's one during the call. Returns false if fn asked to stop.
+    typedef std::function<bool(const dsk_tools::UniversalFile &, const QString &)> FileVisitor;
+    bool walk(dsk_tools::fileSystem * fs, const JobStep & step, const QString & path, int depth, const FileVisitor & fn) const;
+};
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Nearest-neighbour upscaling of viewer pictures
+
+#include "PixelScaler.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PIXEL_SCALER_SSE2
+    // SSE2 is the baseline of x86-64. The AVX2 kernels are built with a target attribute
+    // and taken only when the CPU has AVX2, so default builds get them too.
+    #if defined(__GNUC__) || defined(__clang__)
+        #include <immintrin.h>
+        #define PIXEL_SCALER_AVX2
+        #define AVX2_FUNCTION __attribute__((target("avx2")))
+    #elif defined(_MSC_VER)
+        #include <immintrin.h>
+        #include <intrin.h>
+        #define PIXEL_SCALER_AVX2
+        #define AVX2_FUNCTION
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define PIXEL_SCALER_NEON
+#endif
+
+namespace {
+
+#if defined(PIXEL_SCALER_AVX2)
+// ============================================================================
+// AVX2 kernels, called only when cpu_has_avx2() is true
+
+bool cpu_has_avx2()
+{
+#if defined(__AVX2__)
+    return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, then the OS must save the YMM registers
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+const bool HAS_AVX2 = cpu_has_avx2();
+
+// Returns the number of source pixels written
+AVX2_FUNCTION int expand_spans_avx2(const uint32_t * src, uint32_t * dst, int src_width, int k)
+{
+    const int span = (k + 7) & ~7;
+    int x = 0;
+    for (; x * k + span <= src_width * k; x++) {
+        const __m256i v = _mm256_set1_epi32(static_cast<int>(src[x]));
+        for (int i = 0; i < k; i += 8)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * k + i), v);
+    }
+    return x;
+}
+
+// Returns the number of output pixels written
+AVX2_FUNCTION int expand_mapped_avx2(const uint32_t * src, uint32_t * dst, const int * xmap, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xmap + x));
+        const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(src), idx, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), v);
+    }
+    return x;
+}
+#endif
+
+// ============================================================================
+// Row expansion: one source row into one output row, 32 bits per pixel
+
+// Every source pixel is repeated k times. Vector stores may run past the end of the
+// pixel's span, the following pixels overwrite it; pixels whose stores would leave the row
+// are written by the scalar tail.
+void expand_row_integer(const uint32_t * src, uint32_t * dst, int src_width, int k)
+{
+    int x = 0;
+#if defined(PIXEL_SCALER_SSE2)
+    if (k == 2) {
+        for (; x + 4 <= src_width; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 2),     _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 2 + 4), _mm_unpackhi_epi32(v, v));
+        }
+    } else if (k == 4) {
+        for (; x + 4 <= src_width; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+            __m128i * d = reinterpret_cast<__m128i *>(dst + x * 4);
+            _mm_storeu_si128(d,     _mm_shuffle_epi32(v, 0x00));
+            _mm_storeu_si128(d + 1, _mm_shuffle_epi32(v, 0x55));
+            _mm_storeu_si128(d + 2, _mm_shuffle_epi32(v, 0xAA));
+            _mm_storeu_si128(d + 3, _mm_shuffle_epi32(v, 0xFF));
+        }
+    } else if (k > 2) {
+    #if defined(PIXEL_SCALER_AVX2)
+        if (HAS_AVX2) x = expand_spans_avx2(src, dst, src_width, k);
+    #endif
+        const int span = (k + 3) & ~3;
+        for (; x * k + span <= src_width * k; x++) {
+            const __m128i v = _mm_set1_epi32(static_cast<int>(src[x]));
+            for (int i = 0; i < k; i += 4)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * k + i), v);
+        }
+    }
+#elif defined(PIXEL_SCALER_NEON)
+    if (k == 2) {
+        for (; x + 4 <= src_width; x += 4) {
+            const uint32x4_t v = vld1q_u32(src + x);
+            const uint32x4x2_t z = vzipq_u32(v, v);
+            vst1q_u32(dst + x * 2,     z.val[0]);
+            vst1q_u32(dst + x * 2 + 4, z.val[1]);
+        }
+    } else if (k > 2) {
+        const int span = (k + 3) & ~3;
+        for (; x * k + span <= src_width * k; x++) {
+            const uint32x4_t v = vdupq_n_u32(src[x]);
+            for (int i = 0; i < k; i += 4)
+                vst1q_u32(dst + x * k + i, v);
+        }
+    }
+#endif
+    for (; x < src_width; x++) {
+        const uint32_t p = src[x];
+        uint32_t * d = dst + x * k;
+        for (int i = 0; i < k; i++) d[i] = p;
+    }
+}
+
+// Arbitrary factor: xmap holds the source column of every output column
+void expand_row_mapped(const uint32_t * src, uint32_t * dst, const int * xmap, int width)
+{
+    int x = 0;
+#if defined(PIXEL_SCALER_AVX2)
+    if (HAS_AVX2) x = expand_mapped_avx2(src, dst, xmap, width);
+#endif
+    // SSE2 and NEON have no gather, a plain loop is as fast there
+    for (; x < width; x++) dst[x] = src[xmap[x]];
+}
+
+} // namespace
+
+// ============================================================================
+// PixelScaler
+
+void PixelScaler::scale(const QImage & src, int width, int height, QImage & out)
+{
+    if (src.isNull() || width <= 0 || height <= 0) {
+        out = QImage();
+        return;
+    }
+
+    const QImage source = (src.format() == QImage::Format_RGBA8888) ? src : src.convertToFormat(QImage::Format_RGBA8888);
+    const int sw = source.width();
+    const int sh = source.height();
+
+    if (out.width() != width || out.height() != height || out.format() != QImage::Format_RGBA8888)
+        out = QImage(width, height, QImage::Format_RGBA8888);
+
+    // Output pixel centers are mapped to the source pixels they fall into
+    const int kx = (width % sw == 0) ? width / sw : 0;
+    std::vector<int> xmap;
+    if (kx == 0) {
+        xmap.resize(width);
+        for (int x = 0; x < width; x++)
+            xmap[x] = static_cast<int>((static_cast<int64_t>(2 * x + 1) * sw) / (2 * static_cast<int64_t>(width)));
+    }
+
+    const size_t row_bytes = static_cast<size_t>(width) * 4;
+    int prev_sy = -1;
+    const uchar * prev_row = nullptr;
+    for (int y = 0; y < height; y++) {
+        const int sy = static_cast<int>((static_cast<int64_t>(2 * y + 1) * sh) / (2 * static_cast<int64_t>(height)));
+        uchar * row = out.scanLine(y);
+        if (sy == prev_sy) {
+            // Vertical repeats are plain copies of the row above
+            std::memcpy(row, prev_row, row_bytes);
+        } else {
+            const uint32_t * s = reinterpret_cast<const uint32_t *>(source.constScanLine(sy));
+            uint32_t * d = reinterpret_cast<uint32_t *>(row);
+            if (kx) expand_row_integer(s, d, sw, kx);
+            else    expand_row_mapped(s, d, xmap.data(), width);
+            prev_sy = sy;
+        }
+        prev_row = row;
+    }
+}
+
+const char * PixelScaler::backend()
+{
+#if defined(PIXEL_SCALER_AVX2)
+    if (HAS_AVX2) return "AVX2";
+#endif
+#if defined(PIXEL_SCALER_SSE2)
+    return "SSE2";
+#elif defined(PIXEL_SCALER_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
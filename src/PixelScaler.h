@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Nearest-neighbour upscaling of viewer pictures
+
+#pragma once
+
+#include <QImage>
+
+class PixelScaler {
+public:
+    // Scales src to width x height without filtering and writes into out, which is reused when
+    // it already has the right size and format. Horizontal and vertical factors are independent,
+    // integer factors take the fast path and give the same pixels as
+    // QImage::scaled(width, height, Qt::IgnoreAspectRatio, Qt::FastTransformation).
+    static void scale(const QImage & src, int width, int height, QImage & out);
+
+    // The instruction set the row expander uses on this CPU
+    static const char * backend();
+};
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Hex view of the sectors of a disk image
+
+#include "SectorView.h"
+
+#include <algorithm>
+
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QScrollBar>
+
+namespace {
+
+const int MARGIN = 4;
+const char HEX[] = "0123456789ABCDEF";
+
+// "T034 H1 S15 +0F0  "
+const int ADDRESS_CHARS = 18;
+
+int charWidth(const QFontMetrics & fm)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 11, 0)
+    return fm.width(QLatin1Char('0'));
+#else
+    return fm.horizontalAdvance(QLatin1Char('0'));
+#endif
+}
+
+} // namespace
+
+SectorView::SectorView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    const QFontMetrics fm(font());
+    m_line_height = std::max(1, fm.lineSpacing());
+    m_char_width = std::max(1, charWidth(fm));
+}
+
+void SectorView::setImage(dsk_tools::diskImage * image)
+{
+    m_image = image;
+    m_heads = image ? image->get_heads() : 0;
+    m_tracks = image ? image->get_tracks() : 0;
+    m_sectors = image ? image->get_sectors() : 0;
+    m_sector_size = image ? image->get_sector_size() : 0;
+    m_rows_per_sector = std::max(1, (m_sector_size + ROW_BYTES - 1) / ROW_BYTES);
+    m_rows = (m_sector_size > 0) ? m_tracks * m_heads * m_sectors * m_rows_per_sector : 0;
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void SectorView::setEncoding(Charsets::Encoding encoding)
+{
+    m_encoding = encoding;
+    viewport()->update();
+}
+
+void SectorView::goTo(int track, int head, int sector)
+{
+    if (m_rows == 0) return;
+    track = qBound(0, track, m_tracks - 1);
+    head = qBound(0, head, m_heads - 1);
+    sector = qBound(0, sector, m_sectors - 1);
+    verticalScrollBar()->setValue(((track * m_heads + head) * m_sectors + sector) * m_rows_per_sector);
+}
+
+void SectorView::sectorOfRow(int row, int & track, int & head, int & sector, int & offset) const
+{
+    int index = row / m_rows_per_sector;
+    offset = (row % m_rows_per_sector) * ROW_BYTES;
+    sector = index % m_sectors;
+    index /= m_sectors;
+    head = index % m_heads;
+    track = index / m_heads;
+}
+
+int SectorView::visibleRows() const
+{
+    return std::max(1, viewport()->height() / m_line_height);
+}
+
+void SectorView::updateScrollBars()
+{
+    const int page = visibleRows();
+    verticalScrollBar()->setRange(0, std::max(0, m_rows - page));
+    verticalScrollBar()->setPageStep(page);
+    verticalScrollBar()->setSingleStep(1);
+
+    const int width = (ADDRESS_CHARS + ROW_BYTES * 3 + 2 + ROW_BYTES) * m_char_width + 2 * MARGIN;
+    horizontalScrollBar()->setRange(0, std::max(0, width - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(m_char_width);
+}
+
+void SectorView::resizeEvent(QResizeEvent * event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void SectorView::scrollContentsBy(int dx, int dy)
+{
+    QAbstractScrollArea::scrollContentsBy(dx, dy);
+    if (dy != 0 && m_rows > 0) {
+        int track, head, sector, offset;
+        sectorOfRow(verticalScrollBar()->value(), track, head, sector, offset);
+        emit positionChanged(track, head, sector);
+    }
+}
+
+void SectorView::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    painter.setFont(font());
+    painter.fillRect(viewport()->rect(), palette().base());
+    if (m_rows == 0) return;
+
+    const QFontMetrics fm(font());
+    const QColor text_color = palette().text().color();
+    const QColor address_color = palette().color(QPalette::Disabled, QPalette::Text);
+    const int left = MARGIN - horizontalScrollBar()->value();
+    const int first = verticalScrollBar()->value();
+    const int last = std::min(m_rows, first + visibleRows() + 1);
+    const char16_t * chars = Charsets::table(m_encoding);
+
+    QString hex(ROW_BYTES * 3, ' ');
+    QString text(ROW_BYTES, ' ');
+    for (int row = first; row < last; row++) {
+        int track, head, sector, offset;
+        sectorOfRow(row, track, head, sector, offset);
+        const int y = (row - first) * m_line_height;
+
+        // Sector data stays in the image, only the row on the screen is formatted
+        const uint8_t * data = m_image->get_sector_data(head, track, sector);
+        const int count = std::min(ROW_BYTES, m_sector_size - offset);
+        hex.fill(' ');
+        text.fill(' ');
+        for (int i = 0; i < count && data; i++) {
+            const uint8_t b = data[offset + i];
+            hex[i * 3] = QLatin1Char(HEX[b >> 4]);
+            hex[i * 3 + 1] = QLatin1Char(HEX[b & 0x0F]);
+            const char16_t c = chars[b];
+            text[i] = (c < 0x20 || c == 0x7F || c == 0xFFFD) ? QChar('.') : QChar(static_cast<ushort>(c));
+        }
+
+        if (offset == 0 && row != first) {
+            painter.setPen(address_color);
+            painter.drawLine(0, y, viewport()->width(), y);
+        }
+
+        const QString address = QString("T%1 H%2 S%3 +%4")
+                                    .arg(track, 3, 10, QChar('0'))
+                                    .arg(head)
+                                    .arg(sector, 2, 10, QChar('0'))
+                                    .arg(offset, 3, 16, QChar('0'))
+                                    .toUpper();
+        const int baseline = y + fm.ascent();
+        painter.setPen(address_color);
+        painter.drawText(left, baseline, address);
+        painter.setPen(text_color);
+        painter.drawText(left + ADDRESS_CHARS * m_char_width, baseline, hex);
+        painter.drawText(left + (ADDRESS_CHARS + ROW_BYTES * 3 + 2) * m_char_width, baseline, text);
+    }
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Hex view of the sectors of a disk image
+
+#pragma once
+
+#include <QAbstractScrollArea>
+
+#include "Charsets.h"
+#include "dsk_tools/dsk_tools.h"
+
+// Shows the whole image as rows of 16 bytes, sector after sector: tracks in order, sides
+// within a track, sectors within a side. Rows are read from the image when painted, so
+// nothing is copied and memory does not depend on the image size.
+class SectorView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    static const int ROW_BYTES = 16;
+
+    explicit SectorView(QWidget *parent = nullptr);
+
+    void setImage(dsk_tools::diskImage * image);
+    void setEncoding(Charsets::Encoding encoding);
+
+    // Scrolls so the sector is the first one on the screen
+    void goTo(int track, int head, int sector);
+
+signals:
+    // The sector of the first visible row
+    void positionChanged(int track, int head, int sector);
+
+protected:
+    void paintEvent(QPaintEvent * event) override;
+    void resizeEvent(QResizeEvent * event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    dsk_tools::diskImage * m_image {nullptr};
+    Charsets::Encoding m_encoding {Charsets::Agat};
+    int m_heads {0};
+    int m_tracks {0};
+    int m_sectors {0};
+    int m_sector_size {0};
+    int m_rows_per_sector {1};
+    int m_rows {0};
+    int m_line_height {1};
+    int m_char_width {1};
+
+    int visibleRows() const;
+    void updateScrollBars();
+    void sectorOfRow(int row, int & track, int & head, int & sector, int & offset) const;
+};
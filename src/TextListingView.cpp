@@ -0,0 +1,506 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Virtualized view of text viewers output
+
+#include "TextListingView.h"
+
+#include <algorithm>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFontMetrics>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStringList>
+
+#include "ViewerText.h"
+
+namespace {
+
+const int MARGIN = 4;
+const int TAB_SIZE = 8;
+
+int textWidth(const QFontMetrics & fm, const QString & text)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 11, 0)
+    return fm.width(text);
+#else
+    return fm.horizontalAdvance(text);
+#endif
+}
+
+int eventY(const QMouseEvent * event)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    return event->pos().y();
+#else
+    return event->position().toPoint().y();
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// TextStyles
+
+void TextStyles::setStyleSheet(const QString & css)
+{
+    styles.assign(1, Style());
+    styles[0].color = QColor(Qt::black);
+    styles[0].background = QColor(Qt::white);
+    m_rules.clear();
+    m_composed.clear();
+
+    font = QFont(QStringLiteral("Consolas"));
+    font.setStyleHint(QFont::Monospace);
+    font.setPointSize(11);
+
+    // Only what basic.css uses: "selector[, selector] { property: value; ... }"
+    const QStringList rules = css.split('}');
+    for (const QString & rule : rules) {
+        const int brace = rule.indexOf('{');
+        if (brace < 0) continue;
+
+        Style style;
+        QString family;
+        double size = 0;
+        const QStringList declarations = rule.mid(brace + 1).split(';');
+        for (const QString & declaration : declarations) {
+            const int colon = declaration.indexOf(':');
+            if (colon < 0) continue;
+            const QString property = declaration.left(colon).trimmed().toLower();
+            const QString value = declaration.mid(colon + 1).trimmed();
+            if (property == "color")
+                style.color = QColor(value);
+            else if (property == "background-color" || property == "background")
+                style.background = QColor(value);
+            else if (property == "font-family")
+                family = value.split(',').first().trimmed().remove('\'').remove('"');
+            else if (property == "font-size" && value.endsWith("pt"))
+                size = value.left(value.size() - 2).toDouble();
+        }
+
+        const QStringList selectors = rule.left(brace).split(',');
+        for (const QString & s : selectors) {
+            const QString selector = s.trimmed();
+            if (selector == "body") {
+                if (style.color.isValid()) styles[0].color = style.color;
+                if (style.background.isValid()) styles[0].background = style.background;
+                if (!family.isEmpty()) font.setFamily(family);
+                if (size > 0) font.setPointSizeF(size);
+            } else if (selector.startsWith('.')) {
+                m_rules[selector.mid(1)] = style;
+            }
+        }
+    }
+}
+
+int TextStyles::styleForClasses(const QString & classes, int parent)
+{
+    if (classes.isEmpty()) return parent;
+
+    const QString key = QString::number(parent) + "|" + classes;
+    const auto found = m_composed.constFind(key);
+    if (found != m_composed.constEnd()) return found.value();
+
+    // Nested spans inherit the color, a background is painted over the parent's one
+    Style style = styles[parent];
+    bool changed = false;
+    const QStringList names = classes.split(' ');
+    for (const QString & name : names) {
+        const auto rule = m_rules.constFind(name);
+        if (rule == m_rules.constEnd()) continue;
+        if (rule.value().color.isValid()) { style.color = rule.value().color; changed = true; }
+        if (rule.value().background.isValid()) { style.background = rule.value().background; changed = true; }
+    }
+
+    int index = parent;
+    if (changed) {
+        index = static_cast<int>(styles.size());
+        styles.push_back(style);
+    }
+    m_composed.insert(key, index);
+    return index;
+}
+
+// ============================================================================
+// TextListing
+
+void TextListing::clear()
+{
+    text.clear();
+    spans.clear();
+    lines.clear();
+    max_length = 0;
+}
+
+QString TextListing::lineText(int index) const
+{
+    const Line & line = lines[index];
+    if (line.span_count == 0) return QString();
+    const Span & first = spans[line.first_span];
+    return text.mid(first.start, line.length);
+}
+
+void TextListing::setHtml(const std::string & source, TextStyles & styles)
+{
+    clear();
+    const QString html = QString::fromStdString(source);
+    text.reserve(html.size());
+
+    std::vector<int> stack(1, 0);
+    Line line {0, 0, 0};
+    bool after_br = false;
+
+    auto append = [&](const QString & s) {
+        if (s.isEmpty()) return;
+        const int style = stack.back();
+        const int length = static_cast<int>(s.size());
+        if (line.span_count > 0 && spans.back().style == style) {
+            spans.back().length += length;
+        } else {
+            if (line.span_count == 0) line.first_span = static_cast<int>(spans.size());
+            spans.push_back(Span{static_cast<int>(text.size()), length, style});
+            line.span_count++;
+        }
+        text += s;
+        line.length += length;
+    };
+    auto end_line = [&]() {
+        lines.push_back(line);
+        max_length = std::max(max_length, line.length);
+        line = Line{static_cast<int>(spans.size()), 0, 0};
+    };
+
+    // Mirrors ViewerText::toPlainText(), so copied and saved text has the same lines
+    int i = 0;
+    const int n = static_cast<int>(html.size());
+    QString run;
+    while (i < n) {
+        const QChar c = html[i];
+        if (c == '<' || c == '&' || c == '\n' || c == '\t') {
+            append(run);
+            run.clear();
+        }
+
+        if (c == '<') {
+            const int close = html.indexOf('>', i);
+            if (close < 0) break;
+            const QString tag = html.mid(i + 1, close - i - 1);
+
+            int p = 0;
+            QString name;
+            if (p < tag.size() && tag[p] == '/') name += tag[p++];
+            while (p < tag.size() && tag[p].isLetterOrNumber()) name += tag[p++].toLower();
+            const bool closing = name.startsWith('/');
+            const bool self_closing = tag.endsWith('/');
+
+            if (name == "br") {
+                end_line();
+                after_br = true;
+            } else if (name == "style" || name == "script" || name == "head") {
+                const int end = html.indexOf("</" + name, close, Qt::CaseInsensitive);
+                const int gt = (end < 0) ? -1 : html.indexOf('>', end);
+                i = (gt < 0) ? n : gt + 1;
+                continue;
+            } else {
+                if (name == "div" || name == "p" || name == "tr" || name == "li") {
+                    if (line.length > 0) end_line();
+                    after_br = false;
+                } else if (name == "/div" || name == "/p" || name == "/tr" || name == "/li") {
+                    if (!after_br) end_line();
+                    after_br = false;
+                }
+
+                if (closing) {
+                    if (stack.size() > 1) stack.pop_back();
+                } else if (!self_closing && !name.isEmpty()) {
+                    QString classes;
+                    const int attr = tag.indexOf("class=", p, Qt::CaseInsensitive);
+                    if (attr >= 0 && attr + 6 < tag.size()) {
+                        const QChar quote = tag[attr + 6];
+                        const int start = attr + 7;
+                        const int end = tag.indexOf(quote, start);
+                        if (end > 0) classes = tag.mid(start, end - start).simplified();
+                    }
+                    stack.push_back(styles.styleForClasses(classes, stack.back()));
+                }
+            }
+            i = close + 1;
+        } else if (c == '&') {
+            const int semi = html.indexOf(';', i);
+            std::string decoded;
+            if (semi >= 0 && semi - i <= 10
+                && ViewerText::decodeEntity(html.mid(i + 1, semi - i - 1).toStdString(), decoded)) {
+                append(QString::fromStdString(decoded));
+                i = semi + 1;
+            } else {
+                append(QString(c));
+                i++;
+            }
+            after_br = false;
+        } else if (c == '\n') {
+            end_line();
+            i++;
+        } else if (c == '\t') {
+            append(QString(TAB_SIZE - (line.length % TAB_SIZE), ' '));
+            after_br = false;
+            i++;
+        } else {
+            if (c != '\r') {
+                run += c;
+                after_br = false;
+            }
+            i++;
+        }
+    }
+    append(run);
+    if (line.span_count > 0) end_line();
+}
+
+// ============================================================================
+// TextListingView
+
+TextListingView::TextListingView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    updateMetrics();
+}
+
+void TextListingView::setListingStyleSheet(const QString & css)
+{
+    // Spans refer to composed styles, which a new stylesheet renumbers
+    if (css == m_css) return;
+    m_css = css;
+    m_styles.setStyleSheet(css);
+    for (TextListing & block : m_blocks) block.clear();
+    updateBlocks(0);
+    updateMetrics();
+    viewport()->update();
+}
+
+void TextListingView::setListing(const std::string & html, const QString & css)
+{
+    setListingStyleSheet(css);
+    clear();
+    appendBlock(html);
+}
+
+void TextListingView::clear()
+{
+    m_blocks.clear();
+    m_sel_start = m_sel_end = -1;
+    updateBlocks(0);
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+}
+
+int TextListingView::appendBlock(const std::string & html)
+{
+    m_blocks.push_back(TextListing());
+    m_blocks.back().setHtml(html, m_styles);
+    updateBlocks(blockCount() - 1);
+    return blockCount() - 1;
+}
+
+void TextListingView::setBlocks(const std::vector<TextListing> & blocks)
+{
+    m_blocks = blocks;
+    m_sel_start = m_sel_end = -1;
+    updateBlocks(0);
+}
+
+void TextListingView::replaceBlock(int index, const std::string & html)
+{
+    m_blocks[index].setHtml(html, m_styles);
+    updateBlocks(index);
+}
+
+void TextListingView::updateBlocks(int from)
+{
+    m_block_start.resize(m_blocks.size() + 1);
+    m_max_length = 0;
+    for (size_t i = 0; i < m_blocks.size(); i++) {
+        if (static_cast<int>(i) >= from)
+            m_block_start[i + 1] = m_block_start[i] + static_cast<int>(m_blocks[i].lines.size());
+        m_max_length = std::max(m_max_length, m_blocks[i].max_length);
+    }
+    if (m_sel_start >= lineCount()) m_sel_start = m_sel_end = -1;
+    else if (m_sel_end >= lineCount()) m_sel_end = lineCount() - 1;
+    updateScrollBars();
+    viewport()->update();
+}
+
+int TextListingView::blockOfLine(int line) const
+{
+    // m_block_start[0] is 0, so the result is never before the first block
+    const auto it = std::upper_bound(m_block_start.begin(), m_block_start.end(), line);
+    return static_cast<int>(it - m_block_start.begin()) - 1;
+}
+
+QString TextListingView::lineText(int line) const
+{
+    const int block = blockOfLine(line);
+    return m_blocks[block].lineText(line - m_block_start[block]);
+}
+
+int TextListingView::firstVisibleBlock() const
+{
+    if (m_blocks.empty()) return -1;
+    return blockOfLine(std::min(verticalScrollBar()->value(), std::max(0, lineCount() - 1)));
+}
+
+int TextListingView::lastVisibleBlock() const
+{
+    if (m_blocks.empty()) return -1;
+    const int last = std::min(verticalScrollBar()->value() + visibleLines(), lineCount()) - 1;
+    return blockOfLine(std::max(0, last));
+}
+
+QString TextListingView::toPlainText() const
+{
+    QStringList lines;
+    lines.reserve(lineCount());
+    for (int i = 0; i < lineCount(); i++)
+        lines.append(lineText(i));
+    return lines.join('\n');
+}
+
+QString TextListingView::selectedText() const
+{
+    if (m_sel_start < 0) return QString();
+    QStringList lines;
+    const int last = std::max(m_sel_start, m_sel_end);
+    for (int i = std::min(m_sel_start, m_sel_end); i <= last; i++)
+        lines.append(lineText(i));
+    return lines.join('\n');
+}
+
+void TextListingView::updateMetrics()
+{
+    const QFontMetrics fm(m_styles.font);
+    m_line_height = std::max(1, fm.lineSpacing());
+    m_char_width = std::max(1, textWidth(fm, QStringLiteral("W")));
+    updateScrollBars();
+}
+
+int TextListingView::visibleLines() const
+{
+    return std::max(1, viewport()->height() / m_line_height);
+}
+
+void TextListingView::updateScrollBars()
+{
+    const int page = visibleLines();
+    verticalScrollBar()->setRange(0, std::max(0, lineCount() - page));
+    verticalScrollBar()->setPageStep(page);
+    verticalScrollBar()->setSingleStep(1);
+
+    // The longest line by characters: exact for fixed pitch, close enough otherwise
+    const int width = m_max_length * m_char_width + 2 * MARGIN;
+    horizontalScrollBar()->setRange(0, std::max(0, width - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(m_char_width);
+}
+
+int TextListingView::lineAt(int y) const
+{
+    const int line = verticalScrollBar()->value() + std::max(0, y) / m_line_height;
+    return std::min(line, lineCount() - 1);
+}
+
+void TextListingView::resizeEvent(QResizeEvent * event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void TextListingView::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    const std::vector<TextStyles::Style> & styles = m_styles.styles;
+    painter.fillRect(viewport()->rect(), styles[0].background);
+    painter.setFont(m_styles.font);
+
+    const QFontMetrics fm(m_styles.font);
+    const int view_width = viewport()->width();
+    const int left = MARGIN - horizontalScrollBar()->value();
+    const int first = verticalScrollBar()->value();
+    const int last = std::min(lineCount(), first + visibleLines() + 1);
+    const int sel_first = std::min(m_sel_start, m_sel_end);
+    const int sel_last = std::max(m_sel_start, m_sel_end);
+
+    int block = (first < last) ? blockOfLine(first) : 0;
+    for (int i = first; i < last; i++) {
+        while (i >= m_block_start[block + 1]) block++;
+        const TextListing & listing = m_blocks[block];
+
+        const int y = (i - first) * m_line_height;
+        const bool selected = m_sel_start >= 0 && i >= sel_first && i <= sel_last;
+        if (selected) painter.fillRect(0, y, view_width, m_line_height, palette().highlight());
+
+        const TextListing::Line & line = listing.lines[i - m_block_start[block]];
+        int x = left;
+        for (int s = line.first_span; s < line.first_span + line.span_count && x < view_width; s++) {
+            const TextListing::Span & span = listing.spans[s];
+            const QString part = listing.text.mid(span.start, span.length);
+            const int w = textWidth(fm, part);
+            if (x + w > 0) {
+                const TextStyles::Style & style = styles[span.style];
+                if (!selected && style.background.isValid() && span.style != 0)
+                    painter.fillRect(x, y, w, m_line_height, style.background);
+                painter.setPen(selected ? palette().highlightedText().color() : style.color);
+                painter.drawText(x, y + fm.ascent(), part);
+            }
+            x += w;
+        }
+    }
+}
+
+void TextListingView::mousePressEvent(QMouseEvent * event)
+{
+    if (event->button() == Qt::LeftButton && lineCount() > 0) {
+        const int line = lineAt(eventY(event));
+        if (!(event->modifiers() & Qt::ShiftModifier) || m_sel_start < 0) m_sel_start = line;
+        m_sel_end = line;
+        viewport()->update();
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void TextListingView::mouseMoveEvent(QMouseEvent * event)
+{
+    if ((event->buttons() & Qt::LeftButton) && m_sel_start >= 0) {
+        const int y = eventY(event);
+        if (y < 0)
+            verticalScrollBar()->setValue(verticalScrollBar()->value() - 1);
+        else if (y >= viewport()->height())
+            verticalScrollBar()->setValue(verticalScrollBar()->value() + 1);
+        m_sel_end = lineAt(std::min(y, viewport()->height() - 1));
+        viewport()->update();
+    }
+    QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void TextListingView::keyPressEvent(QKeyEvent * event)
+{
+    if (event == QKeySequence::Copy) {
+        const QString text = (m_sel_start >= 0) ? selectedText() : toPlainText();
+        QApplication::clipboard()->setText(text);
+        return;
+    }
+    if (event == QKeySequence::SelectAll) {
+        if (lineCount() > 0) {
+            m_sel_start = 0;
+            m_sel_end = lineCount() - 1;
+            viewport()->update();
+        }
+        return;
+    }
+    QAbstractScrollArea::keyPressEvent(event);
+}
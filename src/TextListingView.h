@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Virtualized view of text viewers output
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QAbstractScrollArea>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QString>
+
+// Colors and font of the listing, from basic.css-like rules (".class { color: ...; }")
+struct TextStyles {
+    struct Style {
+        QColor color;               // Invalid: inherited
+        QColor background;          // Invalid: none
+    };
+
+    std::vector<Style> styles;      // 0 is the body style
+    QFont font;
+
+    TextStyles() { setStyleSheet(QString()); }
+    void setStyleSheet(const QString & css);
+
+    // Style of an element with the class attribute "classes" inside an element of style parent
+    int styleForClasses(const QString & classes, int parent);
+
+private:
+    QHash<QString, Style> m_rules;          // Class name -> its declarations
+    QHash<QString, int> m_composed;         // "parent|classes" -> index in styles
+};
+
+// Output of Viewer::process_as_text() as lines of styled spans over one text buffer
+struct TextListing {
+    struct Span {
+        int start;
+        int length;
+        int style;
+    };
+    struct Line {
+        int first_span;
+        int span_count;
+        int length;                 // Characters
+    };
+
+    QString text;
+    std::vector<Span> spans;
+    std::vector<Line> lines;
+    int max_length {0};
+
+    // Splits an HTML fragment into lines the same way ViewerText::toPlainText() does
+    void setHtml(const std::string & html, TextStyles & styles);
+
+    void clear();
+    QString lineText(int index) const;
+};
+
+// Lays out and paints only the visible lines, so long listings open and scroll at once.
+// Lines are selected with the mouse or the keyboard; copying gives plain text.
+class TextListingView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit TextListingView(QWidget *parent = nullptr);
+
+    void setListing(const std::string & html, const QString & css);
+    // Styles the spans of the listing, the widget itself is styled by QWidget::setStyleSheet
+    void setListingStyleSheet(const QString & css);
+    void clear();
+
+    // The listing may be built from consecutive blocks, e.g. decoded parts of a file.
+    // Blocks are appended or replaced without moving the view or dropping the selection.
+    int appendBlock(const std::string & html);
+    void replaceBlock(int index, const std::string & html);
+    int blockCount() const { return static_cast<int>(m_blocks.size()); }
+
+    // Laid out blocks stay valid for this view while its stylesheet is the same,
+    // so a listing shown before can be put back without parsing HTML again
+    const std::vector<TextListing> & blocks() const { return m_blocks; }
+    void setBlocks(const std::vector<TextListing> & blocks);
+    int lineCount() const { return m_block_start.back(); }
+
+    // Blocks with lines on the screen
+    int firstVisibleBlock() const;
+    int lastVisibleBlock() const;
+
+    QString toPlainText() const;
+    QString selectedText() const;
+
+protected:
+    void paintEvent(QPaintEvent * event) override;
+    void resizeEvent(QResizeEvent * event) override;
+    void mousePressEvent(QMouseEvent * event) override;
+    void mouseMoveEvent(QMouseEvent * event) override;
+    void keyPressEvent(QKeyEvent * event) override;
+
+private:
+    TextStyles m_styles;
+    QString m_css;
+    std::vector<TextListing> m_blocks;
+    std::vector<int> m_block_start {0};     // First line of every block, then the line count
+    int m_max_length {0};
+    int m_line_height {1};
+    int m_char_width {1};
+    int m_sel_start {-1};
+    int m_sel_end {-1};
+
+    void updateBlocks(int from);
+    int blockOfLine(int line) const;
+    QString lineText(int line) const;
+    void updateMetrics();
+    void updateScrollBars();
+    int lineAt(int y) const;
+    int visibleLines() const;
+};
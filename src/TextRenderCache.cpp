@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Process-wide cache of text viewers output and its stylesheet
+
+#include "TextRenderCache.h"
+#include "ViewerRegistry.h"
+
+#include <QCache>
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+
+namespace {
+
+// Cost is in kilobytes of HTML
+const int CACHE_KB = 32 * 1024;
+
+const char DOCUMENT_HEAD[] =
+    "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\" \"http://www.w3.org/TR/REC-html40/strict.dtd\">\r\n"
+    "<html><head><meta charset=\"utf-8\" /><style type=\"text/css\">";
+const char DOCUMENT_BODY[] =
+    "</style></head><body><div style=\"display: flex; flex-direction: column; gap: 0\">";
+const char DOCUMENT_TAIL[] =
+    "</div></body></html>";
+
+QCache<QString, TextRenderCache::Parts> & cache()
+{
+    static QCache<QString, TextRenderCache::Parts> outputs(CACHE_KB);
+    return outputs;
+}
+
+QString loadStyleSheet()
+{
+    QFile css_file(":/files/basic.css");
+    if (!css_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "Failed to load CSS file";
+        return QString();
+    }
+    QTextStream stream(&css_file);
+    return stream.readAll();
+}
+
+} // namespace
+
+const QString & TextRenderCache::styleSheet()
+{
+    static const QString css = loadStyleSheet();
+    return css;
+}
+
+QString TextRenderCache::document(const Parts & parts)
+{
+    // Everything is put together in UTF-8 and converted once
+    static const std::string head = std::string(DOCUMENT_HEAD) + styleSheet().toStdString() + DOCUMENT_BODY;
+
+    size_t size = head.size() + sizeof(DOCUMENT_TAIL);
+    for (const std::string & part : parts) size += part.size();
+
+    std::string html;
+    html.reserve(size);
+    html += head;
+    for (const std::string & part : parts) html += part;
+    html += DOCUMENT_TAIL;
+    return QString::fromStdString(html);
+}
+
+QString TextRenderCache::key(const dsk_tools::BYTES & data, const std::string & type,
+                             const std::string & subtype, const std::string & encoding)
+{
+    return QString("%1:%2|%3|%4|%5")
+        .arg(ViewerRegistry::contentHash(data), 16, 16, QChar('0'))
+        .arg(static_cast<qulonglong>(data.size()))
+        .arg(QString::fromStdString(type),
+             QString::fromStdString(subtype),
+             QString::fromStdString(encoding));
+}
+
+bool TextRenderCache::find(const QString & key, Parts & parts)
+{
+    const Parts * cached = cache().object(key);
+    if (!cached) return false;
+    parts = *cached;
+    return true;
+}
+
+void TextRenderCache::insert(const QString & key, const Parts & parts)
+{
+    size_t size = 0;
+    for (const std::string & part : parts) size += part.size();
+    cache().insert(key, new Parts(parts), static_cast<int>(qMax<size_t>(1, size / 1024)));
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Process-wide cache of text viewers output and its stylesheet
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QString>
+
+#include "dsk_tools/dsk_tools.h"
+
+class TextRenderCache
+{
+public:
+    typedef std::vector<std::string> Parts;     // HTML of the decoded parts of a file, in order
+
+    // basic.css, read from the resources once
+    static const QString & styleSheet();
+
+    // A standalone HTML document with the stylesheet and the parts as its body
+    static QString document(const Parts & parts);
+
+    // Identifies an output: file contents, viewer and encoding
+    static QString key(const dsk_tools::BYTES & data, const std::string & type,
+                       const std::string & subtype, const std::string & encoding);
+
+    // GUI thread only. Least recently used outputs are dropped first.
+    static bool find(const QString & key, Parts & parts);
+    static void insert(const QString & key, const Parts & parts);
+};
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Background rendering and caching of picture thumbnails
+
+#include "ThumbnailRenderer.h"
+#include "ViewerRegistry.h"
+
+#include <QCache>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+
+// Cost is in kilobytes, a 128 x 128 thumbnail is 64
+const int CACHE_KB = 64 * 1024;
+
+// Used from the GUI thread only
+QCache<QString, QImage> & cache()
+{
+    static QCache<QString, QImage> thumbnails(CACHE_KB);
+    return thumbnails;
+}
+
+class ThumbnailTask : public QRunnable
+{
+public:
+    ThumbnailTask(ThumbnailRenderer * renderer, int generation, const std::shared_ptr<QAtomicInt> & cancelled,
+                  int id, const QString & key, std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data)
+        : m_renderer(renderer)
+        , m_generation(generation)
+        , m_cancelled(cancelled)
+        , m_id(id)
+        , m_key(key)
+        , m_viewer(std::move(viewer))
+        , m_data(data)
+    {}
+
+    void run() override
+    {
+        if (m_cancelled->loadAcquire()) return;
+
+        int sx = 0, sy = 0;
+        const dsk_tools::BYTES pixels = m_viewer->process_picture(m_data, sx, sy, 0);
+        QImage thumbnail;
+        if (sx > 0 && sy > 0 && pixels.size() >= static_cast<size_t>(sx) * sy * 4) {
+            const QImage picture(pixels.data(), sx, sy, QImage::Format_RGBA8888);
+            // scaled() gives a new image, so the pixel buffer may go away
+            thumbnail = picture.scaled(ThumbnailRenderer::SIZE, ThumbnailRenderer::SIZE,
+                                       Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+
+        if (m_cancelled->loadAcquire()) return;
+        QMetaObject::invokeMethod(m_renderer, "onRendered", Qt::QueuedConnection,
+                                  Q_ARG(int, m_generation), Q_ARG(int, m_id),
+                                  Q_ARG(QString, m_key), Q_ARG(QImage, thumbnail));
+    }
+
+private:
+    ThumbnailRenderer * m_renderer;
+    int m_generation;
+    std::shared_ptr<QAtomicInt> m_cancelled;
+    int m_id;
+    QString m_key;
+    std::unique_ptr<dsk_tools::ViewerPic> m_viewer;
+    dsk_tools::BYTES m_data;
+};
+
+} // namespace
+
+ThumbnailRenderer::ThumbnailRenderer(QObject *parent)
+    : QObject(parent)
+    , m_cancelled(std::make_shared<QAtomicInt>(0))
+{
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+ThumbnailRenderer::~ThumbnailRenderer()
+{
+    // Queued onRendered() calls die with the object, but workers must not outlive it
+    cancel();
+    m_pool.waitForDone();
+}
+
+QString ThumbnailRenderer::key(const dsk_tools::BYTES & data, const std::string & name,
+                               const std::string & type, const std::string & subtype,
+                               const dsk_tools::ViewerSelectorValues & selectors)
+{
+    QString result = QString("%1:%2|%3|%4/%5")
+                         .arg(ViewerRegistry::contentHash(data), 16, 16, QChar('0'))
+                         .arg(static_cast<qulonglong>(data.size()))
+                         .arg(QString::fromStdString(name),
+                              QString::fromStdString(type),
+                              QString::fromStdString(subtype));
+    for (const auto & selector : selectors)
+        result += "|" + QString::fromStdString(selector.first) + "=" + QString::fromStdString(selector.second);
+    return result;
+}
+
+QImage ThumbnailRenderer::cached(const QString & key)
+{
+    const QImage * image = cache().object(key);
+    return image ? *image : QImage();
+}
+
+void ThumbnailRenderer::render(int id, const QString & key, std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data)
+{
+    m_pool.start(new ThumbnailTask(this, m_generation, m_cancelled, id, key, std::move(viewer), data));
+}
+
+void ThumbnailRenderer::cancel()
+{
+    // Running tasks keep the old flag and see it raised, new ones get a fresh one
+    m_cancelled->storeRelease(1);
+    m_cancelled = std::make_shared<QAtomicInt>(0);
+    m_generation++;
+    m_pool.clear();
+}
+
+void ThumbnailRenderer::onRendered(int generation, int id, const QString & key, const QImage & image)
+{
+    if (generation != m_generation) return;
+    if (!image.isNull())
+        cache().insert(key, new QImage(image), qMax(1, image.width() * image.height() * 4 / 1024));
+    emit thumbnailReady(id, image);
+}
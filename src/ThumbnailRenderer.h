@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Background rendering and caching of picture thumbnails
+
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+#include "dsk_tools/dsk_tools.h"
+
+class ThumbnailRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int SIZE = 128;                    // Thumbnails fit into SIZE x SIZE
+
+    explicit ThumbnailRenderer(QObject *parent = nullptr);
+    ~ThumbnailRenderer() override;
+
+    // Identifies a thumbnail: file contents, file name, viewer and its selectors
+    static QString key(const dsk_tools::BYTES & data, const std::string & name,
+                       const std::string & type, const std::string & subtype,
+                       const dsk_tools::ViewerSelectorValues & selectors);
+
+    // Thumbnails are shared by all renderers and survive them, so a gallery opened again
+    // is shown at once. Null if the key is not cached.
+    static QImage cached(const QString & key);
+
+    // The viewer must be prepared and have its selectors set; it is used only by the worker.
+    // thumbnailReady(id, ...) comes later from the GUI thread, also for failed pictures.
+    void render(int id, const QString & key, std::unique_ptr<dsk_tools::ViewerPic> viewer, const dsk_tools::BYTES & data);
+
+    // Drops all queued and running requests, their results are not reported
+    void cancel();
+
+signals:
+    void thumbnailReady(int id, const QImage & image);
+
+private slots:
+    void onRendered(int generation, int id, const QString & key, const QImage & image);
+
+private:
+    QThreadPool m_pool;
+    std::shared_ptr<QAtomicInt> m_cancelled;
+    int m_generation {0};
+};
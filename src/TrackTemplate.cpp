@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A boot tracks template loaded once and shared between exports
+
+#include "TrackTemplate.h"
+#include "ImageUtils.h"
+
+dsk_tools::Result TrackTemplate::load(const std::string & file_name,
+                                      const std::string & target_id,
+                                      std::shared_ptr<const TrackTemplate> & out)
+{
+    out.reset();
+
+    std::shared_ptr<TrackTemplate> tmplt(new TrackTemplate());
+    dsk_tools::Result result = ImageUtils::readFile(file_name, tmplt->m_data);
+    if (!result) return result;
+
+    tmplt->m_file_name = file_name;
+
+    // Acceptance stays with Writer::substitute_tracks(), which checks size and type as Save As always
+    // did. Detection only learns the type early, so a batch can reject other images before loading
+    // them; a template detected as another format, or as nothing, is still used.
+    LoadedImage probe;
+    if (ImageUtils::detectImage(file_name, probe) && probe.format_id == target_id) {
+        tmplt->m_format_id = probe.format_id;
+        tmplt->m_type_id = probe.type_id;
+    }
+
+    out = tmplt;
+    return dsk_tools::Result::ok();
+}
+
+dsk_tools::Result TrackTemplate::apply(dsk_tools::Writer & writer, dsk_tools::BYTES & buffer, int numtracks) const
+{
+    return writer.substitute_tracks(buffer, m_data, numtracks);
+}
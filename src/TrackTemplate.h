@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A boot tracks template loaded once and shared between exports
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "dsk_tools/dsk_tools.h"
+
+class TrackTemplate {
+public:
+    // Reads the template; its type is known if it is detected as an image of target_id.
+    // The result is immutable, so one instance can be used by any number of worker threads.
+    static dsk_tools::Result load(const std::string & file_name,
+                                  const std::string & target_id,
+                                  std::shared_ptr<const TrackTemplate> & out);
+
+    const std::string & fileName() const { return m_file_name; }
+    const std::string & formatId() const { return m_format_id; }
+    const std::string & typeId() const { return m_type_id; }
+    const dsk_tools::BYTES & data() const { return m_data; }
+
+    // Images of another type can't take tracks from this template. With the type unknown
+    // every image is tried and substitute_tracks() decides.
+    bool isCompatible(const std::string & type_id) const { return m_type_id.empty() || type_id == m_type_id; }
+
+    // Replaces the first numtracks tracks of a written image with the template ones;
+    // size and type are checked by the writer, WriteIncorrectTemplate means the template does not fit
+    dsk_tools::Result apply(dsk_tools::Writer & writer, dsk_tools::BYTES & buffer, int numtracks) const;
+
+private:
+    TrackTemplate() = default;
+
+    std::string m_file_name;
+    std::string m_format_id;
+    std::string m_type_id;
+    dsk_tools::BYTES m_data;
+};
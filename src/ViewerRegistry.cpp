@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: One-time viewer registration and cached viewer matching
+
+#include "ViewerRegistry.h"
+
+#include <QMutexLocker>
+
+ViewerRegistry & ViewerRegistry::instance()
+{
+    static ViewerRegistry registry;
+    return registry;
+}
+
+ViewerRegistry::ViewerRegistry()
+{
+    dsk_tools::register_all_viewers();
+
+    dsk_tools::ViewerManager & manager = dsk_tools::ViewerManager::instance();
+    for (const auto & type : manager.list_types()) {
+        for (const std::pair<std::string, std::string> & subtype : manager.list_subtypes(type)) {
+            Prototype prototype;
+            prototype.type = type;
+            prototype.subtype = subtype.first;
+            prototype.viewer = manager.create(type, subtype.first);
+            if (prototype.viewer) m_prototypes.push_back(std::move(prototype));
+        }
+    }
+}
+
+quint64 ViewerRegistry::contentHash(const dsk_tools::BYTES & data)
+{
+    // FNV-1a, files on these disks are at most a few hundred kilobytes
+    quint64 hash = 14695981039346656037ULL;
+    for (const uint8_t b : data) {
+        hash ^= b;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+ViewerRegistry::FitMap ViewerRegistry::fits(const dsk_tools::BYTES & data)
+{
+    const Key key(contentHash(data), data.size());
+
+    {
+        QMutexLocker locker(&m_lock);
+        const auto it = m_cache.find(key);
+        if (it != m_cache.end() && it->second.data == data) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.fits;
+        }
+    }
+
+    FitMap result;
+    for (const Prototype & prototype : m_prototypes) {
+        if (prototype.viewer->fits(data)) result[prototype.type].push_back(prototype.subtype);
+    }
+
+    // Files larger than the whole cache are not remembered
+    if (data.size() > CACHE_BYTES) return result;
+
+    QMutexLocker locker(&m_lock);
+    auto it = m_cache.find(key);
+    if (it != m_cache.end()) {
+        // Another call got here first, or a hash collision: the latest contents win
+        m_cache_bytes -= it->second.data.size();
+        m_lru.erase(it->second.lru);
+        m_cache.erase(it);
+    }
+    m_lru.push_front(key);
+    Entry & entry = m_cache[key];
+    entry.data = data;
+    entry.fits = result;
+    entry.lru = m_lru.begin();
+    m_cache_bytes += data.size();
+
+    while (m_cache.size() > CACHE_SIZE || m_cache_bytes > CACHE_BYTES) {
+        const auto last = m_cache.find(m_lru.back());
+        m_cache_bytes -= last->second.data.size();
+        m_cache.erase(last);
+        m_lru.pop_back();
+    }
+    return result;
+}
+
+void ViewerRegistry::suggest(const dsk_tools::UniversalFile & f, const dsk_tools::BYTES & data,
+                             std::string & type, std::string & subtype)
+{
+    subtype.clear();
+    switch (f.type_preferred) {
+        case dsk_tools::PreferredType::Text:        type = "TEXT"; break;
+        case dsk_tools::PreferredType::AgatBASIC:   type = "BASIC"; subtype = "AGAT"; break;
+        case dsk_tools::PreferredType::AppleBASIC:  type = "BASIC"; subtype = "APPLE"; break;
+        case dsk_tools::PreferredType::MBASIC:      type = "BASIC"; subtype = "MBASIC"; break;
+        case dsk_tools::PreferredType::AgatBFT:     type = "PICTURE_AGAT"; subtype = "AGAT_BFT"; break;
+        case dsk_tools::PreferredType::AgatBMP:     type = "PICTURE_AGAT"; subtype = "AGAT_BMP"; break;
+        default: {
+            const std::pair<std::string, std::string> suggested = dsk_tools::suggest_file_type(f.name, data);
+            type = suggested.first;
+            subtype = suggested.second;
+        }
+    }
+}
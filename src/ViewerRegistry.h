@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: One-time viewer registration and cached viewer matching
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <QMutex>
+
+#include "dsk_tools/dsk_tools.h"
+
+class ViewerRegistry
+{
+public:
+    typedef std::map<std::string, std::vector<std::string>> FitMap;    // type -> fitting subtypes
+
+    // Registers all viewers on first use
+    static ViewerRegistry & instance();
+
+    // Types and subtypes whose viewers accept the data, in ViewerManager order.
+    // Results are remembered by content, so the same file opened again is not scanned.
+    FitMap fits(const dsk_tools::BYTES & data);
+
+    // The viewer a file opens with by default: from its preferred type, then by name and contents
+    static void suggest(const dsk_tools::UniversalFile & f, const dsk_tools::BYTES & data,
+                        std::string & type, std::string & subtype);
+
+    static quint64 contentHash(const dsk_tools::BYTES & data);
+
+private:
+    ViewerRegistry();
+    Q_DISABLE_COPY(ViewerRegistry)
+
+    // fits() does not change a viewer, so one instance per type and subtype serves all checks
+    struct Prototype {
+        std::string type;
+        std::string subtype;
+        std::unique_ptr<dsk_tools::Viewer> viewer;
+    };
+    std::vector<Prototype> m_prototypes;
+
+    typedef std::pair<quint64, size_t> Key;     // Content hash, size
+    static const size_t CACHE_SIZE = 256;
+    static const size_t CACHE_BYTES = 16 * 1024 * 1024;
+
+    // The contents are kept to confirm a hit, the hash only finds the candidate
+    struct Entry {
+        dsk_tools::BYTES data;
+        FitMap fits;
+        std::list<Key>::iterator lru;
+    };
+
+    // Guards the cache. Viewers are asked without it and are not known to be thread-safe,
+    // so fits() is called on the GUI thread only
+    QMutex m_lock;
+    std::list<Key> m_lru;                       // Most recently used first
+    std::map<Key, Entry> m_cache;
+    size_t m_cache_bytes {0};
+};
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Conversion of text viewers output to other representations
+
+#include "ViewerText.h"
+
+#include <cctype>
+#include <cstdlib>
+
+void ViewerText::appendUtf8(std::string & out, unsigned int code)
+{
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x110000) {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool ViewerText::decodeEntity(const std::string & entity, std::string & out)
+{
+    if (entity.empty()) return false;
+
+    if (entity[0] == '#') {
+        const bool hex = entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X');
+        const std::string digits = entity.substr(hex ? 2 : 1);
+        if (digits.empty()) return false;
+        char * end = nullptr;
+        const unsigned long code = std::strtoul(digits.c_str(), &end, hex ? 16 : 10);
+        if (*end != 0) return false;
+        appendUtf8(out, static_cast<unsigned int>(code));
+        return true;
+    }
+
+    if (entity == "lt")   { out += '<'; return true; }
+    if (entity == "gt")   { out += '>'; return true; }
+    if (entity == "amp")  { out += '&'; return true; }
+    if (entity == "quot") { out += '"'; return true; }
+    if (entity == "apos") { out += '\''; return true; }
+    if (entity == "nbsp") { out += ' '; return true; }
+    return false;
+}
+
+std::string ViewerText::toPlainText(const std::string & html)
+{
+    std::string out;
+    out.reserve(html.size());
+
+    bool after_br = false;
+    size_t i = 0;
+    const size_t n = html.size();
+    while (i < n) {
+        const char c = html[i];
+        if (c == '<') {
+            const size_t close = html.find('>', i);
+            if (close == std::string::npos) break;
+
+            // Tag name in lower case, with the leading '/' for closing tags
+            size_t p = i + 1;
+            std::string name;
+            if (p < close && html[p] == '/') name += html[p++];
+            while (p < close && std::isalnum(static_cast<unsigned char>(html[p])))
+                name += static_cast<char>(std::tolower(static_cast<unsigned char>(html[p++])));
+
+            if (name == "br") {
+                out += '\n';
+                after_br = true;
+            } else if (name == "div" || name == "p" || name == "tr" || name == "li") {
+                if (!out.empty() && out.back() != '\n') out += '\n';
+                after_br = false;
+            } else if (name == "/div" || name == "/p" || name == "/tr" || name == "/li") {
+                if (!after_br) out += '\n';
+                after_br = false;
+            } else if (name == "style" || name == "script" || name == "head") {
+                // Skip the whole element
+                const size_t end = html.find("</" + name, close);
+                i = (end == std::string::npos) ? n : html.find('>', end);
+                if (i == std::string::npos) i = n; else i++;
+                continue;
+            }
+            i = close + 1;
+        } else if (c == '&') {
+            const size_t semi = html.find(';', i);
+            if (semi != std::string::npos && semi - i <= 10 && decodeEntity(html.substr(i + 1, semi - i - 1), out)) {
+                i = semi + 1;
+            } else {
+                out += c;
+                i++;
+            }
+            after_br = false;
+        } else {
+            if (c != '\r') out += c;
+            if (c != '\n' && c != '\r') after_br = false;
+            i++;
+        }
+    }
+    return out;
+}
+
+std::vector<std::pair<size_t, size_t>> ViewerText::lineChunks(const uint8_t * data, size_t size, size_t chunk_size)
+{
+    std::vector<std::pair<size_t, size_t>> chunks;
+    size_t start = 0;
+    while (start < size) {
+        size_t end = start + chunk_size;
+        if (end >= size) {
+            end = size;
+        } else {
+            // The last terminator within the next chunk_size bytes, a CR LF pair is kept whole
+            size_t cut = end;
+            while (cut > start && (data[cut - 1] & 0x7F) != 0x0D && (data[cut - 1] & 0x7F) != 0x0A) cut--;
+            if (cut > start) {
+                end = cut;
+                if ((data[end - 1] & 0x7F) == 0x0D && end < size && (data[end] & 0x7F) == 0x0A) end++;
+            }
+        }
+        chunks.push_back(std::make_pair(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
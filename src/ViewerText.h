@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Conversion of text viewers output to other representations
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ViewerText {
+public:
+    // Viewer::process_as_text() returns an HTML fragment styled by basic.css.
+    // Returns the same text as UTF-8 without markup, one viewer line per text line.
+    static std::string toPlainText(const std::string & html);
+
+    // Appends a Unicode code point as UTF-8
+    static void appendUtf8(std::string & out, unsigned int code);
+
+    // Decodes an entity body without '&' and ';' ("lt", "#160", "#xA0"), returns false if unknown
+    static bool decodeEntity(const std::string & entity, std::string & out);
+
+    // Splits a text file into (offset, size) parts of about chunk_size bytes for decoding them
+    // one by one. Parts end after a line terminator: CR, LF or the same with the high bit set,
+    // as on Agat and Apple II. A line longer than chunk_size is cut where the next part starts.
+    static std::vector<std::pair<size_t, size_t>> lineChunks(const uint8_t * data, size_t size, size_t chunk_size);
+};
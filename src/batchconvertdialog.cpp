@@ -0,0 +1,362 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass for converting a directory tree of disk images
+
+#include "batchconvertdialog.h"
+#include "ImageUtils.h"
+#include "mainutils.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QMessageBox>
+#include <QThread>
+#include <QRegularExpressionValidator>
+
+// Formats which can be produced from the images, see ConvertDialog::set_controls()
+static const char * const BATCH_TARGETS[] = {
+    "FILE_HXC_HFE",
+    "FILE_HXC_MFM",
+    "FILE_MFM_NIB",
+    "FILE_MFM_NIC",
+    "FILE_RAW_MSB"
+};
+
+BatchConvertDialog::BatchConvertDialog(QWidget *parent,
+                                       QSettings *settings,
+                                       const QJsonObject * file_formats,
+                                       const QJsonObject * file_types,
+                                       const QString & source_dir)
+    : QDialog(parent)
+    , m_settings(settings)
+    , m_file_formats(file_formats)
+    , m_file_types(file_types)
+{
+    m_converter = new BatchConverter(*m_file_formats, *m_file_types, this);
+
+    setupUi();
+
+    sourceEdit->setText(m_settings->value("batch/source_dir", source_dir).toString());
+    recursiveCheck->setChecked(m_settings->value("batch/recursive", true).toBool());
+    outputEdit->setText(m_settings->value("batch/output_dir", "").toString());
+    keepStructureCheck->setChecked(m_settings->value("batch/keep_structure", true).toBool());
+    overwriteCheck->setChecked(m_settings->value("batch/overwrite", false).toBool());
+    useTemplateCheck->setChecked(m_settings->value("batch/use_tracks", 0).toInt() != 0);
+    tracksCounter->setValue(m_settings->value("batch/tracks_count", 1).toInt());
+    templateEdit->setText(m_settings->value("batch/template", "").toString());
+    volumePolicyCombo->setCurrentIndex(m_settings->value("batch/volume_policy", 0).toInt() != 0 ? 1 : 0);
+    volumeIDEdit->setText(m_settings->value("batch/volume_id", "FE").toString());
+    threadsCounter->setValue(m_settings->value("batch/threads", QThread::idealThreadCount()).toInt());
+
+    const QString target_def = m_settings->value("batch/target_format", "").toString();
+    for (int i = 0; i < formatCombo->count(); i++) {
+        if (formatCombo->itemData(i).toString() == target_def) {
+            formatCombo->setCurrentIndex(i);
+            break;
+        }
+    }
+
+    connect(m_converter, &BatchRunner::itemFinished, this, &BatchConvertDialog::onItemFinished);
+    connect(m_converter, &BatchRunner::progress, this, &BatchConvertDialog::onProgress);
+    connect(m_converter, &BatchRunner::finished, this, &BatchConvertDialog::onFinished);
+
+    setControls();
+    setRunning(false);
+}
+
+BatchConvertDialog::~BatchConvertDialog()
+{
+    // Workers reference the converter, so they must be gone before it is destroyed
+    m_converter->cancel();
+    m_converter->wait();
+}
+
+void BatchConvertDialog::setupUi()
+{
+    setWindowTitle(BatchConvertDialog::tr("Batch conversion"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // Source ------------------------------------------------------------------
+    QGroupBox *sourceGroup = new QGroupBox(BatchConvertDialog::tr("Source images"), this);
+    QGridLayout *sourceLayout = new QGridLayout(sourceGroup);
+
+    sourceEdit = new QLineEdit(sourceGroup);
+    QPushButton *sourceButton = new QPushButton("...", sourceGroup);
+    recursiveCheck = new QCheckBox(BatchConvertDialog::tr("Include subdirectories"), sourceGroup);
+
+    sourceLayout->addWidget(new QLabel(BatchConvertDialog::tr("Directory:"), sourceGroup), 0, 0);
+    sourceLayout->addWidget(sourceEdit, 0, 1);
+    sourceLayout->addWidget(sourceButton, 0, 2);
+    sourceLayout->addWidget(recursiveCheck, 1, 1, 1, 2);
+    layout->addWidget(sourceGroup);
+
+    connect(sourceButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, BatchConvertDialog::tr("Choose directory"), sourceEdit->text());
+        if (!dir.isEmpty()) sourceEdit->setText(QDir::toNativeSeparators(dir));
+    });
+
+    // Output ------------------------------------------------------------------
+    QGroupBox *outputGroup = new QGroupBox(BatchConvertDialog::tr("Output"), this);
+    QGridLayout *outputLayout = new QGridLayout(outputGroup);
+
+    formatCombo = new QComboBox(outputGroup);
+    for (const char * target_id : BATCH_TARGETS) {
+        const QJsonObject target = (*m_file_formats)[target_id].toObject();
+        formatCombo->addItem(
+            QString("%1 (%2)").arg(
+                QCoreApplication::translate("config", target["name"].toString().toUtf8().constData()),
+                target["short_name"].toString()
+            ),
+            QString(target_id)
+        );
+    }
+
+    outputEdit = new QLineEdit(outputGroup);
+    QPushButton *outputButton = new QPushButton("...", outputGroup);
+    keepStructureCheck = new QCheckBox(BatchConvertDialog::tr("Keep directory structure"), outputGroup);
+    overwriteCheck = new QCheckBox(BatchConvertDialog::tr("Overwrite existing files"), outputGroup);
+
+    outputLayout->addWidget(new QLabel(BatchConvertDialog::tr("Format:"), outputGroup), 0, 0);
+    outputLayout->addWidget(formatCombo, 0, 1, 1, 2);
+    outputLayout->addWidget(new QLabel(BatchConvertDialog::tr("Directory:"), outputGroup), 1, 0);
+    outputLayout->addWidget(outputEdit, 1, 1);
+    outputLayout->addWidget(outputButton, 1, 2);
+    outputLayout->addWidget(keepStructureCheck, 2, 1, 1, 2);
+    outputLayout->addWidget(overwriteCheck, 3, 1, 1, 2);
+    layout->addWidget(outputGroup);
+
+    connect(outputButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, BatchConvertDialog::tr("Choose directory"), outputEdit->text());
+        if (!dir.isEmpty()) outputEdit->setText(QDir::toNativeSeparators(dir));
+    });
+    connect(formatCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BatchConvertDialog::setControls);
+
+    // Options -----------------------------------------------------------------
+    QGroupBox *optionsGroup = new QGroupBox(BatchConvertDialog::tr("Options"), this);
+    QGridLayout *optionsLayout = new QGridLayout(optionsGroup);
+
+    useTemplateCheck = new QCheckBox(BatchConvertDialog::tr("Replace boot tracks from template"), optionsGroup);
+    tracksCounter = new QSpinBox(optionsGroup);
+    tracksCounter->setRange(1, 80);
+    templateEdit = new QLineEdit(optionsGroup);
+    templateButton = new QPushButton("...", optionsGroup);
+
+    volumePolicyCombo = new QComboBox(optionsGroup);
+    volumePolicyCombo->addItem(BatchConvertDialog::tr("From file system, otherwise:"));
+    volumePolicyCombo->addItem(BatchConvertDialog::tr("Always use:"));
+    volumeIDEdit = new QLineEdit(optionsGroup);
+    volumeIDEdit->setValidator(new QRegularExpressionValidator(QRegularExpression("[0-9A-Fa-f]{1,2}"), volumeIDEdit));
+    volumeIDEdit->setMaximumWidth(50);
+
+    threadsCounter = new QSpinBox(optionsGroup);
+    threadsCounter->setRange(1, 64);
+
+    optionsLayout->addWidget(useTemplateCheck, 0, 0, 1, 2);
+    optionsLayout->addWidget(new QLabel(BatchConvertDialog::tr("Tracks:"), optionsGroup), 0, 2);
+    optionsLayout->addWidget(tracksCounter, 0, 3);
+    optionsLayout->addWidget(new QLabel(BatchConvertDialog::tr("Template:"), optionsGroup), 1, 0);
+    optionsLayout->addWidget(templateEdit, 1, 1, 1, 2);
+    optionsLayout->addWidget(templateButton, 1, 3);
+    optionsLayout->addWidget(new QLabel(BatchConvertDialog::tr("Volume ID:"), optionsGroup), 2, 0);
+    optionsLayout->addWidget(volumePolicyCombo, 2, 1);
+    optionsLayout->addWidget(volumeIDEdit, 2, 2);
+    optionsLayout->addWidget(new QLabel(BatchConvertDialog::tr("Threads:"), optionsGroup), 3, 0);
+    optionsLayout->addWidget(threadsCounter, 3, 1);
+    optionsLayout->setColumnStretch(1, 1);
+    layout->addWidget(optionsGroup);
+
+    connect(useTemplateCheck, &QCheckBox::toggled, this, &BatchConvertDialog::setControls);
+    connect(templateButton, &QPushButton::clicked, this, [this]() {
+        const QString target_id = formatCombo->currentData().toString();
+        const QJsonObject target = (*m_file_formats)[target_id].toObject();
+        const QString filter = QString("%1 (%2)").arg(target["name"].toString(), target["extensions"].toString().replace(";", " "));
+        const QString file = QFileDialog::getOpenFileName(this, BatchConvertDialog::tr("Choose file"), templateEdit->text(), filter);
+        if (!file.isEmpty()) templateEdit->setText(QDir::toNativeSeparators(file));
+    });
+
+    // Results -----------------------------------------------------------------
+    progressBar = new QProgressBar(this);
+    layout->addWidget(progressBar);
+
+    resultsTree = new QTreeWidget(this);
+    resultsTree->setRootIsDecorated(false);
+    resultsTree->setUniformRowHeights(true);
+    resultsTree->setHeaderLabels(QStringList()
+                                 << BatchConvertDialog::tr("Image")
+                                 << BatchConvertDialog::tr("Status")
+                                 << BatchConvertDialog::tr("Details"));
+    resultsTree->header()->setStretchLastSection(true);
+    resultsTree->setColumnWidth(0, 300);
+    resultsTree->setColumnWidth(1, 80);
+    layout->addWidget(resultsTree, 1);
+
+    summaryLabel = new QLabel(this);
+    layout->addWidget(summaryLabel);
+
+    // Buttons -----------------------------------------------------------------
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    startButton = new QPushButton(BatchConvertDialog::tr("Start"), this);
+    cancelButton = new QPushButton(BatchConvertDialog::tr("Stop"), this);
+    closeButton = new QPushButton(BatchConvertDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(cancelButton);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(startButton, &QPushButton::clicked, this, &BatchConvertDialog::onStart);
+    connect(cancelButton, &QPushButton::clicked, this, &BatchConvertDialog::onCancel);
+    connect(closeButton, &QPushButton::clicked, this, &BatchConvertDialog::reject);
+
+    resize(800, 640);
+}
+
+void BatchConvertDialog::setControls()
+{
+    // Boot tracks substitution is only available for raw images, Volume ID for the others
+    const bool is_raw = formatCombo->currentData().toString() == "FILE_RAW_MSB";
+    useTemplateCheck->setEnabled(is_raw);
+    const bool use_template = is_raw && useTemplateCheck->isChecked();
+    tracksCounter->setEnabled(use_template);
+    templateEdit->setEnabled(use_template);
+    templateButton->setEnabled(use_template);
+    volumePolicyCombo->setEnabled(!is_raw);
+    volumeIDEdit->setEnabled(!is_raw);
+}
+
+void BatchConvertDialog::setRunning(bool running)
+{
+    startButton->setEnabled(!running);
+    cancelButton->setEnabled(running);
+    sourceEdit->setEnabled(!running);
+    formatCombo->setEnabled(!running);
+    outputEdit->setEnabled(!running);
+    threadsCounter->setEnabled(!running);
+}
+
+void BatchConvertDialog::saveSetup()
+{
+    m_settings->setValue("batch/source_dir", sourceEdit->text());
+    m_settings->setValue("batch/recursive", recursiveCheck->isChecked());
+    m_settings->setValue("batch/target_format", formatCombo->currentData().toString());
+    m_settings->setValue("batch/output_dir", outputEdit->text());
+    m_settings->setValue("batch/keep_structure", keepStructureCheck->isChecked());
+    m_settings->setValue("batch/overwrite", overwriteCheck->isChecked());
+    m_settings->setValue("batch/use_tracks", useTemplateCheck->isChecked() ? 1 : 0);
+    m_settings->setValue("batch/tracks_count", tracksCounter->value());
+    m_settings->setValue("batch/template", templateEdit->text());
+    m_settings->setValue("batch/volume_policy", volumePolicyCombo->currentIndex());
+    m_settings->setValue("batch/volume_id", volumeIDEdit->text());
+    m_settings->setValue("batch/threads", threadsCounter->value());
+}
+
+void BatchConvertDialog::onStart()
+{
+    const QString source_root = QDir::fromNativeSeparators(sourceEdit->text());
+    if (source_root.isEmpty() || !QFileInfo(source_root).isDir()) {
+        QMessageBox::critical(this, BatchConvertDialog::tr("Error"), BatchConvertDialog::tr("Source directory not found."));
+        return;
+    }
+    if (outputEdit->text().isEmpty()) {
+        QMessageBox::critical(this, BatchConvertDialog::tr("Error"), BatchConvertDialog::tr("No output directory selected."));
+        return;
+    }
+
+    BatchConvertOptions options;
+    options.source_root = source_root;
+    options.output_dir = QDir::fromNativeSeparators(outputEdit->text());
+    options.target_id = formatCombo->currentData().toString();
+    options.keep_structure = keepStructureCheck->isChecked();
+    options.overwrite = overwriteCheck->isChecked();
+    if (useTemplateCheck->isEnabled() && useTemplateCheck->isChecked()) {
+        options.numtracks = tracksCounter->value();
+        options.template_file = QDir::fromNativeSeparators(templateEdit->text());
+    }
+    options.volume_policy = volumePolicyCombo->currentIndex() == 0 ? VolumeIdPolicy::FromFileSystem : VolumeIdPolicy::Fixed;
+    const QString volume_id_str = volumeIDEdit->text();
+    options.volume_id = volume_id_str.isEmpty() ? 0 : static_cast<uint8_t>(volume_id_str.toUInt(nullptr, 16));
+
+    saveSetup();
+
+    const QStringList images = ImageUtils::collectImages(
+        source_root,
+        ImageUtils::sourceFilters(*m_file_formats),
+        recursiveCheck->isChecked()
+    );
+    if (images.isEmpty()) {
+        QMessageBox::information(this, BatchConvertDialog::tr("Batch conversion"), BatchConvertDialog::tr("No disk images found."));
+        return;
+    }
+
+    resultsTree->clear();
+    summaryLabel->clear();
+    progressBar->setRange(0, images.size());
+    progressBar->setValue(0);
+
+    m_converter->setOptions(options);
+    m_converter->setMaxThreads(threadsCounter->value());
+    setRunning(true);
+    if (!m_converter->start(images)) {
+        setRunning(false);
+        QMessageBox::critical(this, BatchConvertDialog::tr("Error"), m_converter->errorString());
+    }
+}
+
+void BatchConvertDialog::onCancel()
+{
+    m_converter->cancel();
+    cancelButton->setEnabled(false);
+}
+
+void BatchConvertDialog::onItemFinished(int index, const QString & item, bool ok, const QString & message)
+{
+    Q_UNUSED(index);
+    const QString source_root = m_converter->options().source_root;
+
+    QTreeWidgetItem *row = new QTreeWidgetItem(resultsTree);
+    row->setText(0, QDir::toNativeSeparators(QDir(source_root).relativeFilePath(item)));
+    row->setToolTip(0, QDir::toNativeSeparators(item));
+    row->setText(1, ok ? BatchConvertDialog::tr("OK") : BatchConvertDialog::tr("Error"));
+    row->setText(2, message);
+    if (!ok) row->setForeground(1, QBrush(Qt::red));
+}
+
+void BatchConvertDialog::onProgress(int done, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(done);
+}
+
+void BatchConvertDialog::onFinished(int succeeded, int failed, qint64 elapsed_ms)
+{
+    setRunning(false);
+    resultsTree->sortItems(0, Qt::AscendingOrder);
+    summaryLabel->setText(
+        BatchConvertDialog::tr("Converted: %1, failed: %2, time: %3 s")
+            .arg(succeeded)
+            .arg(failed)
+            .arg(static_cast<double>(elapsed_ms) / 1000.0, 0, 'f', 1)
+    );
+}
+
+void BatchConvertDialog::reject()
+{
+    if (m_converter->isRunning()) {
+        const QMessageBox::StandardButton res = QMessageBox::question(
+            this,
+            BatchConvertDialog::tr("Batch conversion"),
+            BatchConvertDialog::tr("Conversion is in progress. Stop it?")
+        );
+        if (res != QMessageBox::Yes) return;
+        m_converter->cancel();
+        m_converter->wait();
+    }
+    QDialog::reject();
+}
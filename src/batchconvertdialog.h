@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass for converting a directory tree of disk images
+
+#pragma once
+
+#include <QDialog>
+#include <QSettings>
+#include <QJsonObject>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include "BatchConverter.h"
+
+class BatchConvertDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit BatchConvertDialog(QWidget *parent,
+                                QSettings *settings,
+                                const QJsonObject * file_formats,
+                                const QJsonObject * file_types,
+                                const QString & source_dir);
+    ~BatchConvertDialog();
+
+protected:
+    void reject() override;
+
+private slots:
+    void onStart();
+    void onCancel();
+    void onItemFinished(int index, const QString & item, bool ok, const QString & message);
+    void onProgress(int done, int total);
+    void onFinished(int succeeded, int failed, qint64 elapsed_ms);
+    void setControls();
+
+private:
+    QSettings * m_settings;
+    const QJsonObject * m_file_formats;
+    const QJsonObject * m_file_types;
+
+    BatchConverter * m_converter;
+
+    QLineEdit * sourceEdit;
+    QCheckBox * recursiveCheck;
+    QComboBox * formatCombo;
+    QLineEdit * outputEdit;
+    QCheckBox * keepStructureCheck;
+    QCheckBox * overwriteCheck;
+    QCheckBox * useTemplateCheck;
+    QSpinBox * tracksCounter;
+    QLineEdit * templateEdit;
+    QPushButton * templateButton;
+    QComboBox * volumePolicyCombo;
+    QLineEdit * volumeIDEdit;
+    QSpinBox * threadsCounter;
+    QProgressBar * progressBar;
+    QTreeWidget * resultsTree;
+    QLabel * summaryLabel;
+    QPushButton * startButton;
+    QPushButton * cancelButton;
+    QPushButton * closeButton;
+
+    void setupUi();
+    void saveSetup();
+    void setRunning(bool running);
+};
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Timing helpers shared by the micro-benchmarks
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+
+#include <QElapsedTimer>
+
+namespace bench {
+
+// Runs f until at least min_ms have passed, then reports the best of five such rounds
+// as nanoseconds per call. The result of f is kept in sink so the call is not optimised out.
+template <typename F>
+double nsPerCall(F f, qint64 min_ms = 200)
+{
+    static volatile qint64 sink = 0;
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        QElapsedTimer timer;
+        timer.start();
+        qint64 calls = 0;
+        do {
+            sink = sink + static_cast<qint64>(f());
+            calls++;
+        } while (timer.elapsed() < min_ms);
+        const double ns = static_cast<double>(timer.nsecsElapsed()) / calls;
+        best = (round == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+inline double megabytesPerSecond(double bytes, double ns)
+{
+    return bytes * 1000.0 / ns;
+}
+
+inline void report(const char * name, double ns, double bytes = 0)
+{
+    if (bytes > 0)
+        std::printf("%-40s %12.1f us %10.1f MB/s\n", name, ns / 1000.0, megabytesPerSecond(bytes, ns));
+    else
+        std::printf("%-40s %12.1f us\n", name, ns / 1000.0);
+    std::fflush(stdout);
+}
+
+} // namespace bench
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Charsets throughput per encoding and a check of the built-in tables against dsk_tools
+
+#include "Bench.h"
+#include "Charsets.h"
+#include "ViewerRegistry.h"
+#include "ViewerText.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "dsk_tools/dsk_tools.h"
+
+namespace {
+
+const size_t DATA_SIZE = 1 << 20;
+
+void measure(Charsets::Encoding encoding, const std::vector<uint8_t> & data)
+{
+    std::vector<char16_t> out(data.size());
+    const double utf16 = bench::nsPerCall([&]() {
+        Charsets::toUtf16(encoding, data.data(), data.size(), out.data());
+        return out[data.size() / 2];
+    });
+    const double utf8 = bench::nsPerCall([&]() {
+        return Charsets::toUtf8(encoding, data.data(), data.size()).size();
+    });
+
+    std::printf("%s\n", Charsets::name(encoding));
+    bench::report("  toUtf16", utf16, static_cast<double>(data.size()));
+    bench::report("  toUtf8", utf8, static_cast<double>(data.size()));
+}
+
+// All 256 bytes of the compile-time table against the dsk_tools TEXT viewer, both ways: a byte
+// differs if either side shows a character the other does not. Control codes show nothing here,
+// the viewer turns them into line breaks or drops them.
+int compare(Charsets::Encoding encoding, dsk_tools::Viewer & viewer)
+{
+    int mismatches = 0;
+    for (int c = 0; c < 256; c++) {
+        const char16_t u = Charsets::builtinTable(encoding)[c];
+        std::string ours;
+        if (u >= 0x20 && u != 0x7F && u != 0xFFFD) ViewerText::appendUtf8(ours, u);
+
+        std::string theirs = ViewerText::toPlainText(viewer.process_as_text(dsk_tools::BYTES(1, static_cast<uint8_t>(c)), Charsets::name(encoding)));
+        while (!theirs.empty() && (theirs.back() == '\n' || theirs.back() == '\r')) theirs.pop_back();
+
+        if (ours != theirs) {
+            std::printf("  %02X: '%s' here, '%s' in the viewer\n", c, ours.c_str(), theirs.c_str());
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<uint8_t> data(DATA_SIZE);
+    uint32_t seed = 12345;
+    for (uint8_t & b : data) {
+        seed = seed * 1103515245 + 12345;
+        b = static_cast<uint8_t>(seed >> 16);
+    }
+
+    for (int i = 0; i < Charsets::EncodingCount; i++)
+        measure(static_cast<Charsets::Encoding>(i), data);
+
+    ViewerRegistry::instance();
+    std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create("TEXT", "");
+    if (!viewer) {
+        std::printf("No TEXT viewer in dsk_tools, tables not checked\n");
+        return 1;
+    }
+
+    int total = 0;
+    for (int i = 0; i < Charsets::EncodingCount; i++) {
+        const Charsets::Encoding encoding = static_cast<Charsets::Encoding>(i);
+        const int mismatches = compare(encoding, *viewer);
+        std::printf("%s: %s\n", Charsets::name(encoding),
+                    mismatches ? "built-in table differs from the viewer, fix Charsets.cpp" : "same as the viewer");
+        total += mismatches;
+    }
+    return total ? 1 : 0;
+}
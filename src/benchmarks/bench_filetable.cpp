@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: FileTable filling, selection and repaint times on a 10k-row directory
+
+#include "Bench.h"
+#include "FileTable.h"
+
+#include <cstdio>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QStandardItemModel>
+
+namespace {
+
+const int ROWS = 10000;
+
+// Rows are appended one at a time, as HostModel::populateModel() does
+void fill(QStandardItemModel & model)
+{
+    model.removeRows(0, model.rowCount());
+    model.appendRow(QList<QStandardItem *>() << new QStandardItem("[..]") << new QStandardItem() << new QStandardItem());
+    for (int i = 0; i < ROWS; i++) {
+        model.appendRow(QList<QStandardItem *>()
+                        << new QStandardItem(QString("FILE%1.TXT").arg(i, 5, 10, QChar('0')))
+                        << new QStandardItem(QString::number(i * 17))
+                        << new QStandardItem("01.01.2025 12:00"));
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty()) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QStandardItemModel model(0, 3);
+    FileTable view;
+    view.setModel(&model);
+    view.setupForHostMode();
+    view.resize(800, 600);
+    view.show();
+    QApplication::processEvents();
+
+    // Filled a few times, the last run is reported
+    qint64 fill_ns = 0;
+    for (int i = 0; i < 3; i++) {
+        QElapsedTimer timer;
+        timer.start();
+        fill(model);
+        fill_ns = timer.nsecsElapsed();
+    }
+    std::printf("%d rows\n", model.rowCount());
+    bench::report("  fill a row at a time", static_cast<double>(fill_ns));
+
+    const QItemSelection all(model.index(0, 0), model.index(model.rowCount() - 1, model.columnCount() - 1));
+    const double select_ns = bench::nsPerCall([&]() {
+        view.selectionModel()->select(all, QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        view.selectionModel()->clearSelection();
+        return view.rowState(ROWS / 2);
+    });
+    bench::report("  select and clear all rows", select_ns);
+
+    const double paint_none = bench::nsPerCall([&]() {
+        const QPixmap pixmap = view.viewport()->grab();
+        return pixmap.width();
+    });
+    bench::report("  repaint, nothing selected", paint_none);
+
+    view.selectionModel()->select(all, QItemSelectionModel::Select | QItemSelectionModel::Rows);
+    const double paint_all = bench::nsPerCall([&]() {
+        const QPixmap pixmap = view.viewport()->grab();
+        return pixmap.width();
+    });
+    bench::report("  repaint, all rows selected", paint_all);
+
+    // Selected rows further down must not make the visible ones slower to paint
+    view.scrollTo(model.index(ROWS / 2, 0));
+    const double paint_middle = bench::nsPerCall([&]() {
+        const QPixmap pixmap = view.viewport()->grab();
+        return pixmap.width();
+    });
+    bench::report("  repaint in the middle, all selected", paint_middle);
+    return 0;
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: ImageDiff::compare() time on two images given on the command line
+
+#include "Bench.h"
+#include "ImageDiff.h"
+#include "ImageUtils.h"
+#include "ErrorText.h"
+
+#include <cstdio>
+
+#include <QCoreApplication>
+
+namespace {
+
+bool open(const char * file_name, LoadedImage & loaded)
+{
+    const dsk_tools::Result res = ImageUtils::openImage(file_name, loaded);
+    if (!res) {
+        std::printf("%s: %s\n", file_name, ErrorText::decode(res).toUtf8().constData());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 3) {
+        std::printf("Usage: bench_imagediff LEFT_IMAGE RIGHT_IMAGE\n"
+                    "Two revisions of an 840K disk show the target case.\n");
+        return 2;
+    }
+
+    LoadedImage left, right;
+    if (!open(argv[1], left) || !open(argv[2], right)) return 1;
+
+    ImageDiffResult diff;
+    const double ns = bench::nsPerCall([&]() {
+        diff = ImageDiff::compare(left.image.get(), left.filesystem_id, right.image.get(), right.filesystem_id);
+        return diff.sectors_compared;
+    });
+
+    const double bytes = static_cast<double>(diff.sectors_compared) * diff.sector_size;
+    std::printf("%d x %d x %d sectors of %d bytes, %d differ, %d files differ\n",
+                diff.tracks, diff.heads, diff.sectors, diff.sector_size,
+                static_cast<int>(diff.sector_diffs.size()), static_cast<int>(diff.file_diffs.size()));
+    bench::report("  ImageDiff::compare", ns, bytes);
+    return 0;
+}
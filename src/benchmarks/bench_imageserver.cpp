@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Reading a file through the image server against opening the image every time
+
+#include "Bench.h"
+#include "ImageClient.h"
+#include "ImageUtils.h"
+
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+
+namespace {
+
+// What a tool started per operation does: detect, load, open the file system, read one file
+bool readDirectly(const std::string & file_name, const std::string & name, size_t & size)
+{
+    LoadedImage loaded;
+    if (!ImageUtils::openImage(file_name, loaded)) return false;
+
+    dsk_tools::Files files;
+    if (!loaded.filesystem->dir(files, false)) return false;
+    for (const dsk_tools::UniversalFile & f : files) {
+        if (f.name != name) continue;
+        dsk_tools::BYTES data;
+        if (!loaded.filesystem->get_file(f, "", data)) return false;
+        size = data.size();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        std::printf("Usage: bench_imageserver IMAGE [SERVER_NAME]\n"
+                    "Start the server first: DISKCommander --server [--name SERVER_NAME]\n");
+        return 2;
+    }
+    const QString image = QFileInfo(QString::fromLocal8Bit(argv[1])).absoluteFilePath();
+    const QString server = (argc > 2) ? QString::fromLocal8Bit(argv[2]) : ImageProtocol::defaultServerName();
+
+    ImageClient client;
+    ImageClient::ImageInfo info;
+    if (!client.connectToServer(server) || !client.open(image, info)) {
+        std::printf("%s\n", client.errorString().toUtf8().constData());
+        return 1;
+    }
+
+    // The first file of the root directory is read in every round
+    std::vector<ImageProtocol::Entry> entries;
+    if (!client.list(info.handle, "", entries)) {
+        std::printf("%s\n", client.errorString().toUtf8().constData());
+        return 1;
+    }
+    QString name;
+    for (const ImageProtocol::Entry & entry : entries) {
+        if (!entry.is_dir) {
+            name = entry.name;
+            break;
+        }
+    }
+    if (name.isEmpty()) {
+        std::printf("No files in the root directory of the image\n");
+        return 1;
+    }
+
+    size_t size = 0;
+    if (!readDirectly(image.toStdString(), name.toStdString(), size)) {
+        std::printf("Cannot read '%s' directly\n", name.toUtf8().constData());
+        return 1;
+    }
+    std::printf("%s, file '%s' of %d bytes\n", QFileInfo(image).fileName().toUtf8().constData(),
+                name.toUtf8().constData(), static_cast<int>(size));
+
+    const double direct = bench::nsPerCall([&]() {
+        size_t read = 0;
+        readDirectly(image.toStdString(), name.toStdString(), read);
+        return read;
+    });
+    bench::report("  open the image every time", direct, static_cast<double>(size));
+
+    const double served = bench::nsPerCall([&]() {
+        QByteArray data;
+        client.get(info.handle, name, "", data);
+        return data.size();
+    });
+    bench::report("  server, one get per round trip", served, static_cast<double>(size));
+
+    // Requests sent in batches of 32 before the responses are read
+    const int BATCH = 32;
+    const QByteArray request = ImageClient::getRequest(info.handle, name, "");
+    const double pipelined = bench::nsPerCall([&]() {
+        quint32 ids[BATCH];
+        for (int i = 0; i < BATCH; i++) ids[i] = client.send(ImageProtocol::Op::Get, request);
+        int received = 0;
+        for (int i = 0; i < BATCH; i++) {
+            ImageProtocol::Response response;
+            if (client.receive(ids[i], response) && client.check(response)) received++;
+        }
+        return received;
+    }) / BATCH;
+    bench::report("  server, pipelined gets", pipelined, static_cast<double>(size));
+
+    std::printf("  speed-up %.1fx, %.1fx pipelined\n", direct / served, direct / pipelined);
+    client.close(info.handle);
+    return 0;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: PixelScaler against QImage::scaled on viewer-sized pictures
+
+#include "Bench.h"
+#include "PixelScaler.h"
+
+#include <cstdio>
+
+#include <QImage>
+
+namespace {
+
+QImage testPicture(int width, int height)
+{
+    QImage image(width, height, QImage::Format_RGBA8888);
+    for (int y = 0; y < height; y++) {
+        uchar * row = image.scanLine(y);
+        for (int x = 0; x < width * 4; x++) row[x] = static_cast<uchar>(x * 7 + y * 13);
+    }
+    return image;
+}
+
+void run(const char * name, const QImage & src, int width, int height)
+{
+    QImage out;
+    const double ours = bench::nsPerCall([&]() {
+        PixelScaler::scale(src, width, height, out);
+        return out.constBits()[0];
+    });
+    const double qt = bench::nsPerCall([&]() {
+        const QImage scaled = src.scaled(width, height, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        return scaled.constBits()[0];
+    });
+
+    const QImage expected = src.scaled(width, height, Qt::IgnoreAspectRatio, Qt::FastTransformation)
+                                .convertToFormat(QImage::Format_RGBA8888);
+    const bool same = (width % src.width() != 0) || (expected == out);
+
+    std::printf("%s: %dx%d -> %dx%d%s\n", name, src.width(), src.height(), width, height,
+                same ? "" : "  (PIXELS DIFFER)");
+    bench::report("  PixelScaler::scale", ours);
+    bench::report("  QImage::scaled", qt);
+    std::printf("  speed-up %.2fx\n", qt / ours);
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("PixelScaler backend: %s\n", PixelScaler::backend());
+
+    // Hi-res Apple II and Agat screens at the zoom steps of the viewer
+    const QImage apple = testPicture(280, 192);
+    const QImage agat = testPicture(512, 256);
+    run("x2", apple, 560, 384);
+    run("x3", apple, 840, 576);
+    run("x4", agat, 2048, 1024);
+    run("x6", apple, 1680, 1152);
+    run("fit", apple, 1000, 700);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass showing differences between two disk images
+
+#include "comparedialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTabWidget>
+
+CompareDialog::CompareDialog(QWidget *parent, const QString & left_name, const QString & right_name, const ImageDiffResult & diff)
+    : QDialog(parent)
+{
+    setupUi();
+    showDiff(left_name, right_name, diff);
+}
+
+void CompareDialog::setupUi()
+{
+    setWindowTitle(CompareDialog::tr("Compare images"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    QTabWidget *tabs = new QTabWidget(this);
+
+    filesTree = new QTreeWidget(tabs);
+    filesTree->setRootIsDecorated(false);
+    filesTree->setUniformRowHeights(true);
+    filesTree->setHeaderLabels(QStringList()
+                               << CompareDialog::tr("File")
+                               << CompareDialog::tr("Change")
+                               << CompareDialog::tr("Left size")
+                               << CompareDialog::tr("Right size")
+                               << CompareDialog::tr("Sectors"));
+    filesTree->header()->setStretchLastSection(false);
+    filesTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    tabs->addTab(filesTree, CompareDialog::tr("Files"));
+
+    sectorsTree = new QTreeWidget(tabs);
+    sectorsTree->setRootIsDecorated(false);
+    sectorsTree->setUniformRowHeights(true);
+    sectorsTree->setHeaderLabels(QStringList()
+                                 << CompareDialog::tr("Track")
+                                 << CompareDialog::tr("Side")
+                                 << CompareDialog::tr("Sector")
+                                 << CompareDialog::tr("Bytes")
+                                 << CompareDialog::tr("Left file")
+                                 << CompareDialog::tr("Right file"));
+    sectorsTree->setColumnWidth(0, 60);
+    sectorsTree->setColumnWidth(1, 50);
+    sectorsTree->setColumnWidth(2, 60);
+    sectorsTree->setColumnWidth(3, 60);
+    sectorsTree->setColumnWidth(4, 220);
+    tabs->addTab(sectorsTree, CompareDialog::tr("Sectors"));
+
+    layout->addWidget(tabs, 1);
+
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    QPushButton *closeButton = new QPushButton(CompareDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(closeButton, &QPushButton::clicked, this, &CompareDialog::accept);
+
+    resize(760, 560);
+}
+
+void CompareDialog::showDiff(const QString & left_name, const QString & right_name, const ImageDiffResult & diff)
+{
+    const Qt::Alignment numbers = Qt::AlignRight | Qt::AlignVCenter;
+
+    for (const FileDiff & file : diff.file_diffs) {
+        QTreeWidgetItem *row = new QTreeWidgetItem(filesTree);
+        row->setText(0, file.path);
+        switch (file.change) {
+            case FileDiff::Added:   row->setText(1, CompareDialog::tr("Added")); break;
+            case FileDiff::Removed: row->setText(1, CompareDialog::tr("Removed")); break;
+            case FileDiff::Changed: row->setText(1, CompareDialog::tr("Changed")); break;
+        }
+        if (file.change != FileDiff::Added) row->setText(2, QString::number(file.left_size));
+        if (file.change != FileDiff::Removed) row->setText(3, QString::number(file.right_size));
+        if (file.sectors > 0) row->setText(4, QString::number(file.sectors));
+        for (int column = 2; column <= 4; column++) row->setTextAlignment(column, numbers);
+    }
+
+    for (const SectorDiff & sector : diff.sector_diffs) {
+        QTreeWidgetItem *row = new QTreeWidgetItem(sectorsTree);
+        row->setText(0, QString::number(sector.track));
+        row->setText(1, QString::number(sector.head));
+        row->setText(2, QString::number(sector.sector));
+        row->setText(3, QString::number(sector.bytes));
+        for (int column = 0; column <= 3; column++) row->setTextAlignment(column, numbers);
+        row->setText(4, sector.left_files.join(", "));
+        row->setText(5, sector.right_files.join(", "));
+    }
+
+    QString summary = CompareDialog::tr("Left: %1, right: %2.").arg(left_name, right_name);
+    if (!diff.same_geometry)
+        summary += " " + CompareDialog::tr("The images have different geometry, only the common part is compared.");
+    summary += "\n" + CompareDialog::tr("Sectors compared: %1, different: %2, unreadable: %3. Files changed: %4. Time: %5 ms.")
+                          .arg(diff.sectors_compared)
+                          .arg(diff.sector_diffs.size())
+                          .arg(diff.sectors_unreadable)
+                          .arg(diff.file_diffs.size())
+                          .arg(diff.elapsed_ms);
+    summaryLabel->setText(summary);
+}
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass showing differences between two disk images
+
+#pragma once
+
+#include <QDialog>
+#include <QLabel>
+#include <QTreeWidget>
+
+#include "ImageDiff.h"
+
+class CompareDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CompareDialog(QWidget *parent, const QString & left_name, const QString & right_name, const ImageDiffResult & diff);
+
+private:
+    QLabel * summaryLabel;
+    QTreeWidget * filesTree;
+    QTreeWidget * sectorsTree;
+
+    void setupUi();
+    void showDiff(const QString & left_name, const QString & right_name, const ImageDiffResult & diff);
+};
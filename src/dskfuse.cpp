@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: Read-only FUSE mount of disk images
+
+#define FUSE_USE_VERSION 31
+
+#include <fuse.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ImageMount.h"
+
+namespace {
+
+struct Options {
+    const char * source {nullptr};
+    unsigned cache_mb {64};
+    int show_help {0};
+};
+
+const fuse_opt option_spec[] = {
+    {"--cache=%u", offsetof(Options, cache_mb), 0},
+    {"-h", offsetof(Options, show_help), 1},
+    {"--help", offsetof(Options, show_help), 1},
+    FUSE_OPT_END
+};
+
+std::unique_ptr<ImageMount> mount;
+
+void fill_stat(const ImageMount::Stat & s, struct stat * st)
+{
+    std::memset(st, 0, sizeof(*st));
+    if (s.is_dir) {
+        st->st_mode = S_IFDIR | 0555;
+        st->st_nlink = 2;
+    } else {
+        st->st_mode = S_IFREG | 0444;
+        st->st_nlink = 1;
+        st->st_size = static_cast<off_t>(s.size);
+    }
+    st->st_mtime = s.mtime;
+    st->st_uid = getuid();
+    st->st_gid = getgid();
+}
+
+void * dsk_init(fuse_conn_info * conn, fuse_config * cfg)
+{
+    (void) conn;
+    // Image files may be replaced on disk, so cached pages must not outlive an open()
+    cfg->kernel_cache = 0;
+    return nullptr;
+}
+
+int dsk_getattr(const char * path, struct stat * st, fuse_file_info * fi)
+{
+    (void) fi;
+    ImageMount::Stat s;
+    const int res = mount->stat(path, s);
+    if (res == 0) fill_stat(s, st);
+    return res;
+}
+
+int dsk_readdir(const char * path, void * buf, fuse_fill_dir_t filler, off_t offset,
+                fuse_file_info * fi, fuse_readdir_flags flags)
+{
+    (void) offset;
+    (void) fi;
+    (void) flags;
+
+    std::vector<std::pair<std::string, ImageMount::Stat>> entries;
+    const int res = mount->list(path, entries);
+    if (res != 0) return res;
+
+    filler(buf, ".", nullptr, 0, static_cast<fuse_fill_dir_flags>(0));
+    filler(buf, "..", nullptr, 0, static_cast<fuse_fill_dir_flags>(0));
+    for (const auto & entry : entries) {
+        struct stat st;
+        fill_stat(entry.second, &st);
+        if (filler(buf, entry.first.c_str(), &st, 0, static_cast<fuse_fill_dir_flags>(0))) break;
+    }
+    return 0;
+}
+
+int dsk_open(const char * path, fuse_file_info * fi)
+{
+    if ((fi->flags & O_ACCMODE) != O_RDONLY) return -EROFS;
+    const int res = mount->open(path);
+    if (res != 0) return res;
+    // Sizes inside images are estimates until a file is decoded, so reads are not cut at st_size
+    fi->direct_io = 1;
+    return 0;
+}
+
+int dsk_read(const char * path, char * buf, size_t size, off_t offset, fuse_file_info * fi)
+{
+    (void) fi;
+    if (offset < 0) return -EINVAL;
+    return mount->read(path, buf, size, static_cast<uint64_t>(offset));
+}
+
+void usage(const char * program)
+{
+    std::printf(
+        "usage: %s [options] <image or directory> <mountpoint>\n\n"
+        "Mounts a disk image, or a directory where each image is shown as a subdirectory.\n\n"
+        "    --cache=MB             size of the decoded files cache (default: 64)\n\n",
+        program
+    );
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    fuse_args args = FUSE_ARGS_INIT(argc, argv);
+    Options options;
+
+    // The first free-standing argument is the source, the rest goes to FUSE
+    auto proc = [](void * data, const char * arg, int key, fuse_args * outargs) -> int {
+        (void) outargs;
+        Options * o = static_cast<Options *>(data);
+        if (key == FUSE_OPT_KEY_NONOPT && !o->source) {
+            o->source = arg;
+            return 0;
+        }
+        return 1;
+    };
+    if (fuse_opt_parse(&args, &options, option_spec, proc) == -1) return 1;
+
+    if (options.show_help) {
+        // FUSE prints its own options and exits without mounting
+        usage(argv[0]);
+        fuse_opt_add_arg(&args, "--help");
+        args.argv[0][0] = '\0';
+    } else if (!options.source) {
+        usage(argv[0]);
+        fuse_opt_free_args(&args);
+        return 1;
+    } else {
+        mount.reset(new ImageMount(static_cast<size_t>(options.cache_mb) * 1024 * 1024));
+        std::string error;
+        if (!mount->setSource(options.source, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            fuse_opt_free_args(&args);
+            return 1;
+        }
+    }
+
+    fuse_operations operations;
+    std::memset(&operations, 0, sizeof(operations));
+    operations.init = dsk_init;
+    operations.getattr = dsk_getattr;
+    operations.readdir = dsk_readdir;
+    operations.open = dsk_open;
+    operations.read = dsk_read;
+
+    fuse_opt_add_arg(&args, "-oro");
+    const int result = fuse_main(args.argc, args.argv, &operations, nullptr);
+    fuse_opt_free_args(&args);
+    mount.reset();
+    return result;
+}
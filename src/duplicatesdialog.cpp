@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass listing files with the same contents across disk images
+
+#include "duplicatesdialog.h"
+#include "ImageUtils.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QMessageBox>
+#include <QThread>
+
+namespace {
+
+// Columns of the results
+enum {
+    ColumnImage,
+    ColumnFile,
+    ColumnSize
+};
+
+// Item data of the image column
+const int ImageRole = Qt::UserRole;
+const int PathRole = Qt::UserRole + 1;
+
+} // namespace
+
+DuplicatesDialog::DuplicatesDialog(QWidget *parent,
+                                   QSettings *settings,
+                                   const QJsonObject * file_formats,
+                                   std::shared_ptr<const FileIndex> & index,
+                                   const QString & source_dir)
+    : QDialog(parent)
+    , m_settings(settings)
+    , m_file_formats(file_formats)
+    , m_index(index)
+{
+    m_indexer = new FileIndexer(this);
+
+    setupUi();
+
+    sourceEdit->setText(m_index ? QDir::toNativeSeparators(m_index->root)
+                                : m_settings->value("duplicates/source_dir", source_dir).toString());
+    recursiveCheck->setChecked(m_settings->value("duplicates/recursive", true).toBool());
+    sha256Check->setChecked(m_settings->value("duplicates/sha256", false).toBool());
+    threadsCounter->setValue(m_settings->value("duplicates/threads", QThread::idealThreadCount()).toInt());
+
+    connect(m_indexer, &BatchRunner::progress, this, &DuplicatesDialog::onProgress);
+    connect(m_indexer, &BatchRunner::finished, this, &DuplicatesDialog::onFinished);
+
+    setRunning(false);
+    showIndex();
+}
+
+DuplicatesDialog::~DuplicatesDialog()
+{
+    // Workers reference the indexer, so they must be gone before it is destroyed
+    m_indexer->cancel();
+    m_indexer->wait();
+}
+
+void DuplicatesDialog::setupUi()
+{
+    setWindowTitle(DuplicatesDialog::tr("Duplicate files"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // Source ------------------------------------------------------------------
+    QGroupBox *sourceGroup = new QGroupBox(DuplicatesDialog::tr("Images"), this);
+    QGridLayout *sourceLayout = new QGridLayout(sourceGroup);
+
+    sourceEdit = new QLineEdit(sourceGroup);
+    QPushButton *sourceButton = new QPushButton("...", sourceGroup);
+    recursiveCheck = new QCheckBox(DuplicatesDialog::tr("Include subdirectories"), sourceGroup);
+    sha256Check = new QCheckBox(DuplicatesDialog::tr("Verify with SHA-256"), sourceGroup);
+    threadsCounter = new QSpinBox(sourceGroup);
+    threadsCounter->setRange(1, 64);
+
+    sourceLayout->addWidget(new QLabel(DuplicatesDialog::tr("Directory:"), sourceGroup), 0, 0);
+    sourceLayout->addWidget(sourceEdit, 0, 1, 1, 2);
+    sourceLayout->addWidget(sourceButton, 0, 3);
+    sourceLayout->addWidget(recursiveCheck, 1, 1);
+    sourceLayout->addWidget(sha256Check, 1, 2, 1, 2);
+    sourceLayout->addWidget(new QLabel(DuplicatesDialog::tr("Threads:"), sourceGroup), 2, 0);
+    sourceLayout->addWidget(threadsCounter, 2, 1);
+    sourceLayout->setColumnStretch(1, 1);
+    layout->addWidget(sourceGroup);
+
+    connect(sourceButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, DuplicatesDialog::tr("Choose directory"), sourceEdit->text());
+        if (!dir.isEmpty()) sourceEdit->setText(QDir::toNativeSeparators(dir));
+    });
+
+    // Results -----------------------------------------------------------------
+    progressBar = new QProgressBar(this);
+    layout->addWidget(progressBar);
+
+    resultsTree = new QTreeWidget(this);
+    resultsTree->setUniformRowHeights(true);
+    resultsTree->setHeaderLabels(QStringList()
+                                 << DuplicatesDialog::tr("Image")
+                                 << DuplicatesDialog::tr("File")
+                                 << DuplicatesDialog::tr("Size"));
+    resultsTree->header()->setStretchLastSection(false);
+    resultsTree->header()->setSectionResizeMode(ColumnFile, QHeaderView::Stretch);
+    resultsTree->setColumnWidth(ColumnImage, 350);
+    resultsTree->setColumnWidth(ColumnSize, 80);
+    layout->addWidget(resultsTree, 1);
+
+    connect(resultsTree, &QTreeWidget::itemActivated, this, &DuplicatesDialog::onResultActivated);
+
+    summaryLabel = new QLabel(this);
+    layout->addWidget(summaryLabel);
+
+    // Buttons -----------------------------------------------------------------
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    startButton = new QPushButton(DuplicatesDialog::tr("Index"), this);
+    cancelButton = new QPushButton(DuplicatesDialog::tr("Stop"), this);
+    closeButton = new QPushButton(DuplicatesDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(cancelButton);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(startButton, &QPushButton::clicked, this, &DuplicatesDialog::onStart);
+    connect(cancelButton, &QPushButton::clicked, this, &DuplicatesDialog::onCancel);
+    connect(closeButton, &QPushButton::clicked, this, &DuplicatesDialog::reject);
+
+    resize(800, 640);
+}
+
+void DuplicatesDialog::setTarget(const QString & name, const dsk_tools::BYTES & data)
+{
+    m_target_name = name;
+    m_target_data = data;
+    setWindowTitle(DuplicatesDialog::tr("Copies of '%1'").arg(name));
+    showIndex();
+}
+
+void DuplicatesDialog::setRunning(bool running)
+{
+    startButton->setEnabled(!running);
+    cancelButton->setEnabled(running);
+    sourceEdit->setEnabled(!running);
+    recursiveCheck->setEnabled(!running);
+    sha256Check->setEnabled(!running);
+    threadsCounter->setEnabled(!running);
+}
+
+void DuplicatesDialog::saveSetup()
+{
+    m_settings->setValue("duplicates/source_dir", sourceEdit->text());
+    m_settings->setValue("duplicates/recursive", recursiveCheck->isChecked());
+    m_settings->setValue("duplicates/sha256", sha256Check->isChecked());
+    m_settings->setValue("duplicates/threads", threadsCounter->value());
+}
+
+void DuplicatesDialog::onStart()
+{
+    const QString source_root = QDir::fromNativeSeparators(sourceEdit->text());
+    if (source_root.isEmpty() || !QFileInfo(source_root).isDir()) {
+        QMessageBox::critical(this, DuplicatesDialog::tr("Error"), DuplicatesDialog::tr("Source directory not found."));
+        return;
+    }
+    saveSetup();
+
+    const QStringList images = ImageUtils::collectImages(
+        source_root,
+        ImageUtils::sourceFilters(*m_file_formats),
+        recursiveCheck->isChecked()
+    );
+    if (images.isEmpty()) {
+        QMessageBox::information(this, windowTitle(), DuplicatesDialog::tr("No disk images found."));
+        return;
+    }
+
+    resultsTree->clear();
+    summaryLabel->clear();
+    progressBar->setRange(0, images.size());
+    progressBar->setValue(0);
+
+    m_indexer->setOptions(source_root, sha256Check->isChecked());
+    m_indexer->setMaxThreads(threadsCounter->value());
+    setRunning(true);
+    if (!m_indexer->start(images)) {
+        setRunning(false);
+        QMessageBox::critical(this, DuplicatesDialog::tr("Error"), m_indexer->errorString());
+    }
+}
+
+void DuplicatesDialog::onCancel()
+{
+    m_indexer->cancel();
+    cancelButton->setEnabled(false);
+}
+
+void DuplicatesDialog::onProgress(int done, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(done);
+}
+
+void DuplicatesDialog::onFinished(int succeeded, int failed, qint64 elapsed_ms)
+{
+    Q_UNUSED(succeeded);
+    Q_UNUSED(failed);
+    Q_UNUSED(elapsed_ms);
+    setRunning(false);
+    m_index = m_indexer->index();
+    showIndex();
+}
+
+QTreeWidgetItem * DuplicatesDialog::addEntry(QTreeWidgetItem * parent, const FileIndexEntry & entry)
+{
+    const QString image = m_index->images.at(static_cast<int>(entry.image));
+
+    QTreeWidgetItem * row = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem(resultsTree);
+    row->setText(ColumnImage, QDir::toNativeSeparators(QDir(m_index->root).relativeFilePath(image)));
+    row->setToolTip(ColumnImage, QDir::toNativeSeparators(image));
+    row->setData(ColumnImage, ImageRole, image);
+    row->setData(ColumnImage, PathRole, entry.path);
+    row->setText(ColumnFile, entry.path);
+    row->setText(ColumnSize, QString::number(entry.digest.size));
+    row->setTextAlignment(ColumnSize, Qt::AlignRight | Qt::AlignVCenter);
+    return row;
+}
+
+void DuplicatesDialog::showIndex()
+{
+    resultsTree->clear();
+    if (!m_index) {
+        summaryLabel->setText(DuplicatesDialog::tr("Files of the images are not indexed yet."));
+        return;
+    }
+
+    QString summary;
+    if (!m_target_name.isEmpty()) {
+        // The digest must be made the same way as the index ones
+        const FileDigest digest = FileDigest::of(m_target_data, m_index->sha256);
+        const FileIndex::Range range = m_index->copies(digest);
+        resultsTree->setRootIsDecorated(false);
+        for (size_t i = range.first; i < range.second; i++) addEntry(nullptr, m_index->entries[i]);
+        summary = DuplicatesDialog::tr("Files with the same contents as '%1': %2")
+                      .arg(m_target_name)
+                      .arg(range.second - range.first);
+    } else {
+        const std::vector<FileIndex::Range> groups = m_index->duplicates();
+        resultsTree->setRootIsDecorated(true);
+        quint64 wasted = 0;
+        for (const FileIndex::Range & range : groups) {
+            const FileIndexEntry & first = m_index->entries[range.first];
+            const size_t count = range.second - range.first;
+            wasted += first.digest.size * (count - 1);
+
+            QTreeWidgetItem * group = new QTreeWidgetItem(resultsTree);
+            group->setText(ColumnImage, DuplicatesDialog::tr("%1 copies").arg(count));
+            group->setText(ColumnFile, first.path);
+            group->setText(ColumnSize, QString::number(first.digest.size));
+            group->setTextAlignment(ColumnSize, Qt::AlignRight | Qt::AlignVCenter);
+            for (size_t i = range.first; i < range.second; i++) addEntry(group, m_index->entries[i]);
+        }
+        summary = DuplicatesDialog::tr("Files: %1, groups of duplicates: %2, bytes in extra copies: %3")
+                      .arg(m_index->entries.size())
+                      .arg(groups.size())
+                      .arg(wasted);
+    }
+    if (!m_index->complete) summary += " " + DuplicatesDialog::tr("(indexing was stopped)");
+    summaryLabel->setText(summary);
+}
+
+void DuplicatesDialog::onResultActivated(QTreeWidgetItem * item)
+{
+    const QString image = item->data(ColumnImage, ImageRole).toString();
+    if (image.isEmpty()) return;
+
+    if (m_indexer->isRunning()) {
+        m_indexer->cancel();
+        m_indexer->wait();
+    }
+    m_selected_image = image;
+    m_selected_path = item->data(ColumnImage, PathRole).toString();
+    accept();
+}
+
+void DuplicatesDialog::reject()
+{
+    if (m_indexer->isRunning()) {
+        m_indexer->cancel();
+        m_indexer->wait();
+    }
+    QDialog::reject();
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass listing files with the same contents across disk images
+
+#pragma once
+
+#include <memory>
+
+#include <QDialog>
+#include <QSettings>
+#include <QJsonObject>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include "FileIndex.h"
+
+class DuplicatesDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // index is the one built last; the dialog shows it and replaces it after a new run
+    explicit DuplicatesDialog(QWidget *parent,
+                              QSettings *settings,
+                              const QJsonObject * file_formats,
+                              std::shared_ptr<const FileIndex> & index,
+                              const QString & source_dir);
+    ~DuplicatesDialog();
+
+    // Shows only copies of this file instead of all duplicates
+    void setTarget(const QString & name, const dsk_tools::BYTES & data);
+
+    // The file chosen by the user, valid after the dialog is accepted
+    QString selectedImage() const { return m_selected_image; }
+    QString selectedPath() const { return m_selected_path; }
+
+protected:
+    void reject() override;
+
+private slots:
+    void onStart();
+    void onCancel();
+    void onProgress(int done, int total);
+    void onFinished(int succeeded, int failed, qint64 elapsed_ms);
+    void onResultActivated(QTreeWidgetItem * item);
+
+private:
+    QSettings * m_settings;
+    const QJsonObject * m_file_formats;
+    std::shared_ptr<const FileIndex> & m_index;
+
+    FileIndexer * m_indexer;
+    QString m_target_name;
+    dsk_tools::BYTES m_target_data;
+    QString m_selected_image;
+    QString m_selected_path;
+
+    QLineEdit * sourceEdit;
+    QCheckBox * recursiveCheck;
+    QCheckBox * sha256Check;
+    QSpinBox * threadsCounter;
+    QProgressBar * progressBar;
+    QTreeWidget * resultsTree;
+    QLabel * summaryLabel;
+    QPushButton * startButton;
+    QPushButton * cancelButton;
+    QPushButton * closeButton;
+
+    void setupUi();
+    void saveSetup();
+    void setRunning(bool running);
+    void showIndex();
+    QTreeWidgetItem * addEntry(QTreeWidgetItem * parent, const FileIndexEntry & entry);
+};
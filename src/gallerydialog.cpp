@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass showing thumbnails of the pictures in a disk image
+
+#include "gallerydialog.h"
+#include "viewdialog.h"
+#include "ViewerRegistry.h"
+#include "mainutils.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QPixmap>
+#include <QPushButton>
+#include <QElapsedTimer>
+
+namespace {
+
+// Reading and matching files runs in the GUI thread, in slices this long
+const int PREPARE_SLICE_MS = 15;
+
+} // namespace
+
+GalleryDialog::GalleryDialog(QWidget *parent, QSettings *settings, dsk_tools::diskImage * image, dsk_tools::fileSystem * filesystem)
+    : QDialog(parent)
+    , m_settings(settings)
+    , m_image(image)
+    , m_filesystem(filesystem)
+{
+    setupUi();
+
+    connect(&m_renderer, &ThumbnailRenderer::thumbnailReady, this, &GalleryDialog::onThumbnailReady);
+    connect(&m_prepare_timer, &QTimer::timeout, this, &GalleryDialog::onPrepareTimer);
+
+    dsk_tools::Files files;
+    m_filesystem->dir(files, false);
+    m_files = makeListing(std::move(files));
+    m_prepare_timer.start(0);
+    updateStatus();
+
+    resize(800, 600);
+}
+
+void GalleryDialog::setupUi()
+{
+    setWindowTitle(GalleryDialog::tr("Picture gallery"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    listWidget = new QListWidget(this);
+    listWidget->setViewMode(QListView::IconMode);
+    listWidget->setIconSize(QSize(ThumbnailRenderer::SIZE, ThumbnailRenderer::SIZE));
+    listWidget->setMovement(QListView::Static);
+    listWidget->setResizeMode(QListView::Adjust);
+    listWidget->setUniformItemSizes(true);
+    listWidget->setSpacing(6);
+    listWidget->setWordWrap(true);
+    layout->addWidget(listWidget, 1);
+
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    statusLabel = new QLabel(this);
+    QPushButton *closeButton = new QPushButton(GalleryDialog::tr("Close"), this);
+    buttonsLayout->addWidget(statusLabel, 1);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    // Shown until the thumbnail is rendered
+    QPixmap placeholder(ThumbnailRenderer::SIZE, ThumbnailRenderer::SIZE);
+    placeholder.fill(Qt::transparent);
+    QPainter painter(&placeholder);
+    painter.setPen(QPen(palette().color(QPalette::Disabled, QPalette::Text), 1, Qt::DashLine));
+    painter.drawRect(placeholder.rect().adjusted(0, 0, -1, -1));
+    painter.end();
+    m_placeholder = QIcon(placeholder);
+
+    connect(listWidget, &QListWidget::itemActivated, this, &GalleryDialog::onItemActivated);
+    connect(closeButton, &QPushButton::clicked, this, &GalleryDialog::close);
+}
+
+void GalleryDialog::onPrepareTimer()
+{
+    QElapsedTimer slice;
+    slice.start();
+    while (m_next < m_files->size() && slice.elapsed() < PREPARE_SLICE_MS)
+        prepareFile(m_next++);
+
+    if (m_next >= m_files->size()) m_prepare_timer.stop();
+    updateStatus();
+}
+
+void GalleryDialog::prepareFile(size_t index)
+{
+    const dsk_tools::UniversalFile & f = (*m_files)[index];
+    if (f.is_dir) return;
+
+    dsk_tools::BYTES data;
+    m_filesystem->get_file(f, "", data);
+    if (data.empty()) return;
+
+    // The same viewer and subtype the file would open with
+    std::string type, subtype;
+    ViewerRegistry::suggest(f, data, type, subtype);
+    if (type.compare(0, 7, "PICTURE") != 0) return;
+    if (subtype.empty()) {
+        const ViewerRegistry::FitMap fits = ViewerRegistry::instance().fits(data);
+        const auto it = fits.find(type);
+        if (it == fits.end() || it->second.empty()) return;
+        subtype = it->second.front();
+    }
+
+    std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create(type, subtype);
+    auto picViewer = dynamic_cast<dsk_tools::ViewerPic*>(viewer.get());
+    if (!picViewer) return;
+
+    std::string error_msg;
+    if (!picViewer->prepare_data(data, *m_image, *m_filesystem, error_msg)) return;
+    const dsk_tools::ViewerSelectorValues selectors = picViewer->suggest_selectors(f.name, data);
+    picViewer->set_selectors(selectors);
+
+    const int id = static_cast<int>(m_pictures.size());
+    m_pictures.emplace_back(m_files, index);
+
+    QListWidgetItem * item = new QListWidgetItem(m_placeholder, QString::fromStdString(f.name), listWidget);
+    item->setData(Qt::UserRole, id);
+    item->setToolTip(QString::fromStdString(f.name));
+
+    const QString key = ThumbnailRenderer::key(data, f.name, type, subtype, selectors);
+    const QImage thumbnail = ThumbnailRenderer::cached(key);
+    if (!thumbnail.isNull()) {
+        item->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+    } else {
+        viewer.release();
+        m_renderer.render(id, key, std::unique_ptr<dsk_tools::ViewerPic>(picViewer), data);
+        m_pending++;
+    }
+}
+
+void GalleryDialog::onThumbnailReady(int id, const QImage & image)
+{
+    m_pending--;
+    // Items are only appended, so an id is also the row
+    QListWidgetItem * item = listWidget->item(id);
+    if (item && !image.isNull())
+        item->setIcon(QIcon(QPixmap::fromImage(image)));
+    updateStatus();
+}
+
+void GalleryDialog::onItemActivated(QListWidgetItem * item)
+{
+    const int id = item->data(Qt::UserRole).toInt();
+    if (id < 0 || id >= static_cast<int>(m_pictures.size())) return;
+    const FileHandle & handle = m_pictures[id];
+    const dsk_tools::UniversalFile & f = *handle;
+
+    dsk_tools::BYTES data;
+    m_filesystem->get_file(f, "", data);
+    if (data.empty()) return;
+
+    QDialog * w = new ViewDialog(
+                        this,
+                        m_settings,
+                        QString::fromStdString(f.name),
+                        data,
+                        f.type_preferred,
+                        f.is_deleted,
+                        m_image,
+                        m_filesystem,
+                        handle
+    );
+    w->setAttribute(Qt::WA_DeleteOnClose);
+    w->setWindowTitle(w->windowTitle() + " (" + QString::fromStdString(f.name) + ")");
+    w->show();
+}
+
+void GalleryDialog::updateStatus()
+{
+    if (m_next < m_files->size() || m_pending > 0)
+        statusLabel->setText(GalleryDialog::tr("Pictures: %1, loading...").arg(m_pictures.size()));
+    else
+        statusLabel->setText(GalleryDialog::tr("Pictures: %1").arg(m_pictures.size()));
+}
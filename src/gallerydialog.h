@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass showing thumbnails of the pictures in a disk image
+
+#pragma once
+
+#include <QDialog>
+#include <QSettings>
+#include <QListWidget>
+#include <QLabel>
+#include <QTimer>
+
+#include "ThumbnailRenderer.h"
+#include "FileHandle.h"
+#include "dsk_tools/dsk_tools.h"
+
+class GalleryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit GalleryDialog(QWidget *parent, QSettings *settings, dsk_tools::diskImage * image, dsk_tools::fileSystem * filesystem);
+
+private slots:
+    void onPrepareTimer();
+    void onThumbnailReady(int id, const QImage & image);
+    void onItemActivated(QListWidgetItem * item);
+
+private:
+    QSettings * m_settings;
+    dsk_tools::diskImage * m_image;
+    dsk_tools::fileSystem * m_filesystem;
+
+    ThumbnailRenderer m_renderer;
+    QTimer m_prepare_timer;
+    QIcon m_placeholder;
+
+    FileListing m_files;                        // The current directory of the image
+    size_t m_next {0};                          // The first file not checked yet
+    FileHandles m_pictures;                     // Item ids index this
+    int m_pending {0};                          // Thumbnails being rendered
+
+    QListWidget * listWidget;
+    QLabel * statusLabel;
+
+    void setupUi();
+    void prepareFile(size_t index);
+    void updateStatus();
+};
@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass checking a directory of disk images for bad sectors
+
+#include "integritydialog.h"
+#include "ImageUtils.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QMessageBox>
+#include <QThread>
+#include <QJsonArray>
+
+namespace {
+
+// Columns of the results
+enum {
+    ColumnImage,
+    ColumnStatus,
+    ColumnSectors,
+    ColumnFiles
+};
+
+// Item data of the image column
+const int ImageRole = Qt::UserRole;
+
+} // namespace
+
+IntegrityDialog::IntegrityDialog(QWidget *parent,
+                                 QSettings *settings,
+                                 const QJsonObject * file_formats,
+                                 const QString & source_dir)
+    : QDialog(parent)
+    , m_settings(settings)
+    , m_file_formats(file_formats)
+{
+    m_scanner = new IntegrityScanner(this);
+
+    setupUi();
+
+    sourceEdit->setText(m_settings->value("integrity/source_dir", source_dir).toString());
+    recursiveCheck->setChecked(m_settings->value("integrity/recursive", true).toBool());
+    threadsCounter->setValue(m_settings->value("integrity/threads", QThread::idealThreadCount()).toInt());
+    reportEdit->setText(m_settings->value("integrity/report_file",
+                                          QDir::toNativeSeparators(QDir(source_dir).filePath("integrity.csv"))).toString());
+    resumeCheck->setChecked(m_settings->value("integrity/resume", true).toBool());
+
+    connect(m_scanner, &BatchRunner::progress, this, &IntegrityDialog::onProgress);
+    connect(m_scanner, &BatchRunner::itemFinished, this, &IntegrityDialog::onItemFinished);
+    connect(m_scanner, &BatchRunner::finished, this, &IntegrityDialog::onFinished);
+
+    setRunning(false);
+}
+
+IntegrityDialog::~IntegrityDialog()
+{
+    // Workers reference the scanner, so they must be gone before it is destroyed
+    m_scanner->cancel();
+    m_scanner->wait();
+}
+
+void IntegrityDialog::setupUi()
+{
+    setWindowTitle(IntegrityDialog::tr("Check images"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // Source ------------------------------------------------------------------
+    QGroupBox *sourceGroup = new QGroupBox(IntegrityDialog::tr("Images"), this);
+    QGridLayout *sourceLayout = new QGridLayout(sourceGroup);
+
+    sourceEdit = new QLineEdit(sourceGroup);
+    QPushButton *sourceButton = new QPushButton("...", sourceGroup);
+    recursiveCheck = new QCheckBox(IntegrityDialog::tr("Include subdirectories"), sourceGroup);
+    threadsCounter = new QSpinBox(sourceGroup);
+    threadsCounter->setRange(1, 64);
+
+    sourceLayout->addWidget(new QLabel(IntegrityDialog::tr("Directory:"), sourceGroup), 0, 0);
+    sourceLayout->addWidget(sourceEdit, 0, 1, 1, 2);
+    sourceLayout->addWidget(sourceButton, 0, 3);
+    sourceLayout->addWidget(recursiveCheck, 1, 1);
+    sourceLayout->addWidget(new QLabel(IntegrityDialog::tr("Threads:"), sourceGroup), 2, 0);
+    sourceLayout->addWidget(threadsCounter, 2, 1);
+    sourceLayout->setColumnStretch(1, 1);
+    layout->addWidget(sourceGroup);
+
+    connect(sourceButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, IntegrityDialog::tr("Choose directory"), sourceEdit->text());
+        if (!dir.isEmpty()) sourceEdit->setText(QDir::toNativeSeparators(dir));
+    });
+
+    // Report ------------------------------------------------------------------
+    QGroupBox *reportGroup = new QGroupBox(IntegrityDialog::tr("Report"), this);
+    QGridLayout *reportLayout = new QGridLayout(reportGroup);
+
+    reportEdit = new QLineEdit(reportGroup);
+    QPushButton *reportButton = new QPushButton("...", reportGroup);
+    resumeCheck = new QCheckBox(IntegrityDialog::tr("Continue an interrupted check"), reportGroup);
+
+    reportLayout->addWidget(new QLabel(IntegrityDialog::tr("File:"), reportGroup), 0, 0);
+    reportLayout->addWidget(reportEdit, 0, 1);
+    reportLayout->addWidget(reportButton, 0, 2);
+    reportLayout->addWidget(resumeCheck, 1, 1);
+    reportLayout->setColumnStretch(1, 1);
+    layout->addWidget(reportGroup);
+
+    connect(reportButton, &QPushButton::clicked, this, [this]() {
+        const QString file = QFileDialog::getSaveFileName(this, IntegrityDialog::tr("Report file"), reportEdit->text(),
+                                                          IntegrityDialog::tr("CSV files (*.csv);;JSON files (*.json)"));
+        if (!file.isEmpty()) reportEdit->setText(QDir::toNativeSeparators(file));
+    });
+
+    // Results -----------------------------------------------------------------
+    progressBar = new QProgressBar(this);
+    layout->addWidget(progressBar);
+
+    resultsTree = new QTreeWidget(this);
+    resultsTree->setUniformRowHeights(true);
+    resultsTree->setHeaderLabels(QStringList()
+                                 << IntegrityDialog::tr("Image")
+                                 << IntegrityDialog::tr("Status")
+                                 << IntegrityDialog::tr("Bad sectors")
+                                 << IntegrityDialog::tr("Damaged files"));
+    resultsTree->header()->setStretchLastSection(false);
+    resultsTree->header()->setSectionResizeMode(ColumnImage, QHeaderView::Stretch);
+    resultsTree->setColumnWidth(ColumnStatus, 120);
+    resultsTree->setColumnWidth(ColumnSectors, 90);
+    resultsTree->setColumnWidth(ColumnFiles, 110);
+    layout->addWidget(resultsTree, 1);
+
+    connect(resultsTree, &QTreeWidget::itemActivated, this, &IntegrityDialog::onResultActivated);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    // Buttons -----------------------------------------------------------------
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    startButton = new QPushButton(IntegrityDialog::tr("Check"), this);
+    cancelButton = new QPushButton(IntegrityDialog::tr("Stop"), this);
+    closeButton = new QPushButton(IntegrityDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(cancelButton);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(startButton, &QPushButton::clicked, this, &IntegrityDialog::onStart);
+    connect(cancelButton, &QPushButton::clicked, this, &IntegrityDialog::onCancel);
+    connect(closeButton, &QPushButton::clicked, this, &IntegrityDialog::reject);
+
+    resize(800, 640);
+}
+
+void IntegrityDialog::setRunning(bool running)
+{
+    startButton->setEnabled(!running);
+    cancelButton->setEnabled(running);
+    sourceEdit->setEnabled(!running);
+    recursiveCheck->setEnabled(!running);
+    threadsCounter->setEnabled(!running);
+    reportEdit->setEnabled(!running);
+    resumeCheck->setEnabled(!running);
+}
+
+void IntegrityDialog::saveSetup()
+{
+    m_settings->setValue("integrity/source_dir", sourceEdit->text());
+    m_settings->setValue("integrity/recursive", recursiveCheck->isChecked());
+    m_settings->setValue("integrity/threads", threadsCounter->value());
+    m_settings->setValue("integrity/report_file", reportEdit->text());
+    m_settings->setValue("integrity/resume", resumeCheck->isChecked());
+}
+
+void IntegrityDialog::onStart()
+{
+    const QString source_root = QDir::fromNativeSeparators(sourceEdit->text());
+    if (source_root.isEmpty() || !QFileInfo(source_root).isDir()) {
+        QMessageBox::critical(this, IntegrityDialog::tr("Error"), IntegrityDialog::tr("Source directory not found."));
+        return;
+    }
+    m_report_file = QDir::fromNativeSeparators(reportEdit->text());
+    if (m_report_file.isEmpty()) {
+        QMessageBox::critical(this, IntegrityDialog::tr("Error"), IntegrityDialog::tr("Report file is not set."));
+        return;
+    }
+    saveSetup();
+
+    QStringList images = ImageUtils::collectImages(
+        source_root,
+        ImageUtils::sourceFilters(*m_file_formats),
+        recursiveCheck->isChecked()
+    );
+    if (images.isEmpty()) {
+        QMessageBox::information(this, windowTitle(), IntegrityDialog::tr("No disk images found."));
+        return;
+    }
+
+    resultsTree->clear();
+    summaryLabel->clear();
+
+    m_scanner->setOptions(source_root, IntegrityScanner::checkpointFileName(m_report_file));
+    if (resumeCheck->isChecked() && m_scanner->resume(images) > 0) {
+        for (const QJsonObject & record : m_scanner->resumed()) addRecord(record);
+    }
+    progressBar->setRange(0, images.size());
+    progressBar->setValue(0);
+
+    m_scanner->setMaxThreads(threadsCounter->value());
+    setRunning(true);
+    if (!m_scanner->start(images)) {
+        setRunning(false);
+        QMessageBox::critical(this, IntegrityDialog::tr("Error"), m_scanner->errorString());
+    }
+}
+
+void IntegrityDialog::onCancel()
+{
+    m_scanner->cancel();
+    cancelButton->setEnabled(false);
+}
+
+void IntegrityDialog::onProgress(int done, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(done);
+}
+
+void IntegrityDialog::onItemFinished(int index, const QString & item, bool ok, const QString & message)
+{
+    Q_UNUSED(item);
+    Q_UNUSED(ok);
+    Q_UNUSED(message);
+    const QJsonObject record = m_scanner->result(index);
+    if (!record.isEmpty()) addRecord(record);
+}
+
+void IntegrityDialog::addRecord(const QJsonObject & record)
+{
+    // Only images needing attention are listed, the report has all of them
+    const QString status = record["status"].toString();
+    if (status == "ok") return;
+
+    const QString image = QDir::fromNativeSeparators(record["image"].toString());
+    const QString root = QDir::fromNativeSeparators(sourceEdit->text());
+
+    QTreeWidgetItem * row = new QTreeWidgetItem(resultsTree);
+    row->setText(ColumnImage, QDir::toNativeSeparators(QDir(root).relativeFilePath(image)));
+    row->setToolTip(ColumnImage, QDir::toNativeSeparators(image));
+    row->setData(ColumnImage, ImageRole, image);
+
+    if (!IntegrityScanner::isDamaged(record)) {
+        row->setText(ColumnStatus, IntegrityDialog::tr("Not opened"));
+        row->setToolTip(ColumnStatus, record["message"].toString());
+        row->setForeground(ColumnStatus, QBrush(Qt::red));
+        return;
+    }
+
+    row->setText(ColumnStatus, IntegrityDialog::tr("Damaged"));
+    row->setText(ColumnSectors, QString::number(record["bad_sectors"].toArray().size()));
+    row->setText(ColumnFiles, QString::number(record["files"].toArray().size()));
+    row->setTextAlignment(ColumnSectors, Qt::AlignRight | Qt::AlignVCenter);
+    row->setTextAlignment(ColumnFiles, Qt::AlignRight | Qt::AlignVCenter);
+
+    const auto addFindings = [row](const QString & title, const QJsonArray & findings) {
+        foreach (const QString & finding, IntegrityScanner::translate(findings)) {
+            QTreeWidgetItem * child = new QTreeWidgetItem(row);
+            child->setText(ColumnImage, finding);
+            child->setText(ColumnStatus, title);
+        }
+    };
+    addFindings(IntegrityDialog::tr("Reserved area"), record["reserved"].toArray());
+    addFindings(IntegrityDialog::tr("Directory"), record["directory"].toArray());
+    addFindings(IntegrityDialog::tr("File"), record["files"].toArray());
+}
+
+void IntegrityDialog::onFinished(int succeeded, int failed, qint64 elapsed_ms)
+{
+    Q_UNUSED(succeeded);
+    Q_UNUSED(failed);
+    setRunning(false);
+
+    const QJsonObject report = m_scanner->report();
+    QString summary = IntegrityDialog::tr("Images: %1, damaged: %2, not opened: %3. Time: %4 s.")
+                          .arg(report["images_total"].toInt())
+                          .arg(report["images_damaged"].toInt())
+                          .arg(report["images_failed"].toInt())
+                          .arg(elapsed_ms / 1000);
+    if (report["images_resumed"].toInt() > 0)
+        summary += " " + IntegrityDialog::tr("Taken over from the interrupted check: %1.").arg(report["images_resumed"].toInt());
+    if (!report["complete"].toBool())
+        summary += " " + IntegrityDialog::tr("The check was stopped, it can be continued later.");
+
+    QString error;
+    if (!m_scanner->writeReport(m_report_file, error)) {
+        QMessageBox::critical(this, IntegrityDialog::tr("Error"), error);
+    } else {
+        summary += "\n" + IntegrityDialog::tr("Report: %1").arg(QDir::toNativeSeparators(m_report_file));
+    }
+    summaryLabel->setText(summary);
+}
+
+void IntegrityDialog::onResultActivated(QTreeWidgetItem * item)
+{
+    // Findings open the image they belong to
+    if (item->parent()) item = item->parent();
+    const QString image = item->data(ColumnImage, ImageRole).toString();
+    if (image.isEmpty()) return;
+
+    if (m_scanner->isRunning()) {
+        m_scanner->cancel();
+        m_scanner->wait();
+    }
+    m_selected_image = image;
+    accept();
+}
+
+void IntegrityDialog::reject()
+{
+    if (m_scanner->isRunning()) {
+        m_scanner->cancel();
+        m_scanner->wait();
+    }
+    QDialog::reject();
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass checking a directory of disk images for bad sectors
+
+#pragma once
+
+#include <QDialog>
+#include <QSettings>
+#include <QJsonObject>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include "IntegrityScanner.h"
+
+class IntegrityDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit IntegrityDialog(QWidget *parent,
+                             QSettings *settings,
+                             const QJsonObject * file_formats,
+                             const QString & source_dir);
+    ~IntegrityDialog();
+
+    // The image chosen by the user, valid after the dialog is accepted
+    QString selectedImage() const { return m_selected_image; }
+
+protected:
+    void reject() override;
+
+private slots:
+    void onStart();
+    void onCancel();
+    void onProgress(int done, int total);
+    void onItemFinished(int index, const QString & item, bool ok, const QString & message);
+    void onFinished(int succeeded, int failed, qint64 elapsed_ms);
+    void onResultActivated(QTreeWidgetItem * item);
+
+private:
+    QSettings * m_settings;
+    const QJsonObject * m_file_formats;
+
+    IntegrityScanner * m_scanner;
+    QString m_report_file;
+    QString m_selected_image;
+
+    QLineEdit * sourceEdit;
+    QCheckBox * recursiveCheck;
+    QSpinBox * threadsCounter;
+    QLineEdit * reportEdit;
+    QCheckBox * resumeCheck;
+    QProgressBar * progressBar;
+    QTreeWidget * resultsTree;
+    QLabel * summaryLabel;
+    QPushButton * startButton;
+    QPushButton * cancelButton;
+    QPushButton * closeButton;
+
+    void setupUi();
+    void saveSetup();
+    void setRunning(bool running);
+    void addRecord(const QJsonObject & record);
+};
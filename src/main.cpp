@@ -4,16 +4,144 @@
 // Description: main.cpp
 
 #include "mainwindow.h"
+#include "ImageUtils.h"
+#include "JobRunner.h"
+#ifdef DSK_IMAGE_SERVER
+#include "ImageServer.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QEventLoop>
 #include <QFile>
 #include <QIcon>
 #include <QLocale>
 #include <QTextStream>
 #include <QTranslator>
 
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+// The program is built as a GUI application, so on Windows the console modes
+// have to attach to the console of the calling shell to print anything
+static void attachConsole()
+{
+#ifdef Q_OS_WIN
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        std::freopen("CONOUT$", "w", stdout);
+        std::freopen("CONOUT$", "w", stderr);
+    }
+#endif
+}
+
+// dsk_commander --job job.json [--report report.json] [--threads N]
+static int runJob(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption jobOption("job", "Run a JSON job file without the user interface.", "file");
+    const QCommandLineOption reportOption("report", "Write the job report to this file.", "file");
+    const QCommandLineOption threadsOption("threads", "Number of images processed in parallel.", "count");
+    parser.addOption(jobOption);
+    parser.addOption(reportOption);
+    parser.addOption(threadsOption);
+    parser.process(a);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QJsonObject file_formats, file_types, file_systems;
+    QString error;
+    if (!ImageUtils::loadConfig(file_formats, file_types, file_systems, error)) {
+        err << error << "\n";
+        return 2;
+    }
+
+    JobRunner runner(file_formats, file_types);
+    if (!runner.load(parser.value(jobOption), error)) {
+        err << error << "\n";
+        return 2;
+    }
+
+    int threads = runner.maxThreadsRequested();
+    if (parser.isSet(threadsOption)) threads = parser.value(threadsOption).toInt();
+    if (threads > 0) runner.setMaxThreads(threads);
+
+    QObject::connect(&runner, &BatchRunner::itemFinished,
+        [&out](int index, const QString & item, bool ok, const QString & message) {
+            Q_UNUSED(index);
+            out << (ok ? "[ OK ] " : "[FAIL] ") << QDir::toNativeSeparators(item) << ": " << message << "\n";
+            out.flush();
+        });
+
+    QEventLoop loop;
+    QObject::connect(&runner, &BatchRunner::finished, &loop, &QEventLoop::quit);
+    if (!runner.start(runner.images())) {
+        err << runner.errorString() << "\n";
+        return 2;
+    }
+    if (runner.isRunning()) loop.exec();
+
+    const QJsonObject report = runner.report();
+    const QString report_file = parser.isSet(reportOption) ? parser.value(reportOption) : runner.reportFileName();
+    if (!report_file.isEmpty() && !runner.writeReport(report_file, error)) err << error << "\n";
+
+    out << "Images: " << report["images_total"].toInt()
+        << ", ok: " << report["images_ok"].toInt()
+        << ", failed: " << report["images_failed"].toInt()
+        << ", " << report["elapsed_ms"].toDouble() / 1000 << " s\n";
+
+    return report["images_failed"].toInt() > 0 ? 1 : 0;
+}
+
+#ifdef DSK_IMAGE_SERVER
+// dsk_commander --server [--name NAME]
+static int runServer(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption serverOption("server", "Keep disk images loaded for external tools.");
+    const QCommandLineOption nameOption("name", "Local socket name.", "name", ImageProtocol::defaultServerName());
+    parser.addOption(serverOption);
+    parser.addOption(nameOption);
+    parser.process(a);
+
+    ImageServer server;
+    QString error;
+    if (!server.listen(parser.value(nameOption), error)) {
+        QTextStream(stderr) << error << "\n";
+        return 2;
+    }
+    QObject::connect(&server, &ImageServer::shutdownRequested, &a, &QCoreApplication::quit);
+    QTextStream(stdout) << "Listening on " << server.serverName() << "\n";
+    return a.exec();
+}
+#endif
+
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--job") == 0 || std::strncmp(argv[i], "--job=", 6) == 0) {
+            attachConsole();
+            return runJob(argc, argv);
+        }
+#ifdef DSK_IMAGE_SERVER
+        if (std::strcmp(argv[i], "--server") == 0) {
+            attachConsole();
+            return runServer(argc, argv);
+        }
+#endif
+    }
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
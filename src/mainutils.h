@@ -11,6 +11,8 @@
 #include <QFont>
 #include <QFontDatabase>
 
+#include "stringutils.h"
+
 // Qt 5.6 compatibility: QOverload was introduced in Qt 5.7
 #if QT_VERSION < QT_VERSION_CHECK(5, 7, 0)
     template<typename... Args>
@@ -23,15 +25,6 @@
     };
 #endif
 
-inline std::string _toStdString(const QString& text) {
-    // #ifdef _WIN32
-    //     return std::string(text.toLocal8Bit().constData());
-    // #else
-    //     return std::string(text.toUtf8().constData());
-    // #endif
-    return std::string(text.toUtf8().constData());
-}
-
 inline QFont getMonospaceFont(int pointSize = 10) {
     QFont font;
 #ifdef Q_OS_WIN
@@ -18,12 +18,21 @@
 #include <QDebug>
 #include <QActionGroup>
 #include <QMenuBar>
+#include <QProgressDialog>
+#include <QEventLoop>
 
 #include "mainwindow.h"
 #include "convertdialog.h"
+#include "batchconvertdialog.h"
+#include "searchdialog.h"
+#include "duplicatesdialog.h"
+#include "integritydialog.h"
 #include "fileparamdialog.h"
 #include "formatdialog.h"
 #include "FileOperations.h"
+#include "ImageUtils.h"
+#include "JobRunner.h"
+#include "placeholders.h"
 
 #include "./ui_aboutdlg.h"
 #include "./ui_fileinfodialog.h"
@@ -191,6 +200,9 @@ void MainWindow::switch_language(const QString & lang, bool init)
     } else {
         QMessageBox::warning(this, MainWindow::tr("Error"), MainWindow::tr("Failed to load language file for: ") + lang);
     }
+
+    // Placeholder texts are translated once per language
+    resetPlaceholders();
 }
 
 void MainWindow::changeEvent(QEvent* event)
@@ -246,23 +258,11 @@ void MainWindow::closeEvent(QCloseEvent *event)
 
 void MainWindow::load_config()
 {
-    QFile file(":/files/config");
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::critical(0, MainWindow::tr("Error"), MainWindow::tr("Error reading config file"));
-        return;
-    }
-    QByteArray config_contents = file.readAll();
-    file.close();
-    QJsonParseError err;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(config_contents, &err);
-    if (jsonDoc.isNull()) {
-        QMessageBox::critical(0, qApp->translate("Main", "Error"), qApp->translate("Main", "Config parse error: %1").arg(err.errorString()));
+    QString error;
+    if (!ImageUtils::loadConfig(file_formats, file_types, file_systems, error)) {
+        QMessageBox::critical(0, MainWindow::tr("Error"), error);
         return;
     }
-    QJsonObject jsonRoot = jsonDoc.object();
-    file_formats = jsonRoot["file_formats"].toObject();
-    file_types = jsonRoot["file_types"].toObject();
-    file_systems = jsonRoot["file_systems"].toObject();
 
     // Fill FILE_SUPPORTED
 
@@ -448,6 +448,22 @@ void MainWindow::initializeMainMenu() {
     actImageSaveAs->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_F2));
     connect(actImageSaveAs, &QAction::triggered, this, &MainWindow::onImageSaveAs);
 
+    QAction *batchConvert = imageMenu->addAction(QIcon(":/icons/convert"), MainWindow::tr("Batch conversion..."));
+    connect(batchConvert, &QAction::triggered, this, &MainWindow::onBatchConvert);
+
+    QAction *runJob = imageMenu->addAction(MainWindow::tr("Run job..."));
+    connect(runJob, &QAction::triggered, this, &MainWindow::onRunJob);
+
+    QAction *searchImages = imageMenu->addAction(MainWindow::tr("Search in images..."));
+    searchImages->setShortcut(QKeySequence(Qt::ALT | Qt::Key_F7));
+    connect(searchImages, &QAction::triggered, this, &MainWindow::onSearchImages);
+
+    QAction *duplicates = imageMenu->addAction(MainWindow::tr("Duplicate files..."));
+    connect(duplicates, &QAction::triggered, this, &MainWindow::onDuplicates);
+
+    QAction *checkImages = imageMenu->addAction(MainWindow::tr("Check images..."));
+    connect(checkImages, &QAction::triggered, this, &MainWindow::onCheckImages);
+
     imageMenu->addSeparator();
 
     actImageInfo = imageMenu->addAction(QIcon(":/icons/info"), MainWindow::tr("Container Info..."));
@@ -457,6 +473,15 @@ void MainWindow::initializeMainMenu() {
     actFSInfo->setShortcut(QKeySequence(Qt::CTRL | Qt::ALT | Qt::Key_F3));
     connect(actFSInfo, &QAction::triggered, this, &MainWindow::onFSInfo);
 
+    actSectors = imageMenu->addAction(MainWindow::tr("Sectors..."));
+    connect(actSectors, &QAction::triggered, this, &MainWindow::onSectors);
+
+    actGallery = imageMenu->addAction(MainWindow::tr("Picture gallery..."));
+    connect(actGallery, &QAction::triggered, this, &MainWindow::onGallery);
+
+    actCompare = imageMenu->addAction(MainWindow::tr("Compare images..."));
+    connect(actCompare, &QAction::triggered, this, &MainWindow::onCompare);
+
     imageMenu->addSeparator();
 
     actImageOpen = imageMenu->addAction(QIcon(":/icons/open"), MainWindow::tr("Open"));
@@ -472,6 +497,9 @@ void MainWindow::initializeMainMenu() {
     menuFileInfoAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_F3));
     connect(menuFileInfoAction, &QAction::triggered, this, &MainWindow::onFileInfo);
 
+    menuFindCopiesAction = filesMenu->addAction(MainWindow::tr("Find Copies..."));
+    connect(menuFindCopiesAction, &QAction::triggered, this, &MainWindow::onFindCopies);
+
     menuEditAction = filesMenu->addAction(QIcon(":/icons/view"), MainWindow::tr("Edit Metadata"));
     connect(menuEditAction, &QAction::triggered, this, &MainWindow::onEdit);
 
@@ -757,6 +785,23 @@ void MainWindow::onFSInfo()
     FileOperations::viewFilesystemInfo(activePanel, this);
 }
 
+void MainWindow::onSectors()
+{
+    if (!activePanel) return;
+    FileOperations::viewSectors(activePanel, this);
+}
+
+void MainWindow::onGallery()
+{
+    if (!activePanel) return;
+    FileOperations::viewGallery(activePanel, this);
+}
+
+void MainWindow::onCompare()
+{
+    FileOperations::compareImages(leftPanel, rightPanel, this);
+}
+
 void MainWindow::onImageSave()
 {
     if (!activePanel) return;
@@ -769,6 +814,133 @@ void MainWindow::onImageSaveAs()
     FileOperations::saveImageAs(activePanel, this);
 }
 
+void MainWindow::onBatchConvert()
+{
+    if (!activePanel) return;
+    BatchConvertDialog dialog(this, settings.get(), &file_formats, &file_types, activePanel->currentDir());
+    dialog.exec();
+    activePanel->refresh();
+}
+
+void MainWindow::onSearchImages()
+{
+    if (!activePanel) return;
+    SearchDialog dialog(this, settings.get(), &file_formats, activePanel->currentDir());
+    if (dialog.exec() != QDialog::Accepted || dialog.selectedImage().isEmpty()) return;
+    openFoundFile(dialog.selectedImage(), dialog.selectedPath());
+}
+
+void MainWindow::onDuplicates()
+{
+    if (!activePanel) return;
+    DuplicatesDialog dialog(this, settings.get(), &file_formats, m_file_index, activePanel->currentDir());
+    if (dialog.exec() != QDialog::Accepted || dialog.selectedImage().isEmpty()) return;
+    openFoundFile(dialog.selectedImage(), dialog.selectedPath());
+}
+
+void MainWindow::onCheckImages()
+{
+    if (!activePanel) return;
+    IntegrityDialog dialog(this, settings.get(), &file_formats, activePanel->currentDir());
+    if (dialog.exec() != QDialog::Accepted || dialog.selectedImage().isEmpty()) return;
+    openFoundFile(dialog.selectedImage(), QString());
+}
+
+void MainWindow::onFindCopies()
+{
+    if (!activePanel || activePanel->getMode() != panelMode::Image) return;
+    const QModelIndex index = activePanel->getCurrentIndex();
+    if (!index.isValid()) return;
+    const FileHandle f = activePanel->fileHandle(index.row());
+    if (f->is_dir) return;
+
+    dsk_tools::BYTES data;
+    activePanel->getFileSystem()->get_file(*f, "", data);
+    if (data.empty()) {
+        QMessageBox::critical(this, MainWindow::tr("Error"), MainWindow::tr("File reading error!"));
+        return;
+    }
+
+    DuplicatesDialog dialog(this, settings.get(), &file_formats, m_file_index, activePanel->currentDir());
+    dialog.setTarget(QString::fromStdString(f->name), data);
+    if (dialog.exec() != QDialog::Accepted || dialog.selectedImage().isEmpty()) return;
+    openFoundFile(dialog.selectedImage(), dialog.selectedPath());
+}
+
+void MainWindow::openFoundFile(const QString & image_file, const QString & path)
+{
+    // The image is opened as if it were double-clicked in a panel showing host files
+    FilePanel * panel = activePanel;
+    if (panel->getMode() != panelMode::Host) panel = otherPanel();
+    if (!panel || panel->getMode() != panelMode::Host) return;
+
+    const QFileInfo image(image_file);
+    panel->setDirectory(image.absolutePath());
+    panel->highlight(image.fileName());
+    panel->storeTableState();
+    const auto res = panel->openImage(image.absoluteFilePath());
+    if (!res) {
+        QMessageBox::critical(this, MainWindow::tr("Error"), FileOperations::decodeError(res));
+        panel->restoreTableState();
+        return;
+    }
+    // Files in subdirectories are left to the user to open
+    if (!path.contains('/')) panel->highlight(path);
+}
+
+void MainWindow::onRunJob()
+{
+    if (!activePanel) return;
+
+    const QString job_file = QFileDialog::getOpenFileName(
+        this,
+        MainWindow::tr("Run job"),
+        settings->value("batch/job_dir", activePanel->currentDir()).toString(),
+        MainWindow::tr("Job files (*.json)")
+    );
+    if (job_file.isEmpty()) return;
+    settings->setValue("batch/job_dir", QFileInfo(job_file).absolutePath());
+
+    JobRunner runner(file_formats, file_types);
+    QString error;
+    if (!runner.load(job_file, error)) {
+        QMessageBox::critical(this, MainWindow::tr("Error"), error);
+        return;
+    }
+    if (runner.maxThreadsRequested() > 0) runner.setMaxThreads(runner.maxThreadsRequested());
+
+    QProgressDialog progress(MainWindow::tr("Running job..."), MainWindow::tr("Stop"), 0, runner.images().size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    connect(&runner, &BatchRunner::progress, &progress, &QProgressDialog::setValue);
+    connect(&progress, &QProgressDialog::canceled, &runner, &BatchRunner::cancel);
+
+    QEventLoop loop;
+    connect(&runner, &BatchRunner::finished, &loop, &QEventLoop::quit);
+    if (!runner.start(runner.images())) {
+        QMessageBox::critical(this, MainWindow::tr("Error"), runner.errorString());
+        return;
+    }
+    if (runner.isRunning()) loop.exec();
+    progress.reset();
+
+    QString report_file = runner.reportFileName();
+    if (report_file.isEmpty()) {
+        const QFileInfo fi(job_file);
+        report_file = fi.absolutePath() + "/" + fi.completeBaseName() + ".report.json";
+    }
+    const QJsonObject report = runner.report();
+    QString text = MainWindow::tr("Images processed: %1, failed: %2").arg(
+        report["images_ok"].toInt() + report["images_failed"].toInt()).arg(report["images_failed"].toInt());
+    if (runner.writeReport(report_file, error))
+        text += "\n" + MainWindow::tr("Report: %1").arg(QDir::toNativeSeparators(report_file));
+    else
+        text += "\n" + error;
+    QMessageBox::information(this, MainWindow::tr("Run job"), text);
+
+    activePanel->refresh();
+}
+
 void MainWindow::updateImageMenuState() const
 {
     if (!activePanel) return;
@@ -779,6 +951,9 @@ void MainWindow::updateImageMenuState() const
     if (actImageSaveAs) actImageSaveAs->setEnabled(!is_host);
     if (actSave) actSave->setEnabled(!is_host);
     if (actFSInfo) actFSInfo->setEnabled(!is_host);
+    if (actSectors) actSectors->setEnabled(!is_host);
+    if (actGallery) actGallery->setEnabled(!is_host);
+    if (actCompare) actCompare->setEnabled(leftPanel->getMode() == panelMode::Image && rightPanel->getMode() == panelMode::Image);
 
     const bool has_index = activePanel->getCurrentIndex().isValid();
 
@@ -828,6 +1003,7 @@ void MainWindow::updateFileMenuState() const
 
     if (menuViewAction) menuViewAction->setEnabled(!is_host);
     if (menuFileInfoAction) menuFileInfoAction->setEnabled(!is_host);
+    if (menuFindCopiesAction) menuFindCopiesAction->setEnabled(!is_host);
     if (menuEditAction) menuEditAction->setEnabled(!is_host && has_metadata);
 
     if (is_host) {
@@ -13,6 +13,7 @@
 #include <QTranslator>
 
 #include "FilePanel.h"
+#include "FileIndex.h"
 
 #include "dsk_tools/dsk_tools.h"
 
@@ -75,6 +76,8 @@ private:
     dsk_tools::diskImage * image = nullptr;
     dsk_tools::fileSystem * filesystem = nullptr;
 
+    std::shared_ptr<const FileIndex> m_file_index;     // The last one built, kept for finding copies
+
     bool is_loaded = false;
 
     void load_config();
@@ -101,6 +104,7 @@ private:
 
     QAction* menuViewAction {nullptr};
     QAction* menuFileInfoAction {nullptr};
+    QAction* menuFindCopiesAction {nullptr};
     QAction* menuEditAction {nullptr};
     QAction* menuCopyAction {nullptr};
     QAction* menuRenameAction {nullptr};
@@ -112,6 +116,9 @@ private:
     QAction* actImageInfo {nullptr};
     QAction* actImageOpen {nullptr};
     QAction* actFSInfo {nullptr};
+    QAction* actSectors {nullptr};
+    QAction* actGallery {nullptr};
+    QAction* actCompare {nullptr};
     QAction* actImageSave {nullptr};
     QAction* actImageSaveAs {nullptr};
 
@@ -133,8 +140,18 @@ private:
     // Image menu slots
     void onImageInfo();
     void onFSInfo();
+    void onSectors();
+    void onGallery();
+    void onCompare();
     void onImageSave();
     void onImageSaveAs();
+    void onBatchConvert();
+    void onRunJob();
+    void onSearchImages();
+    void onDuplicates();
+    void onCheckImages();
+    void onFindCopies();
+    void openFoundFile(const QString & image_file, const QString & path);
     void updateImageMenuState() const;
     void updateFileMenuState() const;
 
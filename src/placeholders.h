@@ -6,164 +6,207 @@
 #pragma once
 
 #include <QString>
+#include <QHash>
 #include <QCoreApplication>
 
-inline QString replacePlaceholders(const QString& input)
+// Translated texts by placeholder, e.g. "{$FILE_NAME}" -> "File Name"
+inline QHash<QString, QString> buildPlaceholderTable()
 {
-    return QString(input)
-        // 102 disk/filesystem placeholders (FilePanel context)
-        .replace("{$DIRECTORY_ENTRY}", QCoreApplication::translate("FilePanel", "Directory Entry"))
-        .replace("{$FILE_NAME}", QCoreApplication::translate("FilePanel", "File Name"))
-        .replace("{$SIZE}", QCoreApplication::translate("FilePanel", "File Size"))
-        .replace("{$BYTES}", QCoreApplication::translate("FilePanel", "byte(s)"))
-        .replace("{$SIDES}", QCoreApplication::translate("FilePanel", "Sides"))
-        .replace("{$TRACKS}", QCoreApplication::translate("FilePanel", "Tracks"))
-        .replace("{$SECTORS}", QCoreApplication::translate("FilePanel", "sector(s)"))
-        .replace("{$ATTRIBUTES}", QCoreApplication::translate("FilePanel", "Attributes"))
-        .replace("{$DATE}", QCoreApplication::translate("FilePanel", "Date"))
-        .replace("{$TYPE}", QCoreApplication::translate("FilePanel", "Type"))
-        .replace("{$PROTECTED}", QCoreApplication::translate("FilePanel", "Protected"))
-        .replace("{$YES}", QCoreApplication::translate("FilePanel", "Yes"))
-        .replace("{$NO}", QCoreApplication::translate("FilePanel", "No"))
-        .replace("{$TS_LIST_LOCATION}", QCoreApplication::translate("FilePanel", "T/S List Location"))
-        .replace("{$TS_LIST_DATA}", QCoreApplication::translate("FilePanel", "T/S List Contents"))
-        .replace("{$INCORRECT_TS_DATA}", QCoreApplication::translate("FilePanel", "Incorrect T/S data, stopping iterations"))
-        .replace("{$NEXT_TS}", QCoreApplication::translate("FilePanel", "Next T/S List Location"))
-        .replace("{$FILE_END_REACHED}", QCoreApplication::translate("FilePanel", "File End Reached"))
-        .replace("{$FILE_DELETED}", QCoreApplication::translate("FilePanel", "The file is marked as deleted, the data below may be incorrect"))
-        .replace("{$ERROR_PARSING}", QCoreApplication::translate("FilePanel", "File parsing error"))
-        .replace("{$TRACK}", QCoreApplication::translate("FilePanel", "Track"))
-        .replace("{$TRACK_SHORT}", QCoreApplication::translate("FilePanel", "T"))
-        .replace("{$SIDE_SHORT}", QCoreApplication::translate("FilePanel", "H"))
-        .replace("{$PHYSICAL_SECTOR}", QCoreApplication::translate("FilePanel", "S"))
-        .replace("{$LOGICAL_SECTOR}", QCoreApplication::translate("FilePanel", "S"))
-        .replace("{$PARSING_FINISHED}", QCoreApplication::translate("FilePanel", "Parsing finished"))
-        .replace("{$VOLUME_ID}", QCoreApplication::translate("FilePanel", "V"))
-        .replace("{$SECTOR_INDEX}", QCoreApplication::translate("FilePanel", "Index"))
-        .replace("{$INDEX_MARK}", QCoreApplication::translate("FilePanel", "Index Mark"))
-        .replace("{$DATA_MARK}", QCoreApplication::translate("FilePanel", "Data Mark"))
-        .replace("{$DATA_FIELD}", QCoreApplication::translate("FilePanel", "Sector Data"))
-        .replace("{$SECTOR_INDEX_END_OK}", QCoreApplication::translate("FilePanel", "End Mark: OK"))
-        .replace("{$SECTOR_INDEX_END_ERROR}", QCoreApplication::translate("FilePanel", "End Mark: Not Detected"))
-        .replace("{$SECTOR_CRC_OK}", QCoreApplication::translate("FilePanel", "CRC: OK"))
-        .replace("{$SECTOR_CRC_ERROR}", QCoreApplication::translate("FilePanel", "CRC: Error"))
-        .replace("{$CRC_EXPECTED}", QCoreApplication::translate("FilePanel", "Expected"))
-        .replace("{$CRC_FOUND}", QCoreApplication::translate("FilePanel", "Found"))
-        .replace("{$SECTOR_ERROR}", QCoreApplication::translate("FilePanel", "Data Error"))
-        .replace("{$INDEX_CRC_OK}", QCoreApplication::translate("FilePanel", "CRC: OK"))
-        .replace("{$INDEX_CRC_ERROR}", QCoreApplication::translate("FilePanel", "CRC: Error"))
-        .replace("{$INDEX_EPILOGUE_OK}", QCoreApplication::translate("FilePanel", "Epilogue: OK"))
-        .replace("{$INDEX_EPILOGUE_ERROR}", QCoreApplication::translate("FilePanel", "Epilogue: Error"))
-        .replace("{$DATA_EPILOGUE_OK}", QCoreApplication::translate("FilePanel", "Epilogue: OK"))
-        .replace("{$DATA_EPILOGUE_ERROR}", QCoreApplication::translate("FilePanel", "Epilogue: Error"))
-        .replace("{$TRACKLIST_OFFSET}", QCoreApplication::translate("FilePanel", "Track List Offset"))
-        .replace("{$TRACK_OFFSET}", QCoreApplication::translate("FilePanel", "Track Offset"))
-        .replace("{$TRACK_SIZE}", QCoreApplication::translate("FilePanel", "Track Size"))
-        .replace("{$HEADER}", QCoreApplication::translate("FilePanel", "Header"))
-        .replace("{$SIGNATURE}", QCoreApplication::translate("FilePanel", "Signature"))
-        .replace("{$NO_SIGNATURE}", QCoreApplication::translate("FilePanel", "No known signature found, aborting"))
-        .replace("{$FORMAT_REVISION}", QCoreApplication::translate("FilePanel", "Format revision"))
-        .replace("{$SIDE}", QCoreApplication::translate("FilePanel", "Side"))
-        .replace("{$CUSTOM_DATA}", QCoreApplication::translate("FilePanel", "Custom Data"))
-        .replace("{$VTOC_FOUND}", QCoreApplication::translate("FilePanel", "DOS 3.3 VTOC found"))
-        .replace("{$VTOC_NOT_FOUND}", QCoreApplication::translate("FilePanel", "DOS 3.3 VTOC not found"))
-        .replace("{$VTOC_CATALOG_TRACK}", QCoreApplication::translate("FilePanel", "Root Catalog Track"))
-        .replace("{$VTOC_CATALOG_SECTOR}", QCoreApplication::translate("FilePanel", "Root Catalog Sector"))
-        .replace("{$VTOC_DOS_RELEASE}", QCoreApplication::translate("FilePanel", "DOS Release"))
-        .replace("{$VTOC_VOLUME_ID}", QCoreApplication::translate("FilePanel", "Volume ID"))
-        .replace("{$VTOC_VOLUME_NAME}", QCoreApplication::translate("FilePanel", "Volume name"))
-        .replace("{$VTOC_PAIRS_ON_SECTOR}", QCoreApplication::translate("FilePanel", "Pairs per T/S list"))
-        .replace("{$VTOC_LAST_TRACK}", QCoreApplication::translate("FilePanel", "Last track"))
-        .replace("{$VTOC_DIRECTION}", QCoreApplication::translate("FilePanel", "Direction"))
-        .replace("{$VTOC_TRACKS_TOTAL}", QCoreApplication::translate("FilePanel", "Tracks total"))
-        .replace("{$VTOC_SECTORS_ON_TRACK}", QCoreApplication::translate("FilePanel", "Sectors on track"))
-        .replace("{$VTOC_BYTES_PER_SECTOR}", QCoreApplication::translate("FilePanel", "Bytes per sector"))
-        .replace("{$ERROR_OPENING}", QCoreApplication::translate("FilePanel", "Error opening the file"))
-        .replace("{$ERROR_LOADING}", QCoreApplication::translate("FilePanel", "Error loading, check if the file type is correct"))
-        .replace("{$DPB_INFO}", QCoreApplication::translate("FilePanel", "DPB Information"))
-        .replace("{$DPB_VOLUME_ID}", QCoreApplication::translate("FilePanel", "Volume ID"))
-        .replace("{$DPB_TYPE}", QCoreApplication::translate("FilePanel", "Device type"))
-        .replace("{$DPB_DSIDE}", QCoreApplication::translate("FilePanel", "DSIDE"))
-        .replace("{$DPB_TSIZE}", QCoreApplication::translate("FilePanel", "Blocks on track"))
-        .replace("{$DPB_DSIZE}", QCoreApplication::translate("FilePanel", "Tracks on disk"))
-        .replace("{$DPB_MAXBLOK}", QCoreApplication::translate("FilePanel", "Last block"))
-        .replace("{$DPB_VTOCADR}", QCoreApplication::translate("FilePanel", "VTOC block"))
-        .replace("{$EXTENT}", QCoreApplication::translate("FilePanel", "Extent"))
-        .replace("{$FREE_SECTORS}", QCoreApplication::translate("FilePanel", "Free sectors"))
-        .replace("{$FREE_BYTES}", QCoreApplication::translate("FilePanel", "Free bytes"))
-        .replace("{$META_FILENAME}", QCoreApplication::translate("FilePanel", "File Name"))
-        .replace("{$META_PROTECTED}", QCoreApplication::translate("FilePanel", "Protected"))
-        .replace("{$META_TYPE}", QCoreApplication::translate("FilePanel", "Type"))
-        .replace("{$META_EXTENDED}", QCoreApplication::translate("FilePanel", "Extended"))
-        .replace("{$AGAT_VR_FOUND}", QCoreApplication::translate("FilePanel", "Agat image VR block found"))
-        .replace("{$AGAT_VR_MODE}", QCoreApplication::translate("FilePanel", "Video mode"))
-        .replace("{$AGAT_VR_AGAT_GMODES}", QCoreApplication::translate("FilePanel", "Agat graphic"))
-        .replace("{$AGAT_VR_AGAT_TMODES}", QCoreApplication::translate("FilePanel", "Agat text"))
-        .replace("{$AGAT_VR_A2_MODES}", QCoreApplication::translate("FilePanel", "Apple II modes"))
-        .replace("{$AGAT_VR_GIGA_MODES}", QCoreApplication::translate("FilePanel", "Agat GigaScreen"))
-        .replace("{$AGAT_VR_MAIN_PALETTE}", QCoreApplication::translate("FilePanel", "Main palette"))
-        .replace("{$AGAT_VR_ATL_PALETTE}", QCoreApplication::translate("FilePanel", "Alternative palette"))
-        .replace("{$AGAT_VR_CUSTOM_PALETTE}", QCoreApplication::translate("FilePanel", "Custom palette"))
-        .replace("{$AGAT_VR_COMMENT}", QCoreApplication::translate("FilePanel", "Comment block"))
-        .replace("{$AGAT_VR_FONT}", QCoreApplication::translate("FilePanel", "Font ID"))
-        .replace("{$AGAT_VR_CUSTOM_FONT}", QCoreApplication::translate("FilePanel", "Custom font"))
-        .replace("{$COMMENT}", QCoreApplication::translate("FilePanel", "Comment"))
-        .replace("{$SECTORS_MAP}", QCoreApplication::translate("FilePanel", "Sector map"))
-        .replace("{$CYLINDERS_MAP}", QCoreApplication::translate("FilePanel", "Cylinder map"))
-        .replace("{$HEAD_MAP}", QCoreApplication::translate("FilePanel", "Head map"))
-        .replace("{$UNEXPECTED_END_OF_FILE}", QCoreApplication::translate("FilePanel", "Error: Unexpected end of file"))
-        .replace("{$SECTOR_UNAVAILABLE}", QCoreApplication::translate("FilePanel", "Unavailable sector"))
-        .replace("{$NORMAL_DATA}", QCoreApplication::translate("FilePanel", "Normal data"))
-        .replace("{$DATA_COMPRESSED}", QCoreApplication::translate("FilePanel", "Compressed"))
-        .replace("{$DATA_DELETED}", QCoreApplication::translate("FilePanel", "Deleted"))
-        .replace("{$NORMAL_DATA_WITH_ERROR}", QCoreApplication::translate("FilePanel", "DATA ERROR"))
-        .replace("{$UNKNOWN_DATA_MARKER}", QCoreApplication::translate("FilePanel", "Unknown data marker"))
-        .replace("{$FILE_HAS_ERRORS}", QCoreApplication::translate("FilePanel", "The file contains corrupted data!"))
-        .replace("{$FILE_HAS_NO_ERRORS}", QCoreApplication::translate("FilePanel", "The file was read without errors."))
+    QHash<QString, QString> table;
+    // 102 disk/filesystem placeholders (FilePanel context)
+    table.insert(QStringLiteral("{$DIRECTORY_ENTRY}"), QCoreApplication::translate("FilePanel", "Directory Entry"));
+    table.insert(QStringLiteral("{$FILE_NAME}"), QCoreApplication::translate("FilePanel", "File Name"));
+    table.insert(QStringLiteral("{$SIZE}"), QCoreApplication::translate("FilePanel", "File Size"));
+    table.insert(QStringLiteral("{$BYTES}"), QCoreApplication::translate("FilePanel", "byte(s)"));
+    table.insert(QStringLiteral("{$SIDES}"), QCoreApplication::translate("FilePanel", "Sides"));
+    table.insert(QStringLiteral("{$TRACKS}"), QCoreApplication::translate("FilePanel", "Tracks"));
+    table.insert(QStringLiteral("{$SECTORS}"), QCoreApplication::translate("FilePanel", "sector(s)"));
+    table.insert(QStringLiteral("{$ATTRIBUTES}"), QCoreApplication::translate("FilePanel", "Attributes"));
+    table.insert(QStringLiteral("{$DATE}"), QCoreApplication::translate("FilePanel", "Date"));
+    table.insert(QStringLiteral("{$TYPE}"), QCoreApplication::translate("FilePanel", "Type"));
+    table.insert(QStringLiteral("{$PROTECTED}"), QCoreApplication::translate("FilePanel", "Protected"));
+    table.insert(QStringLiteral("{$YES}"), QCoreApplication::translate("FilePanel", "Yes"));
+    table.insert(QStringLiteral("{$NO}"), QCoreApplication::translate("FilePanel", "No"));
+    table.insert(QStringLiteral("{$TS_LIST_LOCATION}"), QCoreApplication::translate("FilePanel", "T/S List Location"));
+    table.insert(QStringLiteral("{$TS_LIST_DATA}"), QCoreApplication::translate("FilePanel", "T/S List Contents"));
+    table.insert(QStringLiteral("{$INCORRECT_TS_DATA}"), QCoreApplication::translate("FilePanel", "Incorrect T/S data, stopping iterations"));
+    table.insert(QStringLiteral("{$NEXT_TS}"), QCoreApplication::translate("FilePanel", "Next T/S List Location"));
+    table.insert(QStringLiteral("{$FILE_END_REACHED}"), QCoreApplication::translate("FilePanel", "File End Reached"));
+    table.insert(QStringLiteral("{$FILE_DELETED}"), QCoreApplication::translate("FilePanel", "The file is marked as deleted, the data below may be incorrect"));
+    table.insert(QStringLiteral("{$ERROR_PARSING}"), QCoreApplication::translate("FilePanel", "File parsing error"));
+    table.insert(QStringLiteral("{$TRACK}"), QCoreApplication::translate("FilePanel", "Track"));
+    table.insert(QStringLiteral("{$TRACK_SHORT}"), QCoreApplication::translate("FilePanel", "T"));
+    table.insert(QStringLiteral("{$SIDE_SHORT}"), QCoreApplication::translate("FilePanel", "H"));
+    table.insert(QStringLiteral("{$PHYSICAL_SECTOR}"), QCoreApplication::translate("FilePanel", "S"));
+    table.insert(QStringLiteral("{$LOGICAL_SECTOR}"), QCoreApplication::translate("FilePanel", "S"));
+    table.insert(QStringLiteral("{$PARSING_FINISHED}"), QCoreApplication::translate("FilePanel", "Parsing finished"));
+    table.insert(QStringLiteral("{$VOLUME_ID}"), QCoreApplication::translate("FilePanel", "V"));
+    table.insert(QStringLiteral("{$SECTOR_INDEX}"), QCoreApplication::translate("FilePanel", "Index"));
+    table.insert(QStringLiteral("{$INDEX_MARK}"), QCoreApplication::translate("FilePanel", "Index Mark"));
+    table.insert(QStringLiteral("{$DATA_MARK}"), QCoreApplication::translate("FilePanel", "Data Mark"));
+    table.insert(QStringLiteral("{$DATA_FIELD}"), QCoreApplication::translate("FilePanel", "Sector Data"));
+    table.insert(QStringLiteral("{$SECTOR_INDEX_END_OK}"), QCoreApplication::translate("FilePanel", "End Mark: OK"));
+    table.insert(QStringLiteral("{$SECTOR_INDEX_END_ERROR}"), QCoreApplication::translate("FilePanel", "End Mark: Not Detected"));
+    table.insert(QStringLiteral("{$SECTOR_CRC_OK}"), QCoreApplication::translate("FilePanel", "CRC: OK"));
+    table.insert(QStringLiteral("{$SECTOR_CRC_ERROR}"), QCoreApplication::translate("FilePanel", "CRC: Error"));
+    table.insert(QStringLiteral("{$CRC_EXPECTED}"), QCoreApplication::translate("FilePanel", "Expected"));
+    table.insert(QStringLiteral("{$CRC_FOUND}"), QCoreApplication::translate("FilePanel", "Found"));
+    table.insert(QStringLiteral("{$SECTOR_ERROR}"), QCoreApplication::translate("FilePanel", "Data Error"));
+    table.insert(QStringLiteral("{$INDEX_CRC_OK}"), QCoreApplication::translate("FilePanel", "CRC: OK"));
+    table.insert(QStringLiteral("{$INDEX_CRC_ERROR}"), QCoreApplication::translate("FilePanel", "CRC: Error"));
+    table.insert(QStringLiteral("{$INDEX_EPILOGUE_OK}"), QCoreApplication::translate("FilePanel", "Epilogue: OK"));
+    table.insert(QStringLiteral("{$INDEX_EPILOGUE_ERROR}"), QCoreApplication::translate("FilePanel", "Epilogue: Error"));
+    table.insert(QStringLiteral("{$DATA_EPILOGUE_OK}"), QCoreApplication::translate("FilePanel", "Epilogue: OK"));
+    table.insert(QStringLiteral("{$DATA_EPILOGUE_ERROR}"), QCoreApplication::translate("FilePanel", "Epilogue: Error"));
+    table.insert(QStringLiteral("{$TRACKLIST_OFFSET}"), QCoreApplication::translate("FilePanel", "Track List Offset"));
+    table.insert(QStringLiteral("{$TRACK_OFFSET}"), QCoreApplication::translate("FilePanel", "Track Offset"));
+    table.insert(QStringLiteral("{$TRACK_SIZE}"), QCoreApplication::translate("FilePanel", "Track Size"));
+    table.insert(QStringLiteral("{$HEADER}"), QCoreApplication::translate("FilePanel", "Header"));
+    table.insert(QStringLiteral("{$SIGNATURE}"), QCoreApplication::translate("FilePanel", "Signature"));
+    table.insert(QStringLiteral("{$NO_SIGNATURE}"), QCoreApplication::translate("FilePanel", "No known signature found, aborting"));
+    table.insert(QStringLiteral("{$FORMAT_REVISION}"), QCoreApplication::translate("FilePanel", "Format revision"));
+    table.insert(QStringLiteral("{$SIDE}"), QCoreApplication::translate("FilePanel", "Side"));
+    table.insert(QStringLiteral("{$CUSTOM_DATA}"), QCoreApplication::translate("FilePanel", "Custom Data"));
+    table.insert(QStringLiteral("{$VTOC_FOUND}"), QCoreApplication::translate("FilePanel", "DOS 3.3 VTOC found"));
+    table.insert(QStringLiteral("{$VTOC_NOT_FOUND}"), QCoreApplication::translate("FilePanel", "DOS 3.3 VTOC not found"));
+    table.insert(QStringLiteral("{$VTOC_CATALOG_TRACK}"), QCoreApplication::translate("FilePanel", "Root Catalog Track"));
+    table.insert(QStringLiteral("{$VTOC_CATALOG_SECTOR}"), QCoreApplication::translate("FilePanel", "Root Catalog Sector"));
+    table.insert(QStringLiteral("{$VTOC_DOS_RELEASE}"), QCoreApplication::translate("FilePanel", "DOS Release"));
+    table.insert(QStringLiteral("{$VTOC_VOLUME_ID}"), QCoreApplication::translate("FilePanel", "Volume ID"));
+    table.insert(QStringLiteral("{$VTOC_VOLUME_NAME}"), QCoreApplication::translate("FilePanel", "Volume name"));
+    table.insert(QStringLiteral("{$VTOC_PAIRS_ON_SECTOR}"), QCoreApplication::translate("FilePanel", "Pairs per T/S list"));
+    table.insert(QStringLiteral("{$VTOC_LAST_TRACK}"), QCoreApplication::translate("FilePanel", "Last track"));
+    table.insert(QStringLiteral("{$VTOC_DIRECTION}"), QCoreApplication::translate("FilePanel", "Direction"));
+    table.insert(QStringLiteral("{$VTOC_TRACKS_TOTAL}"), QCoreApplication::translate("FilePanel", "Tracks total"));
+    table.insert(QStringLiteral("{$VTOC_SECTORS_ON_TRACK}"), QCoreApplication::translate("FilePanel", "Sectors on track"));
+    table.insert(QStringLiteral("{$VTOC_BYTES_PER_SECTOR}"), QCoreApplication::translate("FilePanel", "Bytes per sector"));
+    table.insert(QStringLiteral("{$ERROR_OPENING}"), QCoreApplication::translate("FilePanel", "Error opening the file"));
+    table.insert(QStringLiteral("{$ERROR_LOADING}"), QCoreApplication::translate("FilePanel", "Error loading, check if the file type is correct"));
+    table.insert(QStringLiteral("{$DPB_INFO}"), QCoreApplication::translate("FilePanel", "DPB Information"));
+    table.insert(QStringLiteral("{$DPB_VOLUME_ID}"), QCoreApplication::translate("FilePanel", "Volume ID"));
+    table.insert(QStringLiteral("{$DPB_TYPE}"), QCoreApplication::translate("FilePanel", "Device type"));
+    table.insert(QStringLiteral("{$DPB_DSIDE}"), QCoreApplication::translate("FilePanel", "DSIDE"));
+    table.insert(QStringLiteral("{$DPB_TSIZE}"), QCoreApplication::translate("FilePanel", "Blocks on track"));
+    table.insert(QStringLiteral("{$DPB_DSIZE}"), QCoreApplication::translate("FilePanel", "Tracks on disk"));
+    table.insert(QStringLiteral("{$DPB_MAXBLOK}"), QCoreApplication::translate("FilePanel", "Last block"));
+    table.insert(QStringLiteral("{$DPB_VTOCADR}"), QCoreApplication::translate("FilePanel", "VTOC block"));
+    table.insert(QStringLiteral("{$EXTENT}"), QCoreApplication::translate("FilePanel", "Extent"));
+    table.insert(QStringLiteral("{$FREE_SECTORS}"), QCoreApplication::translate("FilePanel", "Free sectors"));
+    table.insert(QStringLiteral("{$FREE_BYTES}"), QCoreApplication::translate("FilePanel", "Free bytes"));
+    table.insert(QStringLiteral("{$META_FILENAME}"), QCoreApplication::translate("FilePanel", "File Name"));
+    table.insert(QStringLiteral("{$META_PROTECTED}"), QCoreApplication::translate("FilePanel", "Protected"));
+    table.insert(QStringLiteral("{$META_TYPE}"), QCoreApplication::translate("FilePanel", "Type"));
+    table.insert(QStringLiteral("{$META_EXTENDED}"), QCoreApplication::translate("FilePanel", "Extended"));
+    table.insert(QStringLiteral("{$AGAT_VR_FOUND}"), QCoreApplication::translate("FilePanel", "Agat image VR block found"));
+    table.insert(QStringLiteral("{$AGAT_VR_MODE}"), QCoreApplication::translate("FilePanel", "Video mode"));
+    table.insert(QStringLiteral("{$AGAT_VR_AGAT_GMODES}"), QCoreApplication::translate("FilePanel", "Agat graphic"));
+    table.insert(QStringLiteral("{$AGAT_VR_AGAT_TMODES}"), QCoreApplication::translate("FilePanel", "Agat text"));
+    table.insert(QStringLiteral("{$AGAT_VR_A2_MODES}"), QCoreApplication::translate("FilePanel", "Apple II modes"));
+    table.insert(QStringLiteral("{$AGAT_VR_GIGA_MODES}"), QCoreApplication::translate("FilePanel", "Agat GigaScreen"));
+    table.insert(QStringLiteral("{$AGAT_VR_MAIN_PALETTE}"), QCoreApplication::translate("FilePanel", "Main palette"));
+    table.insert(QStringLiteral("{$AGAT_VR_ATL_PALETTE}"), QCoreApplication::translate("FilePanel", "Alternative palette"));
+    table.insert(QStringLiteral("{$AGAT_VR_CUSTOM_PALETTE}"), QCoreApplication::translate("FilePanel", "Custom palette"));
+    table.insert(QStringLiteral("{$AGAT_VR_COMMENT}"), QCoreApplication::translate("FilePanel", "Comment block"));
+    table.insert(QStringLiteral("{$AGAT_VR_FONT}"), QCoreApplication::translate("FilePanel", "Font ID"));
+    table.insert(QStringLiteral("{$AGAT_VR_CUSTOM_FONT}"), QCoreApplication::translate("FilePanel", "Custom font"));
+    table.insert(QStringLiteral("{$COMMENT}"), QCoreApplication::translate("FilePanel", "Comment"));
+    table.insert(QStringLiteral("{$SECTORS_MAP}"), QCoreApplication::translate("FilePanel", "Sector map"));
+    table.insert(QStringLiteral("{$CYLINDERS_MAP}"), QCoreApplication::translate("FilePanel", "Cylinder map"));
+    table.insert(QStringLiteral("{$HEAD_MAP}"), QCoreApplication::translate("FilePanel", "Head map"));
+    table.insert(QStringLiteral("{$UNEXPECTED_END_OF_FILE}"), QCoreApplication::translate("FilePanel", "Error: Unexpected end of file"));
+    table.insert(QStringLiteral("{$SECTOR_UNAVAILABLE}"), QCoreApplication::translate("FilePanel", "Unavailable sector"));
+    table.insert(QStringLiteral("{$NORMAL_DATA}"), QCoreApplication::translate("FilePanel", "Normal data"));
+    table.insert(QStringLiteral("{$DATA_COMPRESSED}"), QCoreApplication::translate("FilePanel", "Compressed"));
+    table.insert(QStringLiteral("{$DATA_DELETED}"), QCoreApplication::translate("FilePanel", "Deleted"));
+    table.insert(QStringLiteral("{$NORMAL_DATA_WITH_ERROR}"), QCoreApplication::translate("FilePanel", "DATA ERROR"));
+    table.insert(QStringLiteral("{$UNKNOWN_DATA_MARKER}"), QCoreApplication::translate("FilePanel", "Unknown data marker"));
+    table.insert(QStringLiteral("{$FILE_HAS_ERRORS}"), QCoreApplication::translate("FilePanel", "The file contains corrupted data!"));
+    table.insert(QStringLiteral("{$FILE_HAS_NO_ERRORS}"), QCoreApplication::translate("FilePanel", "The file was read without errors."));
+
+    // CP/M related strings
+    table.insert(QStringLiteral("{$CPM_SECTOR_SIZE}"), QCoreApplication::translate("FilePanel", "Sector size"));
+    table.insert(QStringLiteral("{$CPM_BLOCK_SIZE}"), QCoreApplication::translate("FilePanel", "Block size"));
+    table.insert(QStringLiteral("{$CPM_SECTORS_PER_BLOCK}"), QCoreApplication::translate("FilePanel", "Sectors per block"));
+    table.insert(QStringLiteral("{$CPM_RESERVED_TRACKS}"), QCoreApplication::translate("FilePanel", "Reserved tracks"));
+    table.insert(QStringLiteral("{$CPM_BLOCK}"), QCoreApplication::translate("FilePanel", "Block"));
+    table.insert(QStringLiteral("{$CPM_SECTORS}"), QCoreApplication::translate("FilePanel", "Sectors"));
+    table.insert(QStringLiteral("{$CPM_SECTORS_PER_TRACK}"), QCoreApplication::translate("FilePanel", "Sectors per track"));
+    table.insert(QStringLiteral("{$CPM_TOTAL_BLOCKS}"), QCoreApplication::translate("FilePanel", "Total blocks"));
+    table.insert(QStringLiteral("{$CPM_DIR_ENTRIES}"), QCoreApplication::translate("FilePanel", "Directory entries"));
+    table.insert(QStringLiteral("{$DISK_HAS_BAD_SECTORS}"), QCoreApplication::translate("FilePanel", "The disk contains bad sectors!"));
+    table.insert(QStringLiteral("{$BAD_SECTOR_IN_RESERVED}"), QCoreApplication::translate("FilePanel", "Bad sector in reserved track"));
+    table.insert(QStringLiteral("{$NO_BAD_SECTORS_IN_RESERVED}"), QCoreApplication::translate("FilePanel", "No bad sectors in reserved tracks"));
+    table.insert(QStringLiteral("{$BAD_SECTOR_IN_DIRECTORY}"), QCoreApplication::translate("FilePanel", "Bad sector in directory"));
+    table.insert(QStringLiteral("{$NO_BAD_SECTORS_IN_DIRECTORY}"), QCoreApplication::translate("FilePanel", "No bad sectors in directory"));
+    table.insert(QStringLiteral("{$FILE_HAS_BAD_SECTORS}"), QCoreApplication::translate("FilePanel", "File has bad sectors"));
+    table.insert(QStringLiteral("{$NO_FILES_WITH_BAD_SECTORS}"), QCoreApplication::translate("FilePanel", "No files with bad sectors"));
+
+    // 15 viewer placeholders (ViewDialog context)
+    table.insert(QStringLiteral("{$PALETTE}"), QCoreApplication::translate("ViewDialog", "Palette"));
+    table.insert(QStringLiteral("{$COLOR}"), QCoreApplication::translate("ViewDialog", "Color"));
+    table.insert(QStringLiteral("{$MONOCHROME}"), QCoreApplication::translate("ViewDialog", "Monochrome"));
+    table.insert(QStringLiteral("{$CUSTOM_PALETTE}"), QCoreApplication::translate("ViewDialog", "Custom palette"));
+    table.insert(QStringLiteral("{$BW}"), QCoreApplication::translate("ViewDialog", "b/w"));
+    table.insert(QStringLiteral("{$FONT_LOADING_ERROR}"), QCoreApplication::translate("ViewDialog", "Custom font loading error"));
+    table.insert(QStringLiteral("{$NTSC_AGAT_IMPROVED}"), QCoreApplication::translate("ViewDialog", "Agat Improved"));
+    table.insert(QStringLiteral("{$NTSC_APPLE_IMPROVED}"), QCoreApplication::translate("ViewDialog", "Apple Improved"));
+    table.insert(QStringLiteral("{$NTSC_APPLE_ORIGINAL}"), QCoreApplication::translate("ViewDialog", "Apple NTSC Original"));
+    table.insert(QStringLiteral("{$AGAT_FONT_A7_CLASSIC}"), QCoreApplication::translate("ViewDialog", "Agat-7 classic font"));
+    table.insert(QStringLiteral("{$AGAT_FONT_A7_ENCHANCED}"), QCoreApplication::translate("ViewDialog", "Agat-7 enhanced font"));
+    table.insert(QStringLiteral("{$AGAT_FONT_A9_CLASSIC}"), QCoreApplication::translate("ViewDialog", "Agat-9 classic font"));
+    table.insert(QStringLiteral("{$AGAT_FONT_CUSTOM_GARNIZON}"), QCoreApplication::translate("ViewDialog", "GARNIZON custom font"));
+    table.insert(QStringLiteral("{$AGAT_FONT_CUSTOM_LOADED}"), QCoreApplication::translate("ViewDialog", "Loaded custom font"));
+    table.insert(QStringLiteral("{$FONT_A9}"), QCoreApplication::translate("ViewDialog", "Agat-9 Font"));
+    table.insert(QStringLiteral("{$FONT_A7}"), QCoreApplication::translate("ViewDialog", "Agat-7 Font"));
+    table.insert(QStringLiteral("{$FONT_FILE}"), QCoreApplication::translate("ViewDialog", "Font file"));
+    table.insert(QStringLiteral("{$FONT_FILE_BFT}"), QCoreApplication::translate("ViewDialog", "BFT Font"));
 
-        // CP/M related strings
-        .replace("{$CPM_SECTOR_SIZE}", QCoreApplication::translate("FilePanel", "Sector size"))
-        .replace("{$CPM_BLOCK_SIZE}", QCoreApplication::translate("FilePanel", "Block size"))
-        .replace("{$CPM_SECTORS_PER_BLOCK}", QCoreApplication::translate("FilePanel", "Sectors per block"))
-        .replace("{$CPM_RESERVED_TRACKS}", QCoreApplication::translate("FilePanel", "Reserved tracks"))
-        .replace("{$CPM_BLOCK}", QCoreApplication::translate("FilePanel", "Block"))
-        .replace("{$CPM_SECTORS}", QCoreApplication::translate("FilePanel", "Sectors"))
-        .replace("{$CPM_SECTORS_PER_TRACK}", QCoreApplication::translate("FilePanel", "Sectors per track"))
-        .replace("{$CPM_TOTAL_BLOCKS}", QCoreApplication::translate("FilePanel", "Total blocks"))
-        .replace("{$CPM_DIR_ENTRIES}", QCoreApplication::translate("FilePanel", "Directory entries"))
-        .replace("{$DISK_HAS_BAD_SECTORS}", QCoreApplication::translate("FilePanel", "The disk contains bad sectors!"))
-        .replace("{$BAD_SECTOR_IN_RESERVED}", QCoreApplication::translate("FilePanel", "Bad sector in reserved track"))
-        .replace("{$NO_BAD_SECTORS_IN_RESERVED}", QCoreApplication::translate("FilePanel", "No bad sectors in reserved tracks"))
-        .replace("{$BAD_SECTOR_IN_DIRECTORY}", QCoreApplication::translate("FilePanel", "Bad sector in directory"))
-        .replace("{$NO_BAD_SECTORS_IN_DIRECTORY}", QCoreApplication::translate("FilePanel", "No bad sectors in directory"))
-        .replace("{$FILE_HAS_BAD_SECTORS}", QCoreApplication::translate("FilePanel", "File has bad sectors"))
-        .replace("{$NO_FILES_WITH_BAD_SECTORS}", QCoreApplication::translate("FilePanel", "No files with bad sectors"))
+    table.insert(QStringLiteral("{$SELECTOR_AGAT_PALETTE}"), QCoreApplication::translate("ViewDialog", "Palette"));
+    table.insert(QStringLiteral("{$SELECTOR_AGAT_INFO}"), QCoreApplication::translate("ViewDialog", "Comment"));
+    table.insert(QStringLiteral("{$SELECTOR_APPLE_HIRES_AGAT}"), QCoreApplication::translate("ViewDialog", "Agat color mode"));
+    table.insert(QStringLiteral("{$SELECTOR_APPLE_HIRES_APPLE}"), QCoreApplication::translate("ViewDialog", "Apple color mode"));
+    table.insert(QStringLiteral("{$SELECTOR_AGAT_FONT_TYPE}"), QCoreApplication::translate("ViewDialog", "Font type"));
+    table.insert(QStringLiteral("{$SELECTOR_AGAT_FONT}"), QCoreApplication::translate("ViewDialog", "Font"));
+
+    return table;
+}
+
+inline QHash<QString, QString> & placeholderTable()
+{
+    static QHash<QString, QString> table = buildPlaceholderTable();
+    return table;
+}
+
+// Translations are looked up once, so this must be called when the language changes
+inline void resetPlaceholders()
+{
+    placeholderTable() = buildPlaceholderTable();
+}
+
+// Replaces every known "{$NAME}" in one pass, unknown ones are kept as they are
+inline QString replacePlaceholders(const QString& input)
+{
+    const QHash<QString, QString> & table = placeholderTable();
 
-        // 15 viewer placeholders (ViewDialog context)
-        .replace("{$PALETTE}", QCoreApplication::translate("ViewDialog", "Palette"))
-        .replace("{$COLOR}", QCoreApplication::translate("ViewDialog", "Color"))
-        .replace("{$MONOCHROME}", QCoreApplication::translate("ViewDialog", "Monochrome"))
-        .replace("{$CUSTOM_PALETTE}", QCoreApplication::translate("ViewDialog", "Custom palette"))
-        .replace("{$BW}", QCoreApplication::translate("ViewDialog", "b/w"))
-        .replace("{$FONT_LOADING_ERROR}", QCoreApplication::translate("ViewDialog", "Custom font loading error"))
-        .replace("{$NTSC_AGAT_IMPROVED}", QCoreApplication::translate("ViewDialog", "Agat Improved"))
-        .replace("{$NTSC_APPLE_IMPROVED}", QCoreApplication::translate("ViewDialog", "Apple Improved"))
-        .replace("{$NTSC_APPLE_ORIGINAL}", QCoreApplication::translate("ViewDialog", "Apple NTSC Original"))
-        .replace("{$AGAT_FONT_A7_CLASSIC}", QCoreApplication::translate("ViewDialog", "Agat-7 classic font"))
-        .replace("{$AGAT_FONT_A7_ENCHANCED}", QCoreApplication::translate("ViewDialog", "Agat-7 enhanced font"))
-        .replace("{$AGAT_FONT_A9_CLASSIC}", QCoreApplication::translate("ViewDialog", "Agat-9 classic font"))
-        .replace("{$AGAT_FONT_CUSTOM_GARNIZON}", QCoreApplication::translate("ViewDialog", "GARNIZON custom font"))
-        .replace("{$AGAT_FONT_CUSTOM_LOADED}", QCoreApplication::translate("ViewDialog", "Loaded custom font"))
-        .replace("{$FONT_A9}", QCoreApplication::translate("ViewDialog", "Agat-9 Font"))
-        .replace("{$FONT_A7}", QCoreApplication::translate("ViewDialog", "Agat-7 Font"))
-        .replace("{$FONT_FILE}", QCoreApplication::translate("ViewDialog", "Font file"))
-        .replace("{$FONT_FILE_BFT}", QCoreApplication::translate("ViewDialog", "BFT Font"))
+    QString result;
+    result.reserve(input.size() + input.size() / 2);
+    int pos = 0;
+    while (true) {
+        const int start = input.indexOf(QLatin1String("{$"), pos);
+        const int end = (start < 0) ? -1 : input.indexOf(QLatin1Char('}'), start + 2);
+        if (end < 0) break;
 
-        .replace("{$SELECTOR_AGAT_PALETTE}", QCoreApplication::translate("ViewDialog", "Palette"))
-        .replace("{$SELECTOR_AGAT_INFO}", QCoreApplication::translate("ViewDialog", "Comment"))
-        .replace("{$SELECTOR_APPLE_HIRES_AGAT}", QCoreApplication::translate("ViewDialog", "Agat color mode"))
-        .replace("{$SELECTOR_APPLE_HIRES_APPLE}", QCoreApplication::translate("ViewDialog", "Apple color mode"))
-        .replace("{$SELECTOR_AGAT_FONT_TYPE}", QCoreApplication::translate("ViewDialog", "Font type"))
-        .replace("{$SELECTOR_AGAT_FONT}", QCoreApplication::translate("ViewDialog", "Font"))
-        ;
-}
\ No newline at end of file
+        const auto it = table.constFind(input.mid(start, end - start + 1));
+        if (it == table.constEnd()) {
+            // Not a placeholder, the next one may start inside it
+            result.append(input.constData() + pos, start + 2 - pos);
+            pos = start + 2;
+            continue;
+        }
+        result.append(input.constData() + pos, start - pos);
+        result.append(it.value());
+        pos = end + 1;
+    }
+    result.append(input.constData() + pos, input.size() - pos);
+    return result;
+}
@@ -0,0 +1,327 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass searching files inside a directory tree of disk images
+
+#include "searchdialog.h"
+#include "ImageUtils.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QMessageBox>
+#include <QThread>
+
+namespace {
+
+// Columns of the results
+enum {
+    ColumnImage,
+    ColumnFile,
+    ColumnHits,
+    ColumnText
+};
+
+// Item data of the image column
+const int ImageRole = Qt::UserRole;
+const int PathRole = Qt::UserRole + 1;
+
+} // namespace
+
+SearchDialog::SearchDialog(QWidget *parent,
+                           QSettings *settings,
+                           const QJsonObject * file_formats,
+                           const QString & source_dir)
+    : QDialog(parent)
+    , m_settings(settings)
+    , m_file_formats(file_formats)
+{
+    m_search = new ContentSearch(this);
+
+    setupUi();
+
+    sourceEdit->setText(m_settings->value("search/source_dir", source_dir).toString());
+    recursiveCheck->setChecked(m_settings->value("search/recursive", true).toBool());
+    textEdit->setText(m_settings->value("search/text", "").toString());
+    caseCheck->setChecked(m_settings->value("search/case_sensitive", false).toBool());
+    namesCheck->setChecked(m_settings->value("search/names", true).toBool());
+    contentsCombo->setCurrentIndex(qBound(0, m_settings->value("search/contents", 1).toInt(), contentsCombo->count() - 1));
+    encodingCombo->setCurrentIndex(qBound(0, m_settings->value("search/encoding", 0).toInt(), encodingCombo->count() - 1));
+    threadsCounter->setValue(m_settings->value("search/threads", QThread::idealThreadCount()).toInt());
+
+    connect(m_search, &ContentSearch::matchFound, this, &SearchDialog::onMatchFound);
+    connect(m_search, &BatchRunner::itemFinished, this, &SearchDialog::onItemFinished);
+    connect(m_search, &BatchRunner::progress, this, &SearchDialog::onProgress);
+    connect(m_search, &BatchRunner::finished, this, &SearchDialog::onFinished);
+
+    setControls();
+    setRunning(false);
+}
+
+SearchDialog::~SearchDialog()
+{
+    // Workers reference the search, so they must be gone before it is destroyed
+    m_search->cancel();
+    m_search->wait();
+}
+
+void SearchDialog::setupUi()
+{
+    setWindowTitle(SearchDialog::tr("Search in images"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // Source ------------------------------------------------------------------
+    QGroupBox *sourceGroup = new QGroupBox(SearchDialog::tr("Images"), this);
+    QGridLayout *sourceLayout = new QGridLayout(sourceGroup);
+
+    sourceEdit = new QLineEdit(sourceGroup);
+    QPushButton *sourceButton = new QPushButton("...", sourceGroup);
+    recursiveCheck = new QCheckBox(SearchDialog::tr("Include subdirectories"), sourceGroup);
+
+    sourceLayout->addWidget(new QLabel(SearchDialog::tr("Directory:"), sourceGroup), 0, 0);
+    sourceLayout->addWidget(sourceEdit, 0, 1);
+    sourceLayout->addWidget(sourceButton, 0, 2);
+    sourceLayout->addWidget(recursiveCheck, 1, 1, 1, 2);
+    layout->addWidget(sourceGroup);
+
+    connect(sourceButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, SearchDialog::tr("Choose directory"), sourceEdit->text());
+        if (!dir.isEmpty()) sourceEdit->setText(QDir::toNativeSeparators(dir));
+    });
+
+    // Query -------------------------------------------------------------------
+    QGroupBox *queryGroup = new QGroupBox(SearchDialog::tr("Search"), this);
+    QGridLayout *queryLayout = new QGridLayout(queryGroup);
+
+    textEdit = new QLineEdit(queryGroup);
+    caseCheck = new QCheckBox(SearchDialog::tr("Match case"), queryGroup);
+    namesCheck = new QCheckBox(SearchDialog::tr("Search in file names"), queryGroup);
+
+    contentsCombo = new QComboBox(queryGroup);
+    contentsCombo->addItem(SearchDialog::tr("Do not search"), static_cast<int>(SearchContents::None));
+    contentsCombo->addItem(SearchDialog::tr("File data in the encoding"), static_cast<int>(SearchContents::Bytes));
+    contentsCombo->addItem(SearchDialog::tr("Viewer text (BASIC listings etc.)"), static_cast<int>(SearchContents::Text));
+
+    // The same list as in the viewer
+    encodingCombo = new QComboBox(queryGroup);
+    encodingCombo->addItem(SearchDialog::tr("Agat"), "agat");
+    encodingCombo->addItem(SearchDialog::tr("Apple II"), "apple2");
+    encodingCombo->addItem(SearchDialog::tr("Apple //c"), "apple2c");
+    encodingCombo->addItem(SearchDialog::tr("ASCII"), "ascii");
+    encodingCombo->addItem(SearchDialog::tr("КОИ-7 Н0/Н1"), "koi7_n0_n1");
+    encodingCombo->addItem(SearchDialog::tr("КОИ-7 Н2"), "koi7_n2");
+
+    threadsCounter = new QSpinBox(queryGroup);
+    threadsCounter->setRange(1, 64);
+
+    queryLayout->addWidget(new QLabel(SearchDialog::tr("Text:"), queryGroup), 0, 0);
+    queryLayout->addWidget(textEdit, 0, 1, 1, 3);
+    queryLayout->addWidget(caseCheck, 1, 1);
+    queryLayout->addWidget(namesCheck, 1, 2, 1, 2);
+    queryLayout->addWidget(new QLabel(SearchDialog::tr("Contents:"), queryGroup), 2, 0);
+    queryLayout->addWidget(contentsCombo, 2, 1);
+    queryLayout->addWidget(new QLabel(SearchDialog::tr("Encoding:"), queryGroup), 2, 2);
+    queryLayout->addWidget(encodingCombo, 2, 3);
+    queryLayout->addWidget(new QLabel(SearchDialog::tr("Threads:"), queryGroup), 3, 0);
+    queryLayout->addWidget(threadsCounter, 3, 1);
+    queryLayout->setColumnStretch(1, 1);
+    layout->addWidget(queryGroup);
+
+    connect(contentsCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SearchDialog::setControls);
+    connect(textEdit, &QLineEdit::returnPressed, this, &SearchDialog::onStart);
+
+    // Results -----------------------------------------------------------------
+    progressBar = new QProgressBar(this);
+    layout->addWidget(progressBar);
+
+    resultsTree = new QTreeWidget(this);
+    resultsTree->setRootIsDecorated(false);
+    resultsTree->setUniformRowHeights(true);
+    resultsTree->setHeaderLabels(QStringList()
+                                 << SearchDialog::tr("Image")
+                                 << SearchDialog::tr("File")
+                                 << SearchDialog::tr("Found")
+                                 << SearchDialog::tr("Text"));
+    resultsTree->header()->setStretchLastSection(true);
+    resultsTree->setColumnWidth(ColumnImage, 250);
+    resultsTree->setColumnWidth(ColumnFile, 150);
+    resultsTree->setColumnWidth(ColumnHits, 60);
+    layout->addWidget(resultsTree, 1);
+
+    connect(resultsTree, &QTreeWidget::itemActivated, this, &SearchDialog::onResultActivated);
+
+    summaryLabel = new QLabel(this);
+    layout->addWidget(summaryLabel);
+
+    // Buttons -----------------------------------------------------------------
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    startButton = new QPushButton(SearchDialog::tr("Start"), this);
+    cancelButton = new QPushButton(SearchDialog::tr("Stop"), this);
+    closeButton = new QPushButton(SearchDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(cancelButton);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(startButton, &QPushButton::clicked, this, &SearchDialog::onStart);
+    connect(cancelButton, &QPushButton::clicked, this, &SearchDialog::onCancel);
+    connect(closeButton, &QPushButton::clicked, this, &SearchDialog::reject);
+
+    resize(800, 640);
+}
+
+void SearchDialog::setControls()
+{
+    const auto contents = static_cast<SearchContents>(contentsCombo->currentData().toInt());
+    encodingCombo->setEnabled(contents != SearchContents::None);
+}
+
+void SearchDialog::setRunning(bool running)
+{
+    startButton->setEnabled(!running);
+    cancelButton->setEnabled(running);
+    sourceEdit->setEnabled(!running);
+    textEdit->setEnabled(!running);
+    threadsCounter->setEnabled(!running);
+}
+
+void SearchDialog::saveSetup()
+{
+    m_settings->setValue("search/source_dir", sourceEdit->text());
+    m_settings->setValue("search/recursive", recursiveCheck->isChecked());
+    m_settings->setValue("search/text", textEdit->text());
+    m_settings->setValue("search/case_sensitive", caseCheck->isChecked());
+    m_settings->setValue("search/names", namesCheck->isChecked());
+    m_settings->setValue("search/contents", contentsCombo->currentIndex());
+    m_settings->setValue("search/encoding", encodingCombo->currentIndex());
+    m_settings->setValue("search/threads", threadsCounter->value());
+}
+
+void SearchDialog::onStart()
+{
+    if (m_search->isRunning()) return;
+
+    const QString source_root = QDir::fromNativeSeparators(sourceEdit->text());
+    if (source_root.isEmpty() || !QFileInfo(source_root).isDir()) {
+        QMessageBox::critical(this, SearchDialog::tr("Error"), SearchDialog::tr("Source directory not found."));
+        return;
+    }
+
+    SearchOptions options;
+    options.root = source_root;
+    options.text = textEdit->text();
+    options.case_sensitive = caseCheck->isChecked();
+    options.names = namesCheck->isChecked();
+    options.contents = static_cast<SearchContents>(contentsCombo->currentData().toInt());
+    options.encoding = encodingCombo->currentData().toString().toStdString();
+
+    saveSetup();
+
+    const QStringList images = ImageUtils::collectImages(
+        source_root,
+        ImageUtils::sourceFilters(*m_file_formats),
+        recursiveCheck->isChecked()
+    );
+    if (images.isEmpty()) {
+        QMessageBox::information(this, SearchDialog::tr("Search in images"), SearchDialog::tr("No disk images found."));
+        return;
+    }
+
+    resultsTree->clear();
+    summaryLabel->clear();
+    m_files_found = 0;
+    progressBar->setRange(0, images.size());
+    progressBar->setValue(0);
+
+    m_search->setOptions(options);
+    m_search->setMaxThreads(threadsCounter->value());
+    setRunning(true);
+    if (!m_search->start(images)) {
+        setRunning(false);
+        QMessageBox::critical(this, SearchDialog::tr("Error"), m_search->errorString());
+    }
+}
+
+void SearchDialog::onCancel()
+{
+    m_search->cancel();
+    cancelButton->setEnabled(false);
+}
+
+void SearchDialog::onMatchFound(const QString & image, const QString & path, int hits, const QString & excerpt)
+{
+    m_files_found++;
+
+    QTreeWidgetItem *row = new QTreeWidgetItem(resultsTree);
+    row->setText(ColumnImage, QDir::toNativeSeparators(QDir(m_search->options().root).relativeFilePath(image)));
+    row->setToolTip(ColumnImage, QDir::toNativeSeparators(image));
+    row->setData(ColumnImage, ImageRole, image);
+    row->setData(ColumnImage, PathRole, path);
+    row->setText(ColumnFile, path);
+    row->setText(ColumnHits, QString::number(hits));
+    row->setTextAlignment(ColumnHits, Qt::AlignRight | Qt::AlignVCenter);
+    row->setText(ColumnText, excerpt);
+    row->setToolTip(ColumnText, excerpt);
+}
+
+void SearchDialog::onItemFinished(int index, const QString & item, bool ok, const QString & message)
+{
+    Q_UNUSED(index);
+    if (ok) return;
+
+    // Images which cannot be opened are listed too, so a miss is not taken for an absent text
+    QTreeWidgetItem *row = new QTreeWidgetItem(resultsTree);
+    row->setText(ColumnImage, QDir::toNativeSeparators(QDir(m_search->options().root).relativeFilePath(item)));
+    row->setToolTip(ColumnImage, QDir::toNativeSeparators(item));
+    row->setText(ColumnText, message);
+    row->setForeground(ColumnText, QBrush(Qt::red));
+}
+
+void SearchDialog::onProgress(int done, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(done);
+}
+
+void SearchDialog::onFinished(int succeeded, int failed, qint64 elapsed_ms)
+{
+    setRunning(false);
+    resultsTree->sortItems(ColumnImage, Qt::AscendingOrder);
+    summaryLabel->setText(
+        SearchDialog::tr("Files found: %1, images searched: %2, not opened: %3, time: %4 s")
+            .arg(m_files_found)
+            .arg(succeeded)
+            .arg(failed)
+            .arg(static_cast<double>(elapsed_ms) / 1000.0, 0, 'f', 1)
+    );
+}
+
+void SearchDialog::onResultActivated(QTreeWidgetItem * item)
+{
+    const QString image = item->data(ColumnImage, ImageRole).toString();
+    if (image.isEmpty()) return;
+
+    if (m_search->isRunning()) {
+        m_search->cancel();
+        m_search->wait();
+    }
+    m_selected_image = image;
+    m_selected_path = item->data(ColumnImage, PathRole).toString();
+    accept();
+}
+
+void SearchDialog::reject()
+{
+    if (m_search->isRunning()) {
+        m_search->cancel();
+        m_search->wait();
+    }
+    QDialog::reject();
+}
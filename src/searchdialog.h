@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass searching files inside a directory tree of disk images
+
+#pragma once
+
+#include <QDialog>
+#include <QSettings>
+#include <QJsonObject>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include "ContentSearch.h"
+
+class SearchDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SearchDialog(QWidget *parent,
+                          QSettings *settings,
+                          const QJsonObject * file_formats,
+                          const QString & source_dir);
+    ~SearchDialog();
+
+    // The image of the result chosen by the user, valid after the dialog is accepted
+    QString selectedImage() const { return m_selected_image; }
+    QString selectedPath() const { return m_selected_path; }
+
+protected:
+    void reject() override;
+
+private slots:
+    void onStart();
+    void onCancel();
+    void onMatchFound(const QString & image, const QString & path, int hits, const QString & excerpt);
+    void onItemFinished(int index, const QString & item, bool ok, const QString & message);
+    void onProgress(int done, int total);
+    void onFinished(int succeeded, int failed, qint64 elapsed_ms);
+    void onResultActivated(QTreeWidgetItem * item);
+    void setControls();
+
+private:
+    QSettings * m_settings;
+    const QJsonObject * m_file_formats;
+
+    ContentSearch * m_search;
+    int m_files_found {0};
+    QString m_selected_image;
+    QString m_selected_path;
+
+    QLineEdit * sourceEdit;
+    QCheckBox * recursiveCheck;
+    QLineEdit * textEdit;
+    QCheckBox * caseCheck;
+    QCheckBox * namesCheck;
+    QComboBox * contentsCombo;
+    QComboBox * encodingCombo;
+    QSpinBox * threadsCounter;
+    QProgressBar * progressBar;
+    QTreeWidget * resultsTree;
+    QLabel * summaryLabel;
+    QPushButton * startButton;
+    QPushButton * cancelButton;
+    QPushButton * closeButton;
+
+    void setupUi();
+    void saveSetup();
+    void setRunning(bool running);
+};
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass for viewing raw sectors of a disk image
+
+#include "sectordialog.h"
+#include "mainutils.h"
+
+#include <algorithm>
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+
+SectorDialog::SectorDialog(QWidget *parent, QSettings *settings, dsk_tools::diskImage * image)
+    : QDialog(parent)
+    , m_settings(settings)
+{
+    setupUi(image);
+
+    // The same setting as the file viewer's encoding
+    encodingCombo->setCurrentIndex(m_settings->value("viewer/encoding", 0).toInt());
+    onEncodingChanged(encodingCombo->currentIndex());
+
+    resize(760, 560);
+}
+
+void SectorDialog::setupUi(dsk_tools::diskImage * image)
+{
+    setWindowTitle(SectorDialog::tr("Sectors"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QHBoxLayout *toolsLayout = new QHBoxLayout();
+
+    trackSpin = new QSpinBox(this);
+    trackSpin->setRange(0, std::max(0, image->get_tracks() - 1));
+    headSpin = new QSpinBox(this);
+    headSpin->setRange(0, std::max(0, image->get_heads() - 1));
+    sectorSpin = new QSpinBox(this);
+    sectorSpin->setRange(0, std::max(0, image->get_sectors() - 1));
+    QPushButton *goButton = new QPushButton(SectorDialog::tr("Go"), this);
+
+    // The ids are those of Charsets::Encoding
+    encodingCombo = new QComboBox(this);
+    encodingCombo->addItem(SectorDialog::tr("Agat"), static_cast<int>(Charsets::Agat));
+    encodingCombo->addItem(SectorDialog::tr("Apple II"), static_cast<int>(Charsets::Apple2));
+    encodingCombo->addItem(SectorDialog::tr("Apple //c"), static_cast<int>(Charsets::Apple2c));
+    encodingCombo->addItem(SectorDialog::tr("ASCII"), static_cast<int>(Charsets::Ascii));
+    encodingCombo->addItem(SectorDialog::tr("КОИ-7 Н0/Н1"), static_cast<int>(Charsets::Koi7N0N1));
+    encodingCombo->addItem(SectorDialog::tr("КОИ-7 Н2"), static_cast<int>(Charsets::Koi7N2));
+    adjustComboBoxWidth(encodingCombo);
+
+    toolsLayout->addWidget(new QLabel(SectorDialog::tr("Track:"), this));
+    toolsLayout->addWidget(trackSpin);
+    toolsLayout->addWidget(new QLabel(SectorDialog::tr("Side:"), this));
+    toolsLayout->addWidget(headSpin);
+    toolsLayout->addWidget(new QLabel(SectorDialog::tr("Sector:"), this));
+    toolsLayout->addWidget(sectorSpin);
+    toolsLayout->addWidget(goButton);
+    toolsLayout->addStretch(1);
+    toolsLayout->addWidget(new QLabel(SectorDialog::tr("Encoding:"), this));
+    toolsLayout->addWidget(encodingCombo);
+    layout->addLayout(toolsLayout);
+
+    sectorView = new SectorView(this);
+    sectorView->setImage(image);
+    layout->addWidget(sectorView, 1);
+
+    QHBoxLayout *buttonsLayout = new QHBoxLayout();
+    QPushButton *closeButton = new QPushButton(SectorDialog::tr("Close"), this);
+    buttonsLayout->addStretch(1);
+    buttonsLayout->addWidget(closeButton);
+    layout->addLayout(buttonsLayout);
+
+    connect(goButton, &QPushButton::clicked, this, &SectorDialog::onGo);
+    connect(closeButton, &QPushButton::clicked, this, &SectorDialog::close);
+    connect(sectorView, &SectorView::positionChanged, this, &SectorDialog::onPositionChanged);
+    connect(encodingCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SectorDialog::onEncodingChanged);
+
+    // Enter in a spin box jumps as well
+    for (QSpinBox * spin : {trackSpin, headSpin, sectorSpin})
+        connect(spin, &QSpinBox::editingFinished, this, &SectorDialog::onGo);
+}
+
+void SectorDialog::onGo()
+{
+    sectorView->goTo(trackSpin->value(), headSpin->value(), sectorSpin->value());
+    sectorView->setFocus();
+}
+
+void SectorDialog::onPositionChanged(int track, int head, int sector)
+{
+    for (QSpinBox * spin : {trackSpin, headSpin, sectorSpin}) spin->blockSignals(true);
+    trackSpin->setValue(track);
+    headSpin->setValue(head);
+    sectorSpin->setValue(sector);
+    for (QSpinBox * spin : {trackSpin, headSpin, sectorSpin}) spin->blockSignals(false);
+}
+
+void SectorDialog::onEncodingChanged(int index)
+{
+    sectorView->setEncoding(static_cast<Charsets::Encoding>(encodingCombo->itemData(index).toInt()));
+}
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: A QDialog subclass for viewing raw sectors of a disk image
+
+#pragma once
+
+#include <QDialog>
+#include <QSettings>
+#include <QComboBox>
+#include <QSpinBox>
+
+#include "SectorView.h"
+#include "dsk_tools/dsk_tools.h"
+
+class SectorDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SectorDialog(QWidget *parent, QSettings *settings, dsk_tools::diskImage * image);
+
+private slots:
+    void onGo();
+    void onPositionChanged(int track, int head, int sector);
+    void onEncodingChanged(int index);
+
+private:
+    QSettings * m_settings;
+
+    SectorView * sectorView;
+    QSpinBox * trackSpin;
+    QSpinBox * headSpin;
+    QSpinBox * sectorSpin;
+    QComboBox * encodingCombo;
+
+    void setupUi(dsk_tools::diskImage * image);
+};
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2025 Mikhail Revzin <p3.141592653589793238462643@gmail.com>
+// Part of the DISK Commander project: https://github.com/Ptr314/dsk_commander
+// Description: String conversions that need only Qt Core
+
+#pragma once
+
+#include <QString>
+#include <string>
+
+inline std::string _toStdString(const QString& text) {
+    // #ifdef _WIN32
+    //     return std::string(text.toLocal8Bit().constData());
+    // #else
+    //     return std::string(text.toUtf8().constData());
+    // #endif
+    return std::string(text.toUtf8().constData());
+}
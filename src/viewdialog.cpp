@@ -20,6 +20,7 @@
 #include <QHBoxLayout>
 #include <QFrame>
 #include <QVBoxLayout>
+#include <QElapsedTimer>
 
 #include "viewdialog.h"
 
@@ -28,10 +29,20 @@
 #include "placeholders.h"
 #include "ui_viewdialog.h"
 #include "host_helpers.h"
+#include "ViewerRegistry.h"
+#include "PixelScaler.h"
+#include "ViewerText.h"
+#include "TextRenderCache.h"
 
 #include "dsk_tools/dsk_tools.h"
 
-ViewDialog::ViewDialog(QWidget *parent, QSettings *settings, const QString file_name, const dsk_tools::BYTES &data, dsk_tools::PreferredType preferred_type, bool deleted, dsk_tools::diskImage * disk_image, dsk_tools::fileSystem * filesystem, const dsk_tools::UniversalFile& f)
+// Plain text is decoded in parts of this size, and the timer decodes parts for this long per tick
+static const size_t TEXT_CHUNK_SIZE = 16 * 1024;
+static const int TEXT_TICK_MS = 15;
+// Laid out outputs kept by a dialog for switching back to them
+static const size_t TEXT_LAYOUTS = 4;
+
+ViewDialog::ViewDialog(QWidget *parent, QSettings *settings, const QString file_name, const dsk_tools::BYTES &data, dsk_tools::PreferredType preferred_type, bool deleted, dsk_tools::diskImage * disk_image, dsk_tools::fileSystem * filesystem, const FileHandle& f)
     : QDialog(parent)
     , ui(new Ui::ViewDialog)
     , m_settings(settings)
@@ -50,22 +61,7 @@ ViewDialog::ViewDialog(QWidget *parent, QSettings *settings, const QString file_
     // QFont font("Consolas", 10, 400);
     // ui->textBox->setFont(font);
 
-    dsk_tools::register_all_viewers();
-
-    dsk_tools::ViewerManager& manager = dsk_tools::ViewerManager::instance();
-    auto all_types = manager.list_types();
-    for (const auto& type : all_types) {
-        std::vector<std::pair<std::string, std::string>> subtypes = manager.list_subtypes(type);
-
-        for (const std::pair<std::string, std::string>& subtype : subtypes) {
-            const std::string& subtype_id = subtype.first;
-
-            std::unique_ptr<dsk_tools::Viewer> viewer = manager.create(type, subtype_id);
-            if (viewer && viewer->fits(data)) {
-                m_subtypes[type].push_back(subtype_id);
-            }
-        }
-    }
+    m_subtypes = ViewerRegistry::instance().fits(data);
 
     std::vector<std::string> fit_types = get_types_from_map(m_subtypes);
 
@@ -165,6 +161,8 @@ ViewDialog::ViewDialog(QWidget *parent, QSettings *settings, const QString file_
 
 
     connect(&m_pic_timer, &QTimer::timeout, this, &ViewDialog::pic_timer_proc);
+    connect(&m_frame_ring, &FrameRing::ready, this, &ViewDialog::on_frame_ring_ready);
+    connect(&m_text_timer, &QTimer::timeout, this, &ViewDialog::text_timer_proc);
     // m_pic_timer.setSingleShot(true);
     // m_pic_timer.start(1000);
 
@@ -237,6 +235,7 @@ void ViewDialog::print_data()
         auto type = ui->modeCombo->currentData().toString().toStdString();
         auto subtype = (use_subtypes)?ui->subtypeCombo->currentData().toString().toStdString():"";
 
+        const bool new_viewer = recreate_viewer;
         if (recreate_viewer) {
             m_viewer = dsk_tools::ViewerManager::instance().create(type, subtype);
             auto picViewer = dynamic_cast<dsk_tools::ViewerPic*>(m_viewer.get());
@@ -247,24 +246,61 @@ void ViewDialog::print_data()
 
         const auto output_type = m_viewer->get_output_type();
         if (output_type == dsk_tools::ViewerOutput::Text) {
+            clear_frame_ring();
             ui->encodingCombo->setVisible(true);
             ui->encodingLabel->setVisible(true);
             ui->encodingSpacer->changeSize(10, 20);
 
             auto cm_name = ui->encodingCombo->currentData().toString().toStdString();
-            auto out = m_viewer->process_as_text(m_data, cm_name);
-
-            QFile css_file(":/files/basic.css");
-            if (css_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                QTextStream stream(&css_file);
-                m_saved_css = stream.readAll();
-                ui->textEdit->document()->setDefaultStyleSheet(m_saved_css);
-                css_file.close();
+
+            // Plain text is decoded by lines in parts, other text viewers need the whole file.
+            // The view keeps lines and spans, HTML is built only for copying and saving.
+            store_text_layout();
+            ui->listingView->setListingStyleSheet(TextRenderCache::styleSheet());
+            const std::string text_key = type + "|" + subtype;
+            const bool same_text = !new_viewer && text_key == m_text_key && !m_text_chunks.empty();
+            if (!same_text) {
+                m_text_key = text_key;
+                if (type == "TEXT")
+                    m_text_chunks = ViewerText::lineChunks(m_data.data(), m_data.size(), TEXT_CHUNK_SIZE);
+                else
+                    m_text_chunks.assign(1, std::make_pair(size_t(0), m_data.size()));
+                m_text_html.assign(m_text_chunks.size(), std::string());
+                ui->listingView->clear();
+            }
+            m_text_encoding = cm_name;
+            m_text_cache_key = TextRenderCache::key(m_data, type, subtype, cm_name);
+
+            // An output seen before is neither decoded nor laid out again
+            m_text_queue.clear();
+            const auto layout = m_text_layouts.find(text_key + "|" + cm_name);
+            if (layout != m_text_layouts.end()) {
+                m_text_cached = true;
+                m_text_html = layout->second.html;
+                ui->listingView->setBlocks(layout->second.blocks);
             } else {
-                qDebug() << "Failed to load CSS file";
+                m_text_cached = TextRenderCache::find(m_text_cache_key, m_text_html);
+
+                // Parts on the screen go first, so a new encoding is seen at once
+                int first = 0, last = 0;
+                if (same_text && ui->listingView->blockCount() > 0) {
+                    first = ui->listingView->firstVisibleBlock();
+                    last = ui->listingView->lastVisibleBlock();
+                }
+                for (int i = first; i <= last; i++) m_text_queue.push_back(i);
+                for (int i = 0; i < static_cast<int>(m_text_chunks.size()); i++)
+                    if (i < first || i > last) m_text_queue.push_back(i);
+
+                for (int i = first; i <= last; i++) {
+                    decode_text_chunk(m_text_queue.front());
+                    m_text_queue.pop_front();
+                }
             }
-            m_saved_html = QString::fromStdString(out);
-            ui->textEdit->setHtml("<body>" + m_saved_html + "</body>");
+            if (m_text_queue.empty()) {
+                m_text_timer.stop();
+                text_finished();
+            } else
+                m_text_timer.start(0);
 
             ui->viewArea->setCurrentIndex(0);
 
@@ -272,6 +308,7 @@ void ViewDialog::print_data()
             ui->saveButton->setVisible(true);
         } else
         if (output_type == dsk_tools::ViewerOutput::Picture) {
+            clear_text();
             ui->encodingCombo->setVisible(false);
             ui->encodingLabel->setVisible(false);
             ui->encodingSpacer->changeSize(0, 0);
@@ -279,15 +316,28 @@ void ViewDialog::print_data()
             int sx, sy;
             if (auto picViewer = dynamic_cast<dsk_tools::ViewerPic*>(m_viewer.get())) {
                 const dsk_tools::ViewerSelectorValues selectors = collectSelectors();
-                picViewer->set_selectors(selectors);
-                m_imageData = picViewer->process_picture(m_data, sx, sy, m_pic_frame++);
-                m_image = QImage(m_imageData.data(), sx, sy, QImage::Format_RGBA8888);
-                update_image();
-
-                int delay = picViewer->get_frame_delay();
-                if (delay > 0) {
-                    m_pic_timer.setSingleShot(true);
-                    m_pic_timer.start(delay);
+                const QString ring_key = frame_ring_key(selectors);
+                const bool new_key = ring_key != m_ring_key;
+                if (new_key) {
+                    clear_frame_ring();
+                    m_ring_key = ring_key;
+                }
+
+                if (m_frame_ring.isReady()) {
+                    show_ring_frame();
+                } else {
+                    picViewer->set_selectors(selectors);
+                    m_imageData = picViewer->process_picture(m_data, sx, sy, m_pic_frame++);
+                    m_image = QImage(m_imageData.data(), sx, sy, QImage::Format_RGBA8888);
+                    update_image();
+
+                    int delay = picViewer->get_frame_delay();
+                    if (delay > 0) {
+                        // Live frames are shown until the cycle is ready
+                        if (new_key) start_frame_ring(selectors);
+                        m_pic_timer.setSingleShot(true);
+                        m_pic_timer.start(delay);
+                    }
                 }
             }
             ui->viewArea->setCurrentIndex(1);
@@ -314,56 +364,52 @@ dsk_tools::ViewerSelectorValues ViewDialog::collectSelectors()
 }
 
 void ViewDialog::update_image()
+{
+    if (m_frame_ring.isReady()) {
+        // Scale or proportions changed: the cycle is scaled again, not decoded again
+        scale_ring_frames();
+        ui->picLabel->setPixmap(m_ring_pixmaps[m_ring_pos]);
+        return;
+    }
+    scale_image(m_image, m_scaled);
+    ui->picLabel->setPixmap(QPixmap::fromImage(m_scaled));
+}
+
+void ViewDialog::scale_image(const QImage & image, QImage & out) const
 {
     // QSize labelSize = ui->picLabel->size();
     QString scr_mode = ui->propsCombo->itemData(ui->propsCombo->currentIndex()).toString();
-    QImage scaledImage;
-    if (scr_mode == "sqp" || (scr_mode == "sqs" && m_image.width()==m_image.height())) {
-        scaledImage = m_image.scaled(
-            m_image.width() * m_scaleFactor,
-            m_image.height() * m_scaleFactor,
-            Qt::KeepAspectRatio,
-            Qt::FastTransformation
-        );
+    double ratio_w = 1, ratio_h = 1;
+    if (scr_mode == "sqp" || (scr_mode == "sqs" && image.width()==image.height())) {
+        // Square pixels
     } else
     if (scr_mode == "sqs") {
-        double ratio_w, ratio_h;
-        if (m_image.width() > m_image.height()) {
+        if (image.width() > image.height()) {
             ratio_w = 1;
-            ratio_h = (double)m_image.width() / m_image.height();
+            ratio_h = (double)image.width() / image.height();
         } else {
-            ratio_w = (double)m_image.height() / m_image.width();
+            ratio_w = (double)image.height() / image.width();
             ratio_h = 1;
 
         }
-        scaledImage = m_image.scaled(
-            m_image.width() * m_scaleFactor * ratio_w,
-            m_image.height() * m_scaleFactor * ratio_h,
-            Qt::IgnoreAspectRatio,
-            Qt::FastTransformation
-        );
     } else {
         // 43
-        double ratio_w, ratio_h;
-        if (m_image.width() > m_image.height()) {
+        if (image.width() > image.height()) {
             ratio_w = 1;
-            ratio_h = (double)m_image.width() / m_image.height() * 3 / 4;
+            ratio_h = (double)image.width() / image.height() * 3 / 4;
         } else {
-            ratio_w = (double)m_image.height() / m_image.width() * 4 / 3;
+            ratio_w = (double)image.height() / image.width() * 4 / 3;
             ratio_h = 1;
 
         }
-        scaledImage = m_image.scaled(
-            m_image.width() * m_scaleFactor * ratio_w,
-            m_image.height() * m_scaleFactor * ratio_h,
-            Qt::IgnoreAspectRatio,
-            Qt::FastTransformation
-            );
-
     };
 
-    QPixmap pixmap = QPixmap::fromImage(scaledImage);
-    ui->picLabel->setPixmap(pixmap);
+    PixelScaler::scale(
+        image,
+        image.width() * m_scaleFactor * ratio_w,
+        image.height() * m_scaleFactor * ratio_h,
+        out
+    );
 }
 
 
@@ -924,7 +970,74 @@ void ViewDialog::on_subtypeCombo_currentIndexChanged(int index)
 
 void ViewDialog::pic_timer_proc()
 {
-    print_data();
+    if (m_frame_ring.isReady() && ui->viewArea->currentIndex() == 1) {
+        m_ring_pos = (m_ring_pos + 1) % m_frame_ring.size();
+        show_ring_frame();
+    } else
+        print_data();
+}
+
+// ============================================================================
+// Frame ring
+
+QString ViewDialog::frame_ring_key(const dsk_tools::ViewerSelectorValues & selectors) const
+{
+    QString key = ui->modeCombo->currentData().toString();
+    if (use_subtypes) key += "|" + ui->subtypeCombo->currentData().toString();
+    for (const auto & selector : selectors)
+        key += "|" + QString::fromStdString(selector.first) + "=" + QString::fromStdString(selector.second);
+    return key;
+}
+
+void ViewDialog::start_frame_ring(const dsk_tools::ViewerSelectorValues & selectors)
+{
+    // The worker gets its own viewer, the one in m_viewer keeps serving live frames
+    auto type = ui->modeCombo->currentData().toString().toStdString();
+    auto subtype = (use_subtypes)?ui->subtypeCombo->currentData().toString().toStdString():"";
+    std::unique_ptr<dsk_tools::Viewer> viewer = dsk_tools::ViewerManager::instance().create(type, subtype);
+    auto picViewer = dynamic_cast<dsk_tools::ViewerPic*>(viewer.get());
+    if (!picViewer) return;
+
+    std::string error_msg;
+    picViewer->prepare_data(m_data, *m_disk_image, *m_filesystem, error_msg);
+    picViewer->set_selectors(selectors);
+    viewer.release();
+    m_frame_ring.render(std::unique_ptr<dsk_tools::ViewerPic>(picViewer), m_data);
+}
+
+void ViewDialog::clear_frame_ring()
+{
+    m_frame_ring.clear();
+    m_ring_pixmaps.clear();
+    m_ring_key.clear();
+}
+
+void ViewDialog::scale_ring_frames()
+{
+    // QPixmap lives in the GUI thread only, so the worker hands over images converted here once
+    m_ring_pixmaps.clear();
+    m_ring_pixmaps.reserve(m_frame_ring.size());
+    for (int i = 0; i < m_frame_ring.size(); i++) {
+        scale_image(m_frame_ring.frame(i), m_scaled);
+        m_ring_pixmaps.push_back(QPixmap::fromImage(m_scaled));
+    }
+}
+
+void ViewDialog::on_frame_ring_ready()
+{
+    scale_ring_frames();
+    m_ring_pos = m_pic_frame % m_frame_ring.size();
+    show_ring_frame();
+}
+
+void ViewDialog::show_ring_frame()
+{
+    if (m_ring_pixmaps.empty()) return;
+    m_image = m_frame_ring.frame(m_ring_pos);
+    ui->picLabel->setPixmap(m_ring_pixmaps[m_ring_pos]);
+
+    m_pic_timer.setSingleShot(true);
+    m_pic_timer.start(m_frame_ring.delay(m_ring_pos));
 }
 
 
@@ -948,17 +1061,105 @@ void ViewDialog::restore_scale()
     ui->scaleSlider->blockSignals(false);
 }
 
+// ============================================================================
+// Text output
+
+void ViewDialog::decode_text_chunk(int index)
+{
+    // Cached HTML is only laid out
+    if (!m_text_cached) {
+        const std::pair<size_t, size_t> & chunk = m_text_chunks[index];
+        if (chunk.second == m_data.size()) {
+            m_text_html[index] = m_viewer->process_as_text(m_data, m_text_encoding);
+        } else {
+            const dsk_tools::BYTES part(m_data.begin() + chunk.first, m_data.begin() + chunk.first + chunk.second);
+            m_text_html[index] = m_viewer->process_as_text(part, m_text_encoding);
+        }
+    }
+
+    // Parts are queued so that every new one is next to the already shown ones
+    if (index < ui->listingView->blockCount())
+        ui->listingView->replaceBlock(index, m_text_html[index]);
+    else
+        ui->listingView->appendBlock(m_text_html[index]);
+}
+
+void ViewDialog::text_timer_proc()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (!m_text_queue.empty() && elapsed.elapsed() < TEXT_TICK_MS) {
+        decode_text_chunk(m_text_queue.front());
+        m_text_queue.pop_front();
+    }
+    if (m_text_queue.empty()) {
+        m_text_timer.stop();
+        text_finished();
+    }
+}
+
+void ViewDialog::finish_text()
+{
+    if (m_text_queue.empty()) return;
+    while (!m_text_queue.empty()) {
+        decode_text_chunk(m_text_queue.front());
+        m_text_queue.pop_front();
+    }
+    m_text_timer.stop();
+    text_finished();
+}
+
+void ViewDialog::text_finished()
+{
+    if (!m_text_cached) TextRenderCache::insert(m_text_cache_key, m_text_html);
+    m_text_cached = true;
+}
+
+void ViewDialog::store_text_layout()
+{
+    // Only complete outputs are kept, the oldest one goes first
+    if (m_text_key.empty() || m_text_chunks.empty() || !m_text_queue.empty()) return;
+    const std::string key = m_text_key + "|" + m_text_encoding;
+    if (m_text_layouts.count(key)) return;
+
+    TextLayout & layout = m_text_layouts[key];
+    layout.html = m_text_html;
+    layout.blocks = ui->listingView->blocks();
+    m_text_layout_order.push_back(key);
+    if (m_text_layout_order.size() > TEXT_LAYOUTS) {
+        m_text_layouts.erase(m_text_layout_order.front());
+        m_text_layout_order.pop_front();
+    }
+}
+
+void ViewDialog::clear_text()
+{
+    store_text_layout();
+    m_text_timer.stop();
+    m_text_queue.clear();
+    m_text_chunks.clear();
+    m_text_html.clear();
+    m_text_key.clear();
+    m_text_cached = false;
+    ui->listingView->clear();
+}
+
 void ViewDialog::on_copyButton_clicked()
 {
-    QString html = ui->textEdit->toHtml();
+    finish_text();
     QMimeData *mimeData = new QMimeData();
-    mimeData->setHtml(html);
-    mimeData->setText(ui->textEdit->toPlainText());
+    mimeData->setHtml(listing_html());
+    mimeData->setText(ui->listingView->toPlainText());
     QClipboard *clipboard = QApplication::clipboard();
     clipboard->setMimeData(mimeData);
 }
 
 
+QString ViewDialog::listing_html() const
+{
+    return TextRenderCache::document(m_text_html);
+}
+
 void ViewDialog::on_saveButton_clicked()
 {
     QString file_name = m_file_name;
@@ -989,20 +1190,15 @@ void ViewDialog::on_saveButton_clicked()
                 if (res != QMessageBox::Yes) return;
             }
         #endif
+        finish_text();
         UTF8_ofstream file(file_name.toStdString(), std::ios::binary);
         if (file.good()) {
             std::string buffer;
             if (selected_filter.startsWith("HTML")) {
-                QString html =  "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\" \"http://www.w3.org/TR/REC-html40/strict.dtd\">\r\n"
-                                "<html><head><meta charset=\"utf-8\" /><style type=\"text/css\">" +
-                                m_saved_css +
-                                "</style></head><body><div style=\"display: flex; flex-direction: column; gap: 0\">" +
-                                m_saved_html +
-                                "</div></body></html>";
-                buffer = html.toUtf8().toStdString();
+                buffer = listing_html().toUtf8().toStdString();
             }
             else
-                buffer = ui->textEdit->toPlainText().toUtf8().toStdString();
+                buffer = ui->listingView->toPlainText().toUtf8().toStdString();
             file.write(buffer.data(), buffer.size());
         }
         QString new_dir = fi.absolutePath();
@@ -1015,7 +1211,7 @@ void ViewDialog::on_saveButton_clicked()
 
 void ViewDialog::on_infoButton_clicked()
 {
-    FileOperations::infoDialog(this, QString::fromStdString(m_filesystem->file_info(m_f)));
+    FileOperations::infoDialog(this, QString::fromStdString(m_filesystem->file_info(*m_f)));
 }
 
 
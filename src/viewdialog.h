@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
+
 #include <QDialog>
 #include <QSettings>
 #include <QTimer>
@@ -16,8 +19,12 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFrame>
+#include <QPixmap>
 
 #include "dsk_tools/dsk_tools.h"
+#include "FileHandle.h"
+#include "FrameRing.h"
+#include "TextListingView.h"
 
 namespace Ui {
 class ViewDialog;
@@ -28,7 +35,7 @@ class ViewDialog : public QDialog
     Q_OBJECT
 
 public:
-    explicit ViewDialog(QWidget *parent, QSettings  *settings, const QString file_name, const dsk_tools::BYTES &data, dsk_tools::PreferredType preferred_type, bool deleted, dsk_tools::diskImage * image, dsk_tools::fileSystem * filesystem, const dsk_tools::UniversalFile& f);
+    explicit ViewDialog(QWidget *parent, QSettings  *settings, const QString file_name, const dsk_tools::BYTES &data, dsk_tools::PreferredType preferred_type, bool deleted, dsk_tools::diskImage * image, dsk_tools::fileSystem * filesystem, const FileHandle& f);
     ~ViewDialog();
 
 private slots:
@@ -46,6 +53,9 @@ private slots:
 
     void pic_timer_proc();
 
+    void on_frame_ring_ready();
+    void text_timer_proc();
+
     void on_copyButton_clicked();
 
     void on_saveButton_clicked();
@@ -59,7 +69,7 @@ private:
     dsk_tools::BYTES m_data;
     dsk_tools::diskImage * m_disk_image;
     dsk_tools::fileSystem * m_filesystem;
-    dsk_tools::UniversalFile m_f;
+    FileHandle m_f;
     std::unique_ptr<dsk_tools::Viewer> m_viewer;
     bool recreate_viewer = true;
     QSettings *m_settings;
@@ -74,13 +84,48 @@ private:
     void print_data();
     void update_subtypes(const QString &preferred = "");
     void update_image();
+    QImage m_scaled;        // Output of the scaler, reused between frames
+    void scale_image(const QImage & image, QImage & out) const;
+
+    // Animated pictures: the whole cycle is rendered once per viewer and selector combination
+    FrameRing m_frame_ring;
+    std::vector<QPixmap> m_ring_pixmaps;
+    int m_ring_pos = 0;
+    QString m_ring_key;
+    QString frame_ring_key(const dsk_tools::ViewerSelectorValues & selectors) const;
+    void start_frame_ring(const dsk_tools::ViewerSelectorValues & selectors);
+    void clear_frame_ring();
+    void scale_ring_frames();
+    void show_ring_frame();
     void fill_options();
 
     void store_scale(int value);
     void restore_scale();
 
-    QString m_saved_css;
-    QString m_saved_html;
+    QString listing_html() const;
+
+    // Text output, decoded part by part: (offset, size) in m_data and the viewer's HTML
+    QTimer m_text_timer;
+    std::string m_text_key;
+    std::string m_text_encoding;
+    QString m_text_cache_key;
+    bool m_text_cached {false};             // m_text_html is complete, parts are only laid out
+    std::vector<std::pair<size_t, size_t>> m_text_chunks;
+    std::vector<std::string> m_text_html;
+    std::deque<int> m_text_queue;
+    void decode_text_chunk(int index);
+    void finish_text();
+    void text_finished();
+    void clear_text();
+
+    // Complete outputs by "type|subtype|encoding", for switching back to them
+    struct TextLayout {
+        std::vector<std::string> html;
+        std::vector<TextListing> blocks;
+    };
+    std::map<std::string, TextLayout> m_text_layouts;
+    std::deque<std::string> m_text_layout_order;
+    void store_text_layout();
 
     // Dynamic selector widgets for picture viewers
     struct SelectorWidgetGroup {